@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Measure the cross-process round-trip latency of the Doorbell.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * Two processes play ping-pong via two doorbells in shared memory, like
+ * frontend (rings "desired action", waits for "observation") and backend
+ * (waits for "desired action", rings "observation") of a MultiProcessRobotData
+ * setup.  For comparison, the same is done with a waiter that polls the
+ * sequence counter with short sleeps instead of waiting on the futex.
+ *
+ * Usage:
+ *
+ *     doorbell_latency_benchmark [num_round_trips] [poll_interval_us]
+ *
+ * Defaults are 10000 round trips and 50 us poll interval.
+ */
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <robot_interfaces/doorbell.hpp>
+
+using namespace robot_interfaces;
+
+//! Wait until the sequence of the doorbell differs from the given one.
+void wait_for_ring(Doorbell &doorbell,
+                   uint32_t sequence,
+                   bool poll,
+                   long poll_interval_us)
+{
+    while (doorbell.get_sequence() == sequence)
+    {
+        if (poll)
+        {
+            std::this_thread::sleep_for(
+                std::chrono::microseconds(poll_interval_us));
+        }
+        else
+        {
+            doorbell.wait(sequence);
+        }
+    }
+}
+
+//! Run the ping-pong and return the round-trip latencies in microseconds.
+std::vector<double> run(const std::string &id_prefix,
+                        long num_round_trips,
+                        bool poll,
+                        long poll_interval_us)
+{
+    auto ping = Doorbell::create_leader(id_prefix + "_ping");
+    auto pong = Doorbell::create_leader(id_prefix + "_pong");
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        // "backend" process: answer each ping with a pong
+        auto child_ping = Doorbell::create_follower(id_prefix + "_ping");
+        auto child_pong = Doorbell::create_follower(id_prefix + "_pong");
+        uint32_t sequence = 0;
+        for (long i = 0; i < num_round_trips; i++)
+        {
+            wait_for_ring(*child_ping, sequence, poll, poll_interval_us);
+            sequence++;
+            child_pong->ring();
+        }
+        _exit(0);
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(num_round_trips);
+    for (long i = 0; i < num_round_trips; i++)
+    {
+        const uint32_t sequence = pong->get_sequence();
+        auto start = std::chrono::steady_clock::now();
+        ping->ring();
+        wait_for_ring(*pong, sequence, poll, poll_interval_us);
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(
+            std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    waitpid(pid, nullptr, 0);
+    return latencies;
+}
+
+void print_result(const char *name, std::vector<double> latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (double latency : latencies)
+    {
+        sum += latency;
+    }
+    const size_t n = latencies.size();
+    std::printf("%-18s %10.2f %10.2f %10.2f %10.2f\n",
+                name,
+                sum / n,
+                latencies[n / 2],
+                latencies[std::min(n - 1, n * 99 / 100)],
+                latencies[n - 1]);
+}
+
+int main(int argc, char *argv[])
+{
+    const long num_round_trips = argc > 1 ? std::stol(argv[1]) : 10000;
+    const long poll_interval_us = argc > 2 ? std::stol(argv[2]) : 50;
+    const std::string id_prefix =
+        "doorbell_benchmark_" + std::to_string(getpid());
+
+    std::printf("%-18s %10s %10s %10s %10s\n",
+                "round trip [us]",
+                "mean",
+                "median",
+                "p99",
+                "max");
+    print_result("futex doorbell",
+                 run(id_prefix, num_round_trips, false, poll_interval_us));
+    print_result("sleep polling",
+                 run(id_prefix, num_round_trips, true, poll_interval_us));
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @brief Compare the step rate of threaded and lockstep backends for many
+ *        simulated robots.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * A number of trivially simulated TriFinger robots is stepped round-robin
+ * from a single thread, once with normal (non-real-time) backends, each
+ * running its own thread, and once with backends in lockstep mode.  As the
+ * simulation itself is very cheap, the result mostly shows the cost of the
+ * thread handoff.
+ *
+ * Usage:
+ *
+ *     lockstep_benchmark [num_robots] [num_steps]
+ *
+ * Defaults are 16 robots and 2000 steps per robot.
+ */
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <robot_interfaces/finger_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef TriFingerTypes Types;
+
+//! Simple "simulation": integrate the torque of the action.
+class SimulationDriver : public RobotDriver<Types::Action, Types::Observation>
+{
+public:
+    void initialize() override
+    {
+    }
+
+    Types::Action apply_action(const Types::Action &desired_action) override
+    {
+        observation_.velocity += 0.001 * desired_action.torque;
+        observation_.position += 0.001 * observation_.velocity;
+        observation_.torque = desired_action.torque;
+        return desired_action;
+    }
+
+    Types::Observation get_latest_observation() override
+    {
+        return observation_;
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+
+private:
+    Types::Observation observation_;
+};
+
+//! Step all robots round-robin and return the duration in seconds.
+template <typename Frontend>
+double run(std::vector<Frontend> &frontends, long num_steps)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    const Types::Action action =
+        Types::Action::Torque(Types::Action::Vector::Constant(0.1));
+    for (long i = 0; i < num_steps; i++)
+    {
+        for (auto &frontend : frontends)
+        {
+            auto t = frontend.append_desired_action(action);
+            frontend.get_observation(t + 1);
+        }
+    }
+
+    std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+    return duration.count();
+}
+
+void print_result(const char *name, double duration, long total_steps)
+{
+    std::printf("%-10s %.3f s  %.0f steps/s  %.2f us/step\n",
+                name,
+                duration,
+                total_steps / duration,
+                duration / total_steps * 1e6);
+}
+
+int main(int argc, char *argv[])
+{
+    const long num_robots = argc > 1 ? std::stol(argv[1]) : 16;
+    const long num_steps = argc > 2 ? std::stol(argv[2]) : 2000;
+    const long total_steps = num_robots * num_steps;
+
+    std::printf("%ld robots, %ld steps each\n", num_robots, num_steps);
+
+    {
+        std::vector<Types::BackendPtr> backends;
+        std::vector<Types::Frontend> frontends;
+        for (long i = 0; i < num_robots; i++)
+        {
+            auto data = std::make_shared<Types::SingleProcessData>();
+            constexpr bool real_time_mode = false;
+            backends.push_back(std::make_shared<Types::Backend>(
+                std::make_shared<SimulationDriver>(), data, real_time_mode));
+            backends.back()->initialize();
+            frontends.emplace_back(data);
+        }
+
+        print_result("threaded", run(frontends, num_steps), total_steps);
+    }
+
+    {
+        std::vector<Types::LockstepFrontend> frontends;
+        for (long i = 0; i < num_robots; i++)
+        {
+            auto data = std::make_shared<Types::SingleProcessData>();
+            auto backend = std::make_shared<Types::Backend>(
+                std::make_shared<SimulationDriver>(),
+                data,
+                Types::Backend::LockstepMode());
+            backend->initialize();
+            frontends.emplace_back(data, backend);
+        }
+
+        print_result("lockstep", run(frontends, num_steps), total_steps);
+    }
+
+    return 0;
+}
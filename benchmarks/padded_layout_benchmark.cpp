@@ -0,0 +1,198 @@
+/**
+ * @file
+ * @brief Compare the per-step controller math on the default and the padded
+ *        TriFinger types.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * For a batch of actions and observations, the torque command is computed
+ * like in a typical driver, in two parts:
+ *
+ *  - resolve:  Replace NaN entries of the action by default gains and a mask
+ *    for the position controller (coefficient-wise selects).
+ *  - control:  PD position controller, velocity damping and torque limit
+ *    (pure arithmetic on the full vectors).
+ *
+ * The same code is run on TriFingerTypes (vectors of 9 doubles) and
+ * TriFingerPaddedTypes (vectors of 12 doubles, aligned).
+ *
+ * Compile with the target architecture enabled (e.g. `-O3 -march=native`) to
+ * get AVX instructions.
+ *
+ * Usage:
+ *
+ *     padded_layout_benchmark [batch_size] [repetitions]
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <robot_interfaces/finger_types.hpp>
+
+using namespace robot_interfaces;
+
+/**
+ * @brief Action with NaN entries replaced (default gains, position mask).
+ *
+ * Computed once per action.  For the padded types, padding lanes stay zero.
+ */
+template <typename Vector>
+struct ResolvedGains
+{
+    Vector kp;
+    Vector kd;
+    //! 1 where the position controller is enabled, 0 otherwise.
+    Vector position_mask;
+    //! Target position with NaN replaced by zero.
+    Vector position;
+};
+
+template <typename Action>
+ResolvedGains<typename Action::Vector> resolve_action(
+    const Action &action,
+    const typename Action::Vector &default_kp,
+    const typename Action::Vector &default_kd)
+{
+    typedef typename Action::Vector Vector;
+
+    ResolvedGains<Vector> resolved;
+    resolved.kp = action.position_kp.array().isNaN().select(
+        default_kp, action.position_kp);
+    resolved.kd = action.position_kd.array().isNaN().select(
+        default_kd, action.position_kd);
+    resolved.position_mask = action.position.array().isNaN().select(
+        Vector::Zero(), Vector::Ones());
+    resolved.position =
+        action.position.array().isNaN().select(Vector::Zero(), action.position);
+    return resolved;
+}
+
+/**
+ * @brief Compute the torque command (PD controller, damping, torque limit).
+ *
+ * Works on the full (possibly padded) vectors.  For the padded types the
+ * padding lanes of all inputs are zero, so the result is zero there as well.
+ */
+template <typename Vector, typename Observation>
+Vector compute_torque(const Vector &torque,
+                      const ResolvedGains<Vector> &gains,
+                      const Observation &observation,
+                      const Vector &max_torque,
+                      double safety_kd)
+{
+    auto pd = gains.position_mask.array() *
+              (gains.kp.array() *
+                   (gains.position.array() - observation.position.array()) -
+               gains.kd.array() * observation.velocity.array());
+
+    Vector result =
+        torque.array() + pd - safety_kd * observation.velocity.array();
+
+    return result.array().min(max_torque.array()).max(-max_torque.array());
+}
+
+struct Result
+{
+    double resolve_ns;
+    double control_ns;
+    double checksum;
+};
+
+template <typename Types>
+Result run(size_t batch_size, long repetitions)
+{
+    typedef typename Types::Action Action;
+    typedef typename Types::Observation Observation;
+    typedef typename Action::Vector Vector;
+
+    // zero in the padding lanes
+    auto constant = [](double value) {
+        Vector v = Vector::Zero();
+        v.template head<9>().setConstant(value);
+        return v;
+    };
+    const Vector default_kp = constant(3.0);
+    const Vector default_kd = constant(0.1);
+    const Vector max_torque = constant(0.36);
+
+    std::vector<Action> actions(batch_size);
+    std::vector<Observation> observations(batch_size);
+    std::vector<ResolvedGains<Vector>> gains(batch_size);
+    std::vector<Vector> torques(batch_size);
+    for (size_t i = 0; i < batch_size; i++)
+    {
+        for (int j = 0; j < 9; j++)
+        {
+            actions[i].torque[j] = 0.01 * j;
+            actions[i].position[j] = (i + j) % 4 == 0 ? NAN : std::sin(i + j);
+            observations[i].position[j] = std::cos(i * j);
+            observations[i].velocity[j] = 0.1 * std::sin(i - j);
+        }
+    }
+
+    typedef std::chrono::duration<double> Seconds;
+    Seconds resolve_duration(0), control_duration(0);
+    for (long r = 0; r < repetitions; r++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < batch_size; i++)
+        {
+            gains[i] = resolve_action(actions[i], default_kp, default_kd);
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < batch_size; i++)
+        {
+            torques[i] = compute_torque(actions[i].torque,
+                                        gains[i],
+                                        observations[i],
+                                        max_torque,
+                                        0.08);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        resolve_duration += middle - start;
+        control_duration += end - middle;
+    }
+
+    Result result;
+    const double num_steps = batch_size * repetitions;
+    result.resolve_ns = resolve_duration.count() / num_steps * 1e9;
+    result.control_ns = control_duration.count() / num_steps * 1e9;
+    result.checksum = 0;
+    for (const Vector &torque : torques)
+    {
+        result.checksum += torque.sum();
+    }
+    return result;
+}
+
+void print_result(const char *name, const Result &result)
+{
+    std::printf("%-22s %8.2f %8.2f %8.2f   %.6f\n",
+                name,
+                result.resolve_ns,
+                result.control_ns,
+                result.resolve_ns + result.control_ns,
+                result.checksum);
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t batch_size = argc > 1 ? std::stoul(argv[1]) : 1000;
+    const long repetitions = argc > 2 ? std::stol(argv[2]) : 5000;
+
+    std::printf("%-22s %8s %8s %8s   %s\n",
+                "ns/step",
+                "resolve",
+                "control",
+                "total",
+                "checksum");
+    print_result("TriFingerTypes",
+                 run<TriFingerTypes>(batch_size, repetitions));
+    print_result("TriFingerPaddedTypes",
+                 run<TriFingerPaddedTypes>(batch_size, repetitions));
+
+    return 0;
+}
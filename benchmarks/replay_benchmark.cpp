@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @brief Measure the throughput of frontend, backend and logger on replayed
+ *        TriFinger data.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * Observations are replayed by a LogReplayDriver as fast as possible with the
+ * backend in non-real-time mode, so the result does not depend on hardware
+ * timing.  A simple controller in the frontend sends a position action for
+ * each observation, while the logger writes everything to a binary log file.
+ *
+ * Usage:
+ *
+ *     replay_benchmark [log_file | num_steps] [output_directory]
+ *
+ * If no log file is given, a synthetic log with num_steps steps (default
+ * 20000) is used.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <robot_interfaces/finger_types.hpp>
+#include <robot_interfaces/log_replay_driver.hpp>
+
+using namespace robot_interfaces;
+
+typedef TriFingerTypes Types;
+typedef LogReplayDriver<Types::Action, Types::Observation> Driver;
+
+std::vector<Types::LogEntry> create_synthetic_log(long num_steps)
+{
+    std::vector<Types::LogEntry> log(num_steps);
+    for (long t = 0; t < num_steps; t++)
+    {
+        log[t].timeindex = t;
+        log[t].timestamp = 0.001 * t;
+        for (int j = 0; j < log[t].observation.position.size(); j++)
+        {
+            log[t].observation.position[j] = std::sin(0.001 * t + j);
+            log[t].observation.velocity[j] = std::cos(0.001 * t + j);
+        }
+    }
+    return log;
+}
+
+int main(int argc, char *argv[])
+{
+    std::shared_ptr<Driver> driver;
+    const std::string argument = argc > 1 ? argv[1] : "20000";
+    if (argument.find_first_not_of("0123456789") == std::string::npos)
+    {
+        driver = std::make_shared<Driver>(
+            create_synthetic_log(std::stol(argument)),
+            ReplayMode::AS_FAST_AS_POSSIBLE);
+    }
+    else
+    {
+        driver = std::make_shared<Driver>(argument,
+                                          ReplayMode::AS_FAST_AS_POSSIBLE);
+    }
+    const std::string directory = argc > 2 ? argv[2] : "/tmp";
+    const std::string log_file = directory + "/replay_benchmark.log";
+
+    const long num_steps = driver->size();
+    std::cout << "Replay " << num_steps << " steps." << std::endl;
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    Types::Logger logger(data, 100);
+    logger.start(log_file, Types::Logger::Format::BINARY);
+
+    // stop at the end of the log
+    constexpr bool real_time_mode = false;
+    Types::Backend backend(driver,
+                           data,
+                           real_time_mode,
+                           std::numeric_limits<double>::infinity(),
+                           num_steps);
+    backend.initialize();
+    Types::Frontend frontend(data);
+
+    auto start = std::chrono::steady_clock::now();
+
+    Types::Observation observation;
+    for (long i = 0; i < num_steps; i++)
+    {
+        auto t = frontend.append_desired_action(
+            Types::Action::Position(observation.position));
+        observation = frontend.get_observation(t);
+    }
+
+    std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+
+    backend.wait_until_terminated();
+    logger.stop();
+
+    std::printf("%.3f s  %.0f steps/s  %.2f us/step\n",
+                duration.count(),
+                num_steps / duration.count(),
+                duration.count() / num_steps * 1e6);
+
+    std::remove(log_file.c_str());
+    std::remove(record_log::get_index_path(log_file).c_str());
+
+    return 0;
+}
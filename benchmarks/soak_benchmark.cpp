@@ -0,0 +1,283 @@
+/**
+ * @file
+ * @brief Long-running soak test of the backend under injected faults.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * Runs a real-time backend with a driver that applies actions at a fixed rate,
+ * wrapped in a FaultInjectingRobotDriver, and a frontend that provides the
+ * actions as fast as it can.  Whenever the backend terminates (e.g. because an
+ * action was not provided in time), the termination reason is recorded and a
+ * new backend is started, until the total duration is over.  At the end, the
+ * histogram of the step periods (from the observation timestamps) and the
+ * counts of the termination reasons are printed.
+ *
+ * This shows how far control rate and allowed action repetitions can be
+ * pushed on a given machine, with or without additional jitter and load.
+ *
+ * Usage:
+ *
+ *     soak_benchmark [duration_s] [rate_hz] [max_action_repetitions]
+ *                    [latency_stddev_us] [stall_probability]
+ *                    [stall_duration_ms] [error_probability]
+ *                    [num_load_threads]
+ *
+ * Defaults are 10 s, 1000 Hz, 0 repetitions and no injected faults.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <robot_interfaces/example.hpp>
+#include <robot_interfaces/fault_injecting_robot_driver.hpp>
+#include <robot_interfaces/robot_backend.hpp>
+#include <robot_interfaces/robot_data.hpp>
+#include <robot_interfaces/robot_frontend.hpp>
+
+using namespace robot_interfaces;
+
+typedef example::Action Action;
+typedef example::Observation Observation;
+typedef RobotBackend<Action, Observation> Backend;
+
+//! Driver which applies one action per period.
+class PeriodicDriver : public RobotDriver<Action, Observation>
+{
+public:
+    explicit PeriodicDriver(double rate_hz)
+        : period_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::duration<double>(1.0 / rate_hz)))
+    {
+    }
+
+    void initialize() override
+    {
+        next_step_ = std::chrono::steady_clock::now() + period_;
+        observation_.values[0] = 0;
+        observation_.values[1] = 0;
+    }
+
+    Action apply_action(const Action &desired_action) override
+    {
+        std::this_thread::sleep_until(next_step_);
+        next_step_ += period_;
+        observation_.values[0] = desired_action.values[0];
+        observation_.values[1] = desired_action.values[1];
+        return desired_action;
+    }
+
+    Observation get_latest_observation() override
+    {
+        return observation_;
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+
+private:
+    std::chrono::nanoseconds period_;
+    std::chrono::steady_clock::time_point next_step_;
+    Observation observation_;
+};
+
+//! Histogram with power-of-two buckets in microseconds.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() : counts_(NUM_BUCKETS, 0)
+    {
+    }
+
+    void add(double latency_us)
+    {
+        size_t bucket = 0;
+        while (bucket + 1 < NUM_BUCKETS && latency_us >= (2u << bucket))
+        {
+            bucket++;
+        }
+        counts_[bucket]++;
+    }
+
+    void print() const
+    {
+        unsigned long total = 0;
+        for (unsigned long count : counts_)
+        {
+            total += count;
+        }
+        for (size_t i = 0; i < NUM_BUCKETS; i++)
+        {
+            if (counts_[i] > 0)
+            {
+                std::printf("  < %8u us: %12lu (%8.4f %%)\n",
+                            2u << i,
+                            counts_[i],
+                            100.0 * counts_[i] / total);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t NUM_BUCKETS = 24;
+    std::vector<unsigned long> counts_;
+};
+
+const char *get_reason_name(int reason)
+{
+    switch (reason)
+    {
+        case Backend::NOT_TERMINATED:
+            return "not terminated";
+        case Backend::SHUTDOWN_REQUESTED:
+            return "end of run";
+        case Backend::MAXIMUM_NUMBER_OF_ACTIONS_REACHED:
+            return "maximum number of actions";
+        case Backend::DRIVER_ERROR:
+            return "driver error";
+        case Backend::FIRST_ACTION_TIMEOUT:
+            return "first action timeout";
+        case Backend::NEXT_ACTION_TIMEOUT:
+            return "next action timeout";
+        default:
+            return "unknown";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const double duration_s = argc > 1 ? std::stod(argv[1]) : 10;
+    const double rate_hz = argc > 2 ? std::stod(argv[2]) : 1000;
+    const uint32_t max_action_repetitions =
+        argc > 3 ? std::stoul(argv[3]) : 0;
+
+    FaultInjectionConfig config;
+    const double latency_stddev_us = argc > 4 ? std::stod(argv[4]) : 0;
+    if (latency_stddev_us > 0)
+    {
+        config.apply_action_latency =
+            LatencyDistribution::normal(0, latency_stddev_us * 1e-6);
+    }
+    config.stall_probability = argc > 5 ? std::stod(argv[5]) : 0;
+    config.stall_duration_s = (argc > 6 ? std::stod(argv[6]) : 0) * 1e-3;
+    config.error_probability = argc > 7 ? std::stod(argv[7]) : 0;
+    config.num_load_threads = argc > 8 ? std::stoul(argv[8]) : 0;
+
+    LatencyHistogram period_histogram;
+    std::map<int, unsigned long> termination_reasons;
+    unsigned long num_steps = 0;
+    unsigned long num_repeated_steps = 0;
+
+    const auto end =
+        std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(duration_s));
+
+    for (int run = 0; std::chrono::steady_clock::now() < end; run++)
+    {
+        config.seed = run;
+        auto driver =
+            std::make_shared<FaultInjectingRobotDriver<PeriodicDriver>>(
+                std::make_shared<PeriodicDriver>(rate_hz), config);
+        auto data =
+            std::make_shared<SingleProcessRobotData<Action, Observation>>();
+        Backend backend(driver, data, true);
+        backend.set_max_action_repetitions(max_action_repetitions);
+        backend.initialize();
+        RobotFrontend<Action, Observation> frontend(data);
+        auto doorbell = frontend.get_observation_doorbell();
+
+        // add period and repetitions of the steps up to t to the statistics
+        TimeIndex num_evaluated = 0;
+        auto evaluate = [&](TimeIndex t) {
+            for (; num_evaluated <= t; num_evaluated++)
+            {
+                if (num_evaluated > 0)
+                {
+                    period_histogram.add(
+                        (frontend.get_timestamp_ms(num_evaluated) -
+                         frontend.get_timestamp_ms(num_evaluated - 1)) *
+                        1e3);
+                }
+                if ((*data->status)[num_evaluated].action_repetitions > 0)
+                {
+                    num_repeated_steps++;
+                }
+            }
+        };
+
+        Action action;
+        action.values[0] = 0;
+        action.values[1] = 0;
+        try
+        {
+            // Like a controller, provide the next action while the current
+            // one is applied, i.e. as soon as the observation of the time
+            // step of the current action exists.
+            TimeIndex t = frontend.append_desired_action(action);
+            while (std::chrono::steady_clock::now() < end)
+            {
+                // wait without blocking forever if the backend terminated
+                uint32_t sequence = doorbell->get_sequence();
+                while (!frontend.has_observation(t) && backend.is_running())
+                {
+                    doorbell->wait(sequence, 0.1);
+                    sequence = doorbell->get_sequence();
+                }
+                if (!backend.is_running())
+                {
+                    break;
+                }
+
+                // the status of step t is only complete after the step
+                evaluate(t - 1);
+
+                action.values[0] = t;
+                t = frontend.append_desired_action(action);
+            }
+        }
+        catch (const std::runtime_error &)
+        {
+            // backend reported an error, handled below
+        }
+
+        backend.request_shutdown();
+        int reason = backend.wait_until_terminated();
+        termination_reasons[reason]++;
+
+        TimeIndex newest = data->status->newest_timeindex(false);
+        evaluate(newest);
+        num_steps += newest + 1;
+
+        std::printf("run %d: %ld steps, %s\n",
+                    run,
+                    static_cast<long>(newest + 1),
+                    get_reason_name(reason));
+    }
+
+    std::printf("\nstep period histogram:\n");
+    period_histogram.print();
+    std::printf("\nsteps: %lu, with repeated action: %lu\n",
+                num_steps,
+                num_repeated_steps);
+    std::printf("termination reasons:\n");
+    for (const auto &entry : termination_reasons)
+    {
+        std::printf("  %-28s %lu\n",
+                    get_reason_name(entry.first),
+                    entry.second);
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @brief Benchmark writing text log files of the TriFinger robot.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * Compares RobotLogger::write_current_buffer() with the formatting path that
+ * was used before (`std::ostream_iterator` with precision 27, `std::endl` per
+ * line and reopening the file for each block).
+ *
+ * Usage:
+ *
+ *     text_log_benchmark [num_steps] [output_directory]
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include <robot_interfaces/finger_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef TriFingerTypes Types;
+
+//! Fill the robot data with num_steps steps of changing values.
+void fill_robot_data(Types::BaseData &data, long num_steps)
+{
+    for (long t = 0; t < num_steps; t++)
+    {
+        Types::Action action = Types::Action::Position(
+            Types::Action::Vector::Constant(std::sin(0.001 * t)));
+        Types::Observation observation;
+        for (int j = 0; j < observation.position.size(); j++)
+        {
+            observation.position[j] = std::sin(0.001 * t + j);
+            observation.velocity[j] = std::cos(0.001 * t + j);
+            observation.torque[j] = 0.1 * std::sin(0.01 * t + j);
+        }
+        observation.tip_force << 0.1, 0.2, 0.3;
+
+        data.desired_action->append(action);
+        data.applied_action->append(action);
+        data.observation->append(observation);
+        data.status->append(Status());
+    }
+}
+
+//! The text log writing as it was implemented before TextLogWriter.
+void write_legacy_text_log(Types::BaseData &data,
+                           const std::string &filename,
+                           long block_size)
+{
+    std::ofstream file(filename);
+    file << "header" << std::endl;
+    file.close();
+
+    const long end_index = data.observation->newest_timeindex();
+    for (long start = 0; start < end_index; start += block_size)
+    {
+        file.open(filename, std::ios_base::app);
+        file.precision(27);
+        std::ostream_iterator<double> double_iterator(file, " ");
+
+        for (long t = start; t < std::min(start + block_size, end_index); t++)
+        {
+            Types::Action applied_action = (*data.applied_action)[t];
+            Types::Action desired_action = (*data.desired_action)[t];
+            Types::Observation observation = (*data.observation)[t];
+            Status status = (*data.status)[t];
+            auto timestamp = data.observation->timestamp_s(t);
+
+            file << t << " " << timestamp << " ";
+            for (Loggable *loggable : std::initializer_list<Loggable *>{
+                     &status, &observation, &applied_action, &desired_action})
+            {
+                for (auto field : loggable->get_data())
+                {
+                    std::copy(field.begin(), field.end(), double_iterator);
+                }
+            }
+            file << std::endl;
+        }
+
+        file.close();
+    }
+}
+
+template <typename Func>
+double measure_seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+    return duration.count();
+}
+
+void print_result(const std::string &name,
+                  double seconds,
+                  long num_steps,
+                  const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    const double size_mb = file.tellg() / 1e6;
+
+    std::printf("%-28s %8.3f s  %10.0f steps/s  %8.2f us/step  %7.1f MB\n",
+                name.c_str(),
+                seconds,
+                num_steps / seconds,
+                seconds / num_steps * 1e6,
+                size_mb);
+}
+
+int main(int argc, char *argv[])
+{
+    const long num_steps = argc > 1 ? std::stol(argv[1]) : 20000;
+    const std::string directory = argc > 2 ? argv[2] : "/tmp";
+    constexpr long BLOCK_SIZE = 100;
+
+    auto data = std::make_shared<Types::SingleProcessData>(num_steps + 1);
+    fill_robot_data(*data, num_steps + 1);
+
+    std::cout << "Write " << num_steps << " steps of TriFinger data.\n"
+              << std::endl;
+
+    const std::string legacy_file = directory + "/text_log_legacy.txt";
+    double legacy_seconds = measure_seconds(
+        [&] { write_legacy_text_log(*data, legacy_file, BLOCK_SIZE); });
+    print_result("ostream (previous)", legacy_seconds, num_steps, legacy_file);
+
+    const std::string new_file = directory + "/text_log.txt";
+    Types::Logger logger(data, BLOCK_SIZE);
+    double new_seconds =
+        measure_seconds([&] { logger.write_current_buffer(new_file); });
+    print_result("TextLogWriter", new_seconds, num_steps, new_file);
+
+    std::cout << "\nSpeed-up: " << legacy_seconds / new_seconds << std::endl;
+
+    std::remove(legacy_file.c_str());
+    std::remove(new_file.c_str());
+
+    return 0;
+}
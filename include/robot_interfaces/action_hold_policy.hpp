@@ -0,0 +1,179 @@
+/**
+ * @file
+ * @brief Policies for filling in actions that are not provided in time.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Policy used by the RobotBackend if the next action is late.
+ *
+ * In real-time mode, the backend fills in the desired action of a time step
+ * for which the user did not provide an action in time (up to the configured
+ * number of action repetitions).  The policy determines which action is used
+ * for this, based on the last two actions that were provided by the user.
+ *
+ * The filled-in actions are appended to the desired action time series, so
+ * they are visible to the user.  They are not considered as input for
+ * following calls of the policy, i.e. `last_action` always refers to an
+ * action provided by the user.
+ *
+ * @tparam Action
+ */
+template <typename Action>
+class ActionHoldPolicy
+{
+public:
+    virtual ~ActionHoldPolicy()
+    {
+    }
+
+    /**
+     * @brief Get the action for a time step for which no action is provided.
+     *
+     * @param last_action  The last action that was provided by the user.
+     * @param previous_action  The action provided by the user before
+     *     last_action.  Same as last_action if there is none (or it is not in
+     *     the history anymore).
+     * @param previous_interval  Number of time steps between previous_action
+     *     and last_action (0 if there is no previous action).
+     * @param steps_since_last  Number of time steps since last_action (1 for
+     *     the step directly following it).
+     * @return The action that is applied in this time step.
+     */
+    virtual Action get_hold_action(const Action &last_action,
+                                   const Action &previous_action,
+                                   uint32_t previous_interval,
+                                   uint32_t steps_since_last) = 0;
+};
+
+/**
+ * @brief Repeat the last action (default behaviour of the backend).
+ */
+template <typename Action>
+class RepeatActionHoldPolicy : public ActionHoldPolicy<Action>
+{
+public:
+    Action get_hold_action(const Action &last_action,
+                           const Action &previous_action,
+                           uint32_t previous_interval,
+                           uint32_t steps_since_last) override
+    {
+        return last_action;
+    }
+};
+
+/**
+ * @brief Linearly extrapolate torque and position of the last action.
+ *
+ * The torque and position are continued with the per-step slope between the
+ * last two user actions.  This way, the user can provide waypoints at a lower
+ * rate than the control loop (e.g. 50 Hz policy with 1 kHz control) and the
+ * backend fills in the steps in between without step discontinuities.
+ *
+ * Gains are taken from the last action.  A disabled position controller (NaN
+ * position) stays disabled.
+ *
+ * @tparam Action  Action type with vectors `torque` and `position` (e.g.
+ *     NJointAction).
+ */
+template <typename Action>
+class LinearExtrapolationHoldPolicy : public ActionHoldPolicy<Action>
+{
+public:
+    /**
+     * @param max_extrapolation_steps  Extrapolate at most this many steps,
+     *     after this the last extrapolated action is held.
+     */
+    LinearExtrapolationHoldPolicy(uint32_t max_extrapolation_steps =
+                                      std::numeric_limits<uint32_t>::max())
+        : max_extrapolation_steps_(max_extrapolation_steps)
+    {
+    }
+
+    Action get_hold_action(const Action &last_action,
+                           const Action &previous_action,
+                           uint32_t previous_interval,
+                           uint32_t steps_since_last) override
+    {
+        if (previous_interval == 0)
+        {
+            return last_action;
+        }
+
+        typedef typename Action::Vector Vector;
+        typedef typename Vector::Scalar Scalar;
+
+        const Scalar factor =
+            static_cast<Scalar>(
+                std::min(steps_since_last, max_extrapolation_steps_)) /
+            previous_interval;
+
+        // no extrapolation of the position if the position controller was
+        // disabled in one of the actions
+        Vector position_delta =
+            last_action.position - previous_action.position;
+        position_delta = position_delta.array().isNaN().select(
+            Vector::Zero(), position_delta);
+
+        Action action = last_action;
+        action.torque += factor * (last_action.torque - previous_action.torque);
+        action.position += factor * position_delta;
+        return action;
+    }
+
+private:
+    const uint32_t max_extrapolation_steps_;
+};
+
+/**
+ * @brief Hold the last action with exponentially decaying torque.
+ *
+ * In each filled-in step, the torque of the last action is multiplied with
+ * the decay factor, so the robot smoothly goes to zero torque (or only the
+ * position controller of the last action) if no new action arrives.
+ *
+ * @tparam Action  Action type with a vector `torque` (e.g. NJointAction).
+ */
+template <typename Action>
+class DecayingHoldPolicy : public ActionHoldPolicy<Action>
+{
+public:
+    /**
+     * @param decay_factor  Factor in (0, 1] by which the torque is reduced
+     *     per step.
+     * @throws std::invalid_argument if decay_factor is not in (0, 1].
+     */
+    DecayingHoldPolicy(double decay_factor) : decay_factor_(decay_factor)
+    {
+        if (!(decay_factor > 0 && decay_factor <= 1))
+        {
+            throw std::invalid_argument("decay_factor must be in (0, 1].");
+        }
+    }
+
+    Action get_hold_action(const Action &last_action,
+                           const Action &previous_action,
+                           uint32_t previous_interval,
+                           uint32_t steps_since_last) override
+    {
+        Action action = last_action;
+        action.torque *= static_cast<typename Action::Vector::Scalar>(
+            std::pow(decay_factor_, steps_since_last));
+        return action;
+    }
+
+private:
+    const double decay_factor_;
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,201 @@
+/**
+ * @file
+ * @brief Safety stage that validates and clamps actions in the backend.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include <Eigen/Eigen>
+
+#include <robot_interfaces/status.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Stage between desired and applied action in the RobotBackend.
+ *
+ * An action limiter is called by the backend with each desired action before
+ * it is passed to the driver and may modify it (e.g. clamp it to safe
+ * values).  This way the safety checks are done once in the backend instead
+ * of being reimplemented in each driver.
+ *
+ * @tparam Action
+ * @tparam Observation
+ */
+template <typename Action, typename Observation>
+class ActionLimiter
+{
+public:
+    virtual ~ActionLimiter()
+    {
+    }
+
+    /**
+     * @brief Validate the action and modify it in place if needed.
+     *
+     * @param action  The desired action.  Is replaced by the limited action.
+     * @param observation  The latest observation of the robot.
+     * @return Bit mask of Status::ActionLimit flags that were active.
+     */
+    virtual uint32_t limit(Action &action, const Observation &observation) = 0;
+};
+
+/**
+ * @brief Action limiter for NJointAction-like actions.
+ *
+ * Works with all action types that provide the vectors torque, position,
+ * position_kp and position_kd (NJointAction, PaddedNJointAction) and
+ * observations with a velocity vector of the same type.  All checks are
+ * computed on the full vectors with Eigen array expressions, so no per-joint
+ * branching is needed (for the padded types all padding lanes stay zero).
+ *
+ * The following steps are applied, in this order:
+ *
+ *  1. NaN entries of position_kp/position_kd are replaced by the default gains
+ *     (only for joints where the default is not NaN).
+ *  2. Desired positions are clamped to [position_min, position_max] (NaN
+ *     positions, i.e. disabled position controller, are kept).
+ *  3. Velocity damping `-safety_kd * velocity` is added to the torque.
+ *  4. Non-finite torques (NaN or infinity, e.g. from a NaN desired torque or
+ *     velocity) are replaced by zero.  Comparisons with NaN are false, so
+ *     they would otherwise pass the torque limit.
+ *  5. The torque is clamped to [-max_torque, max_torque].
+ *
+ * @tparam Action
+ * @tparam Observation
+ */
+template <typename Action, typename Observation>
+class NJointActionLimiter : public ActionLimiter<Action, Observation>
+{
+public:
+    typedef typename Action::Vector Vector;
+    typedef typename Vector::Scalar Scalar;
+
+    //! @brief Limits used by the NJointActionLimiter.
+    struct Limits
+    {
+        //! @brief Maximum absolute torque per joint (default: no limit).
+        Vector max_torque = Vector::Constant(infinity());
+        //! @brief Lower position limit per joint (default: no limit).
+        Vector position_min = Vector::Constant(-infinity());
+        //! @brief Upper position limit per joint (default: no limit).
+        Vector position_max = Vector::Constant(infinity());
+        //! @brief Gain of the velocity damping (default: no damping).
+        Vector safety_kd = Vector::Zero();
+        //! @brief Replaces NaN in position_kp.  NaN to keep it.
+        Vector default_kp = Vector::Constant(nan());
+        //! @brief Replaces NaN in position_kd.  NaN to keep it.
+        Vector default_kd = Vector::Constant(nan());
+    };
+
+    /**
+     * @param limits  The limits.  They are fixed for the lifetime of the
+     *     limiter.
+     * @throws std::invalid_argument if the limits are not valid.
+     */
+    NJointActionLimiter(const Limits &limits) : limits_(limits)
+    {
+        if ((limits.max_torque.array() < 0).any() ||
+            limits.max_torque.hasNaN())
+        {
+            throw std::invalid_argument(
+                "max_torque must not be negative or NaN.");
+        }
+        if ((limits.position_min.array() > limits.position_max.array())
+                .any() ||
+            limits.position_min.hasNaN() || limits.position_max.hasNaN())
+        {
+            throw std::invalid_argument(
+                "position_min must not be greater than position_max.");
+        }
+        if ((limits.safety_kd.array() < 0).any() || limits.safety_kd.hasNaN())
+        {
+            throw std::invalid_argument(
+                "safety_kd must not be negative or NaN.");
+        }
+    }
+
+    const Limits &get_limits() const
+    {
+        return limits_;
+    }
+
+    uint32_t limit(Action &action, const Observation &observation) override
+    {
+        uint32_t active_limits = 0;
+
+        // default gains
+        auto kp_nan = action.position_kp.array().isNaN() &&
+                      !limits_.default_kp.array().isNaN();
+        auto kd_nan = action.position_kd.array().isNaN() &&
+                      !limits_.default_kd.array().isNaN();
+        if (kp_nan.any() || kd_nan.any())
+        {
+            action.position_kp =
+                kp_nan.select(limits_.default_kp, action.position_kp);
+            action.position_kd =
+                kd_nan.select(limits_.default_kd, action.position_kd);
+            active_limits |= Status::ActionLimit::DEFAULT_GAINS;
+        }
+
+        // position limits (comparisons with NaN are false, so disabled
+        // position control is not affected)
+        if ((action.position.array() < limits_.position_min.array()).any() ||
+            (action.position.array() > limits_.position_max.array()).any())
+        {
+            action.position =
+                (action.position.array() < limits_.position_min.array())
+                    .select(limits_.position_min, action.position);
+            action.position =
+                (action.position.array() > limits_.position_max.array())
+                    .select(limits_.position_max, action.position);
+            active_limits |= Status::ActionLimit::POSITION_LIMIT;
+        }
+
+        // velocity damping
+        Vector damping = limits_.safety_kd.cwiseProduct(observation.velocity);
+        if (!damping.isZero(0))
+        {
+            action.torque -= damping;
+            active_limits |= Status::ActionLimit::VELOCITY_DAMPING;
+        }
+
+        // non-finite torques
+        auto non_finite = !action.torque.array().isFinite();
+        if (non_finite.any())
+        {
+            action.torque = non_finite.select(Vector::Zero(), action.torque);
+            active_limits |= Status::ActionLimit::NON_FINITE_TORQUE;
+        }
+
+        // torque limit
+        if ((action.torque.array().abs() > limits_.max_torque.array()).any())
+        {
+            action.torque = action.torque.cwiseMin(limits_.max_torque)
+                                .cwiseMax(-limits_.max_torque);
+            active_limits |= Status::ActionLimit::TORQUE_LIMIT;
+        }
+
+        return active_limits;
+    }
+
+private:
+    const Limits limits_;
+
+    static constexpr Scalar infinity()
+    {
+        return std::numeric_limits<Scalar>::infinity();
+    }
+
+    static constexpr Scalar nan()
+    {
+        return std::numeric_limits<Scalar>::quiet_NaN();
+    }
+};
+
+}  // namespace robot_interfaces
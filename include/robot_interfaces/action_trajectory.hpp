@@ -0,0 +1,249 @@
+/**
+ * @file
+ * @brief Queue of time-indexed actions that are submitted in advance.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <time_series/interface.hpp>
+
+#include "shared_memory_segment.hpp"
+
+namespace robot_interfaces
+{
+/**
+ * @brief Element of the trajectory time series in RobotData.
+ *
+ * A trajectory segment is a sequence of actions for consecutive time steps.
+ * It is transmitted to the backend as one TrajectoryPoint per action, the
+ * first point of the segment being marked.
+ *
+ * @tparam Action
+ */
+template <typename Action>
+struct TrajectoryPoint
+{
+    //! @brief Time index at which the action is to be applied.
+    time_series::Index timeindex = 0;
+    //! @brief The action.
+    Action action;
+    //! @brief True for the first point of a segment.
+    bool is_segment_start = false;
+
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(timeindex, action, is_segment_start);
+    }
+};
+
+/**
+ * @brief Number of trajectory points the backend has read so far.
+ *
+ * Published by the backend after each update of the ActionTrajectoryQueue,
+ * so the frontend can avoid overwriting points in the trajectory time series
+ * that were not read yet.  This is flow control between frontend and backend
+ * only, so it is not part of the (logged) Status.
+ *
+ * Like StatusWord, the counter lives either in process memory or in shared
+ * memory (create_leader() / create_follower()).
+ */
+class TrajectoryProgress
+{
+public:
+    //! @brief Create a counter for use within one process.
+    TrajectoryProgress()
+    {
+    }
+
+    /**
+     * @brief Create a counter in shared memory.
+     *
+     * Existing shared memory with the same ID is reset.
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     */
+    static std::shared_ptr<TrajectoryProgress> create_leader(
+        const std::string &shared_memory_id)
+    {
+        return std::shared_ptr<TrajectoryProgress>(
+            new TrajectoryProgress(shared_memory_id, true));
+    }
+
+    /**
+     * @brief Open a counter in shared memory created by create_leader().
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     * @throws std::runtime_error if the shared memory does not exist.
+     */
+    static std::shared_ptr<TrajectoryProgress> create_follower(
+        const std::string &shared_memory_id)
+    {
+        return std::shared_ptr<TrajectoryProgress>(
+            new TrajectoryProgress(shared_memory_id, false));
+    }
+
+    //! @brief Set the number of received points (called by the backend).
+    void set_number_of_received_points(time_series::Index number)
+    {
+        state_->received_points.store(number, std::memory_order_release);
+    }
+
+    //! @brief Get the number of points the backend has read so far.
+    time_series::Index get_number_of_received_points() const
+    {
+        return state_->received_points.load(std::memory_order_acquire);
+    }
+
+private:
+    //! @brief Data shared between the processes.
+    struct State
+    {
+        std::atomic<int64_t> received_points{0};
+    };
+    static_assert(std::atomic<int64_t>::is_always_lock_free,
+                  "TrajectoryProgress requires lock-free 64 bit atomics.");
+
+    // zero-initialised shared memory is a valid State
+    SharedMemorySegment<State> state_;
+
+    TrajectoryProgress(const std::string &shared_memory_id, bool is_leader)
+        : state_(shared_memory_id, is_leader)
+    {
+    }
+};
+
+/**
+ * @brief Backend side of the trajectory queue.
+ *
+ * Reads the trajectory segments from the trajectory time series of RobotData
+ * and keeps the actions that are not yet due.  A newly received segment
+ * replaces all pending actions from its first time index on (preemption), so
+ * a motion can be changed at any time without affecting the steps before.
+ *
+ * The pending actions are dropped as soon as the first point of the new
+ * segment is read, so there is never a mix of old and new actions after the
+ * start of the new segment.  Long segments (which may not fit into the time
+ * series at once) are executed while they are still being received.
+ *
+ * @tparam Action
+ */
+template <typename Action>
+class ActionTrajectoryQueue
+{
+public:
+    typedef time_series::TimeSeriesInterface<TrajectoryPoint<Action>>
+        TrajectoryTimeSeries;
+
+    ActionTrajectoryQueue(std::shared_ptr<TrajectoryTimeSeries> trajectory)
+        : trajectory_(trajectory)
+    {
+    }
+
+    /**
+     * @brief Read all new points from the trajectory time series.
+     *
+     * @return False if points were lost because they were overwritten in the
+     *     time series before they could be read.
+     */
+    bool update()
+    {
+        if (trajectory_->length() == 0)
+        {
+            return true;
+        }
+
+        const time_series::Index newest = trajectory_->newest_timeindex(false);
+        if (next_point_ > newest)
+        {
+            return true;
+        }
+
+        bool no_loss = true;
+        const time_series::Index oldest = trajectory_->oldest_timeindex(false);
+        if (next_point_ < oldest)
+        {
+            no_loss = false;
+            next_point_ = oldest;
+        }
+
+        for (; next_point_ <= newest; next_point_++)
+        {
+            TrajectoryPoint<Action> point = (*trajectory_)[next_point_];
+            if (point.is_segment_start)
+            {
+                // preemption: drop pending actions from the start of the new
+                // segment on
+                while (!queue_.empty() &&
+                       queue_.back().first >= point.timeindex)
+                {
+                    queue_.pop_back();
+                }
+            }
+            // points of a segment have consecutive time indices, so the queue
+            // stays sorted
+            if (queue_.empty() || queue_.back().first < point.timeindex)
+            {
+                queue_.push_back(
+                    std::make_pair(point.timeindex, point.action));
+            }
+        }
+
+        return no_loss;
+    }
+
+    /**
+     * @brief Take the action for time step t from the queue if there is one.
+     *
+     * Actions of time steps before t are discarded.
+     *
+     * @param t  Current time index.
+     * @param action  Is set to the action of step t if there is one.
+     * @return True if there is an action for time step t.
+     */
+    bool pop(time_series::Index t, Action &action)
+    {
+        while (!queue_.empty() && queue_.front().first < t)
+        {
+            queue_.pop_front();
+        }
+
+        if (!queue_.empty() && queue_.front().first == t)
+        {
+            action = queue_.front().second;
+            queue_.pop_front();
+            return true;
+        }
+
+        return false;
+    }
+
+    //! @brief Number of pending actions.
+    size_t depth() const
+    {
+        return queue_.size();
+    }
+
+    //! @brief Number of trajectory points that have been read so far.
+    time_series::Index get_number_of_received_points() const
+    {
+        return next_point_;
+    }
+
+private:
+    std::shared_ptr<TrajectoryTimeSeries> trajectory_;
+    //! @brief Pending actions, sorted by time index.
+    std::deque<std::pair<time_series::Index, Action>> queue_;
+    //! @brief Index of the next point in the trajectory time series.
+    time_series::Index next_point_ = 0;
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,196 @@
+/**
+ * @file
+ * @brief Actions of a batch of generic n-joint robots.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+#include <serialization_utils/cereal_eigen.hpp>
+
+#include <robot_interfaces/loggable.hpp>
+#include <robot_interfaces/n_joint_action.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Actions of a batch of K generic n-joint robots.
+ *
+ * Same fields as NJointAction but in structure-of-arrays layout:  Each field
+ * is a K×N matrix with one row per robot.  The matrices are column-major, so
+ * the values of one joint of all robots are contiguous in memory, which allows
+ * vectorized computations over the whole batch.
+ *
+ * @tparam N Number of joints per robot.
+ * @tparam Scalar_t Scalar type of the values.
+ */
+template <size_t N, typename Scalar_t = double>
+struct BatchNJointAction : public Loggable
+{
+    //! @brief Number of joints per robot.
+    static constexpr size_t num_joints = N;
+
+    typedef Scalar_t Scalar;
+    //! @brief K×N matrix with one row per robot.
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, N> Matrix;
+    //! @brief Action of a single robot of the batch.
+    typedef NJointAction<N, Scalar> RobotAction;
+
+    //! Desired torque commands (in addition to position controller).
+    Matrix torque;
+    //! Desired positions.  Set to NaN to disable position controller.
+    Matrix position;
+    //! P-gains for position controller.  If NaN, default is used.
+    Matrix position_kp;
+    //! D-gains for position controller.  If NaN, default is used.
+    Matrix position_kd;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(torque, position, position_kp, position_kd);
+    }
+
+    std::vector<std::string> get_name() override
+    {
+        return {"torque", "position", "position_kp", "position_kd"};
+    }
+
+    //! @brief Get the data, each field flattened robot by robot.
+    std::vector<std::vector<double>> get_data() override
+    {
+        return {flatten(torque),
+                flatten(position),
+                flatten(position_kp),
+                flatten(position_kd)};
+    }
+
+    /**
+     * @brief Create zero-torque actions for the given number of robots.
+     *
+     * @param num_robots  Number of robots in the batch.
+     */
+    BatchNJointAction(size_t num_robots = 0)
+        : torque(Matrix::Zero(num_robots, N)),
+          position(None(num_robots)),
+          position_kp(None(num_robots)),
+          position_kd(None(num_robots))
+    {
+    }
+
+    /**
+     * @brief Create actions with desired torque and position.
+     *
+     * See NJointAction::NJointAction for the meaning of the fields.  All
+     * matrices need to have the same number of rows.
+     *
+     * @throws std::invalid_argument if the sizes of the matrices differ.
+     */
+    BatchNJointAction(const Matrix& torque,
+                      const Matrix& position,
+                      const Matrix& position_kp,
+                      const Matrix& position_kd)
+        : torque(torque),
+          position(position),
+          position_kp(position_kp),
+          position_kd(position_kd)
+    {
+        if (position.rows() != torque.rows() ||
+            position_kp.rows() != torque.rows() ||
+            position_kd.rows() != torque.rows())
+        {
+            throw std::invalid_argument(
+                "All fields of a batch action need the same number of rows.");
+        }
+    }
+
+    /**
+     * @brief Create actions that only contain torque commands.
+     *
+     * @param torque  Desired torques, one row per robot.
+     */
+    static BatchNJointAction Torque(const Matrix& torque)
+    {
+        const size_t num_robots = torque.rows();
+        return BatchNJointAction(
+            torque, None(num_robots), None(num_robots), None(num_robots));
+    }
+
+    /**
+     * @brief Create actions that only contain position commands.
+     *
+     * @param position  Desired positions, one row per robot.
+     */
+    static BatchNJointAction Position(const Matrix& position)
+    {
+        const size_t num_robots = position.rows();
+        return BatchNJointAction(Matrix::Zero(num_robots, N),
+                                 position,
+                                 None(num_robots),
+                                 None(num_robots));
+    }
+
+    //! @brief Get the number of robots in the batch.
+    size_t num_robots() const
+    {
+        return torque.rows();
+    }
+
+    //! @brief Heap memory used by the matrices in bytes (see RobotData).
+    size_t dynamic_memory_size() const
+    {
+        return (torque.size() + position.size() + position_kp.size() +
+                position_kd.size()) *
+               sizeof(Scalar);
+    }
+
+    //! @brief Get the action of robot k.
+    RobotAction get_robot_action(size_t k) const
+    {
+        return RobotAction(torque.row(k).transpose(),
+                           position.row(k).transpose(),
+                           position_kp.row(k).transpose(),
+                           position_kd.row(k).transpose());
+    }
+
+    //! @brief Set the action of robot k.
+    void set_robot_action(size_t k, const RobotAction& action)
+    {
+        torque.row(k) = action.torque.transpose();
+        position.row(k) = action.position.transpose();
+        position_kp.row(k) = action.position_kp.transpose();
+        position_kd.row(k) = action.position_kd.transpose();
+    }
+
+    /**
+     * @brief Create a NaN-matrix.  Helper function to set defaults for
+     *     position.
+     *
+     * @param num_robots  Number of rows.
+     * @return Matrix with all elements set to NaN.
+     */
+    static Matrix None(size_t num_robots)
+    {
+        return Matrix::Constant(
+            num_robots, N, std::numeric_limits<Scalar>::quiet_NaN());
+    }
+
+private:
+    //! @brief Copy the matrix to a vector, robot by robot.
+    static std::vector<double> flatten(const Matrix& matrix)
+    {
+        std::vector<double> result(matrix.size());
+        Eigen::Map<Eigen::Matrix<double, N, Eigen::Dynamic>>(
+            result.data(), N, matrix.rows()) =
+            matrix.transpose().template cast<double>();
+        return result;
+    }
+};
+
+}  // namespace robot_interfaces
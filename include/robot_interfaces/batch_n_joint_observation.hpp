@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief Observations of a batch of generic n-joint robots.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+#include <serialization_utils/cereal_eigen.hpp>
+
+#include <robot_interfaces/loggable.hpp>
+#include <robot_interfaces/n_joint_observation.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Observations of a batch of K generic n-joint robots.
+ *
+ * Same fields as NJointObservation but in structure-of-arrays layout (see
+ * BatchNJointAction).
+ *
+ * @tparam N Number of joints per robot.
+ * @tparam Scalar_t Scalar type of the values.
+ */
+template <size_t N, typename Scalar_t = double>
+struct BatchNJointObservation : public Loggable
+{
+    //! @brief Number of joints per robot.
+    static constexpr size_t num_joints = N;
+
+    typedef Scalar_t Scalar;
+    //! @brief K×N matrix with one row per robot.
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, N> Matrix;
+    //! @brief Observation of a single robot of the batch.
+    typedef NJointObservation<N, Scalar> RobotObservation;
+
+    Matrix position;
+    Matrix velocity;
+    Matrix torque;
+
+    /**
+     * @param num_robots  Number of robots in the batch.  All values are
+     *     initialised to zero.
+     */
+    BatchNJointObservation(size_t num_robots = 0)
+        : position(Matrix::Zero(num_robots, N)),
+          velocity(Matrix::Zero(num_robots, N)),
+          torque(Matrix::Zero(num_robots, N))
+    {
+    }
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(position, velocity, torque);
+    }
+
+    std::vector<std::string> get_name() override
+    {
+        return {"position", "velocity", "torque"};
+    }
+
+    //! @brief Get the data, each field flattened robot by robot.
+    std::vector<std::vector<double>> get_data() override
+    {
+        return {flatten(position), flatten(velocity), flatten(torque)};
+    }
+
+    //! @brief Get the number of robots in the batch.
+    size_t num_robots() const
+    {
+        return position.rows();
+    }
+
+    //! @brief Heap memory used by the matrices in bytes (see RobotData).
+    size_t dynamic_memory_size() const
+    {
+        return (position.size() + velocity.size() + torque.size()) *
+               sizeof(Scalar);
+    }
+
+    //! @brief Get the observation of robot k.
+    RobotObservation get_robot_observation(size_t k) const
+    {
+        RobotObservation observation;
+        observation.position = position.row(k).transpose();
+        observation.velocity = velocity.row(k).transpose();
+        observation.torque = torque.row(k).transpose();
+        return observation;
+    }
+
+    //! @brief Set the observation of robot k.
+    void set_robot_observation(size_t k, const RobotObservation& observation)
+    {
+        position.row(k) = observation.position.transpose();
+        velocity.row(k) = observation.velocity.transpose();
+        torque.row(k) = observation.torque.transpose();
+    }
+
+private:
+    //! @brief Copy the matrix to a vector, robot by robot.
+    static std::vector<double> flatten(const Matrix& matrix)
+    {
+        std::vector<double> result(matrix.size());
+        Eigen::Map<Eigen::Matrix<double, N, Eigen::Dynamic>>(
+            result.data(), N, matrix.rows()) =
+            matrix.transpose().template cast<double>();
+        return result;
+    }
+};
+
+}  // namespace robot_interfaces
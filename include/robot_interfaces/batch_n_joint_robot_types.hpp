@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @brief Types for a batch of n-joint robots.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <memory>
+
+#include "batch_n_joint_action.hpp"
+#include "batch_n_joint_observation.hpp"
+#include "batch_robot_driver.hpp"
+#include "batch_robot_frontend.hpp"
+#include "types.hpp"
+
+namespace robot_interfaces
+{
+/**
+ * @brief Collection of types for a batch of generic N-joint robots.
+ *
+ * Instead of setting up one RobotData (with its time series) per robot, all
+ * robots of the batch share a single RobotData whose elements contain the data
+ * of all robots in structure-of-arrays layout.  Backend, logger, etc. are used
+ * as for a single robot.  The RobotLogger takes the number of values per
+ * field from the logged data, so the text and columnar logs have one value
+ * per joint and robot.
+ *
+ * Since the batch size is not fixed at compile time, the batch types are not
+ * suited for MultiProcessData, use SingleProcessData.
+ *
+ * @tparam N Number of joints per robot.
+ * @tparam Scalar Scalar type of actions and observations.
+ */
+template <size_t N, typename Scalar = double>
+struct BatchNJointRobotTypes
+    : public RobotInterfaceTypes<BatchNJointAction<N, Scalar>,
+                                 BatchNJointObservation<N, Scalar>>
+{
+    typedef BatchNJointRobotDriver<N, Scalar> Driver;
+    typedef std::shared_ptr<Driver> DriverPtr;
+
+    typedef BatchRobotFrontend<N, Scalar> BatchFrontend;
+    typedef std::shared_ptr<BatchFrontend> BatchFrontendPtr;
+    typedef BatchRobotFrontend<
+        N,
+        Scalar,
+        LockstepRobotFrontend<BatchNJointAction<N, Scalar>,
+                              BatchNJointObservation<N, Scalar>>>
+        LockstepBatchFrontend;
+    typedef std::shared_ptr<LockstepBatchFrontend> LockstepBatchFrontendPtr;
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,145 @@
+/**
+ * @file
+ * @brief Driver combining several n-joint robot drivers into one batch.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <robot_interfaces/batch_n_joint_action.hpp>
+#include <robot_interfaces/batch_n_joint_observation.hpp>
+#include <robot_interfaces/n_joint_action.hpp>
+#include <robot_interfaces/n_joint_observation.hpp>
+#include <robot_interfaces/robot_driver.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Run a batch of single-robot drivers as one batch driver.
+ *
+ * Allows to use existing drivers of type
+ * `RobotDriver<NJointAction<N>, NJointObservation<N>>` with the batch types.
+ * Each call is simply forwarded to all drivers in turn, row k of the batch
+ * action/observation corresponds to the k-th driver.
+ *
+ * Simulations that can step all robots at once should rather implement
+ * `RobotDriver<BatchNJointAction<N>, BatchNJointObservation<N>>` directly.
+ *
+ * @tparam N Number of joints per robot.
+ * @tparam Scalar Scalar type of actions and observations.
+ */
+template <size_t N, typename Scalar = double>
+class BatchNJointRobotDriver
+    : public RobotDriver<BatchNJointAction<N, Scalar>,
+                         BatchNJointObservation<N, Scalar>>
+{
+public:
+    typedef BatchNJointAction<N, Scalar> Action;
+    typedef BatchNJointObservation<N, Scalar> Observation;
+    typedef RobotDriver<NJointAction<N, Scalar>, NJointObservation<N, Scalar>>
+        RobotDriverType;
+    typedef std::shared_ptr<RobotDriverType> RobotDriverPtr;
+
+    /**
+     * @param drivers  Drivers of the robots in the batch.
+     * @throws std::invalid_argument if drivers is empty.
+     */
+    BatchNJointRobotDriver(const std::vector<RobotDriverPtr> &drivers)
+        : drivers_(drivers)
+    {
+        if (drivers_.empty())
+        {
+            throw std::invalid_argument("Batch needs at least one driver.");
+        }
+    }
+
+    //! @brief Get the number of robots in the batch.
+    size_t num_robots() const
+    {
+        return drivers_.size();
+    }
+
+    void initialize() override
+    {
+        for (auto &driver : drivers_)
+        {
+            driver->initialize();
+        }
+    }
+
+    /**
+     * @copydoc RobotDriver::apply_action
+     *
+     * If the number of rows of desired_action does not match the number of
+     * robots, nothing is applied and an error is reported via get_error().
+     */
+    Action apply_action(const Action &desired_action) override
+    {
+        if (desired_action.num_robots() != drivers_.size())
+        {
+            error_ = "Batch action has " +
+                     std::to_string(desired_action.num_robots()) +
+                     " rows but there are " + std::to_string(drivers_.size()) +
+                     " robots.";
+            return Action(drivers_.size());
+        }
+
+        Action applied_action(drivers_.size());
+        for (size_t k = 0; k < drivers_.size(); k++)
+        {
+            applied_action.set_robot_action(
+                k,
+                drivers_[k]->apply_action(
+                    desired_action.get_robot_action(k)));
+        }
+        return applied_action;
+    }
+
+    Observation get_latest_observation() override
+    {
+        Observation observation(drivers_.size());
+        for (size_t k = 0; k < drivers_.size(); k++)
+        {
+            observation.set_robot_observation(
+                k, drivers_[k]->get_latest_observation());
+        }
+        return observation;
+    }
+
+    //! @brief Get the batch error or the error of the first robot with one.
+    std::string get_error() override
+    {
+        if (!error_.empty())
+        {
+            return error_;
+        }
+        for (size_t k = 0; k < drivers_.size(); k++)
+        {
+            std::string error = drivers_[k]->get_error();
+            if (!error.empty())
+            {
+                return "Robot " + std::to_string(k) + ": " + error;
+            }
+        }
+        return "";
+    }
+
+    void shutdown() override
+    {
+        for (auto &driver : drivers_)
+        {
+            driver->shutdown();
+        }
+    }
+
+private:
+    std::vector<RobotDriverPtr> drivers_;
+    std::string error_;
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @brief Frontend with batch methods for a batch of n-joint robots.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <robot_interfaces/batch_n_joint_action.hpp>
+#include <robot_interfaces/batch_n_joint_observation.hpp>
+#include <robot_interfaces/robot_frontend.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Frontend for a batch of K n-joint robots sharing one RobotData.
+ *
+ * All robots of the batch are stepped together, i.e. one time step of the
+ * robot data contains the actions/observations of all robots (see
+ * BatchNJointAction and BatchNJointObservation).  In addition to the normal
+ * frontend methods, this provides methods to directly pass and get K×N
+ * matrices, so a vectorized policy can drive all robots with one call.
+ *
+ * @tparam N Number of joints per robot.
+ * @tparam Scalar Scalar type of actions and observations.
+ * @tparam Frontend  Frontend class which is extended.  Use
+ *     LockstepRobotFrontend to step the robots without backend thread.
+ */
+template <size_t N,
+          typename Scalar = double,
+          typename Frontend = RobotFrontend<BatchNJointAction<N, Scalar>,
+                                            BatchNJointObservation<N, Scalar>>>
+class BatchRobotFrontend : public Frontend
+{
+public:
+    typedef BatchNJointAction<N, Scalar> Action;
+    typedef BatchNJointObservation<N, Scalar> Observation;
+    //! @brief K×N matrix with one row per robot.
+    typedef typename Action::Matrix Matrix;
+
+    using Frontend::Frontend;
+
+    /**
+     * @brief Append torque actions for all robots.
+     *
+     * @param torques  Desired torques, one row per robot.
+     * @return Time step at which the actions will be applied.
+     */
+    TimeIndex append_desired_actions(const Matrix &torques)
+    {
+        return this->append_desired_action(Action::Torque(torques));
+    }
+
+    /**
+     * @brief Append actions for all robots.
+     *
+     * @param actions  Desired actions of all robots.
+     * @return Time step at which the actions will be applied.
+     */
+    TimeIndex append_desired_actions(const Action &actions)
+    {
+        return this->append_desired_action(actions);
+    }
+
+    /**
+     * @brief Get the observations of all robots of time step t.
+     *
+     * See RobotFrontend::get_observation.
+     */
+    Observation get_observations(const TimeIndex &t) const
+    {
+        return this->get_observation(t);
+    }
+
+    //! @brief Get the latest observations of all robots.
+    Observation get_observations() const
+    {
+        return this->get_observation(this->get_current_timeindex());
+    }
+};
+
+}  // namespace robot_interfaces
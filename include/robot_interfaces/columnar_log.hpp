@@ -0,0 +1,958 @@
+/**
+ * @file
+ * @brief Columnar, compressed log file format.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * A columnar log file stores a table of numeric values.  Each column has a name
+ * and a width (number of values per row, e.g. one per joint).  Rows are
+ * buffered and written in row groups.  Within a row group, each column is
+ * stored as a separate, compressed chunk, so a reader can decode only the
+ * columns it is interested in and skip the others.
+ *
+ * The file is a record log (see record_log.hpp) with magic "RILOGCOL", so
+ * each row group is checksummed and the file can be recovered if the writing
+ * process crashes.  Since a row group is one record, the checksum covers all
+ * of its chunks:  When reading only some of the columns, the decoding of the
+ * other columns is skipped, but the complete row groups are still read from
+ * the file and checksummed.  The payloads of the records are (all integers in the
+ * native byte order of the writing machine, i.e. files are not portable
+ * between little and big endian hosts):
+ *
+ * @verbatim
+   first record (header), key -1:
+       number of columns                     uint32
+       for each column:
+           name length, name                 uint32, chars
+           width                             uint32
+           encoding (see ColumnEncoding)     uint8
+           compression (see ColumnCompression)   uint8
+   one record per row group, key = index of the first row:
+       number of rows                        uint32
+       for each column:
+           chunk size in bytes               uint64
+           chunk                             bytes
+   @endverbatim
+ *
+ * Chunks are encoded as follows: The values of the chunk are stored
+ * "lane-wise", i.e. first all values of the first element of the column, then
+ * of the second, and so on.  Each value is interpreted as 64 bit integer (the
+ * bit pattern of the double).  With delta encoding, each value is replaced by
+ * its difference to the previous value of the same lane (zigzag encoded, so
+ * small negative differences result in small numbers as well).  For slowly
+ * changing signals this results in values where the high bytes are mostly
+ * zero.  Then the bytes are shuffled such that all first bytes of the values
+ * come first, then all second bytes, etc. and finally the resulting byte
+ * sequence is compressed, either with a simple run-length encoding or, if
+ * robot_interfaces is built with zstd (ROBOT_INTERFACES_WITH_ZSTD), with zstd
+ * (see ColumnCompression).  This is lossless and works especially well for
+ * constant or slowly changing values (like status fields, gains, time indices
+ * and timestamps).  Noisy measurements (joint positions, velocities, torques)
+ * hardly compress, as the noise in the low bytes of the mantissa is random:
+ * for simulated measurements with Gaussian noise, the size is only reduced by
+ * a factor of 1.1 to 1.3, with both run-length encoding and zstd.
+ *
+ * Files of format version 2 (without compression field in the header, always
+ * run-length encoded) can still be read.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef ROBOT_INTERFACES_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include <robot_interfaces/log_manifest.hpp>
+#include <robot_interfaces/record_log.hpp>
+
+namespace robot_interfaces
+{
+//! @brief Encoding of the values of a column in a ColumnarLogWriter.
+enum class ColumnEncoding : std::uint8_t
+{
+    //! @brief Values are stored as they are (but still compressed).
+    PLAIN = 0,
+    //! @brief Store differences to the previous value instead of the values.
+    DELTA = 1
+};
+
+//! @brief Compression of the encoded values of a column.
+enum class ColumnCompression : std::uint8_t
+{
+    //! @brief Simple run-length encoding (always available).
+    RLE = 0,
+    //! @brief Zstandard (only available if built with zstd).
+    ZSTD = 1
+};
+
+namespace columnar_log
+{
+//! @brief Compression used if not specified otherwise (zstd if available).
+#ifdef ROBOT_INTERFACES_WITH_ZSTD
+constexpr ColumnCompression DEFAULT_COMPRESSION = ColumnCompression::ZSTD;
+#else
+constexpr ColumnCompression DEFAULT_COMPRESSION = ColumnCompression::RLE;
+#endif
+}  // namespace columnar_log
+
+//! @brief Description of a column in a columnar log file.
+struct ColumnInfo
+{
+    //! @brief Name of the column.
+    std::string name;
+    //! @brief Number of values per row.
+    std::uint32_t width = 1;
+    //! @brief Encoding that is used to store the values.
+    ColumnEncoding encoding = ColumnEncoding::DELTA;
+    //! @brief Compression of the encoded values.
+    ColumnCompression compression = columnar_log::DEFAULT_COMPRESSION;
+};
+
+//! @brief Values of one column of a columnar log file.
+struct ColumnData
+{
+    //! @brief Name of the column.
+    std::string name;
+    //! @brief Number of values per row.
+    std::uint32_t width = 1;
+    //! @brief Values of all rows, row-major (i.e. of shape num_rows x width).
+    std::vector<double> values;
+
+    //! @brief Get the number of rows.
+    size_t num_rows() const
+    {
+        return width > 0 ? values.size() / width : 0;
+    }
+};
+
+namespace columnar_log
+{
+constexpr char MAGIC[8] = {'R', 'I', 'L', 'O', 'G', 'C', 'O', 'L'};
+constexpr std::uint32_t FORMAT_VERSION = 3;
+//! @brief Oldest format version that can still be read.
+constexpr std::uint32_t MIN_FORMAT_VERSION = 2;
+//! @brief Compression level used for zstd (fast, as logging runs online).
+constexpr int ZSTD_LEVEL = 1;
+
+/**
+ * @brief Compress bytes using a simple run-length encoding.
+ *
+ * The output consists of packets starting with a control byte c.  If c < 128,
+ * it is followed by c + 1 literal bytes.  Otherwise it is followed by a single
+ * byte which is repeated c - 126 times.
+ */
+inline void rle_compress(const std::uint8_t *data,
+                         size_t size,
+                         std::string &out)
+{
+    constexpr size_t MAX_LITERAL = 128;
+    constexpr size_t MAX_RUN = 129;
+
+    size_t i = 0;
+    while (i < size)
+    {
+        // determine length of the run starting at i
+        size_t run = 1;
+        while (i + run < size && run < MAX_RUN && data[i + run] == data[i])
+        {
+            run++;
+        }
+
+        if (run >= 3)
+        {
+            out.push_back(static_cast<char>(run + 126));
+            out.push_back(static_cast<char>(data[i]));
+            i += run;
+        }
+        else
+        {
+            // collect literals until the next run of at least 3 bytes
+            size_t start = i;
+            while (i < size && i - start < MAX_LITERAL)
+            {
+                if (i + 2 < size && data[i] == data[i + 1] &&
+                    data[i] == data[i + 2])
+                {
+                    break;
+                }
+                i++;
+            }
+            out.push_back(static_cast<char>(i - start - 1));
+            out.append(reinterpret_cast<const char *>(data + start),
+                       i - start);
+        }
+    }
+}
+
+//! @brief Decompress data compressed with rle_compress().
+inline void rle_decompress(const std::uint8_t *data,
+                           size_t size,
+                           std::uint8_t *out,
+                           size_t out_size)
+{
+    size_t i = 0, o = 0;
+    while (i < size)
+    {
+        const std::uint8_t control = data[i++];
+        if (control < 128)
+        {
+            const size_t n = control + 1;
+            if (i + n > size || o + n > out_size)
+            {
+                throw std::runtime_error("Corrupted column chunk.");
+            }
+            std::memcpy(out + o, data + i, n);
+            i += n;
+            o += n;
+        }
+        else
+        {
+            const size_t n = control - 126;
+            if (i >= size || o + n > out_size)
+            {
+                throw std::runtime_error("Corrupted column chunk.");
+            }
+            std::memset(out + o, data[i++], n);
+            o += n;
+        }
+    }
+
+    if (o != out_size)
+    {
+        throw std::runtime_error("Corrupted column chunk.");
+    }
+}
+
+//! @brief Check if the given compression is supported by this build.
+inline bool is_compression_available(ColumnCompression compression)
+{
+    switch (compression)
+    {
+        case ColumnCompression::RLE:
+            return true;
+        case ColumnCompression::ZSTD:
+#ifdef ROBOT_INTERFACES_WITH_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+/**
+ * @brief Compress bytes with the given compression.
+ *
+ * @param data  The bytes to compress.
+ * @param size  Number of bytes.
+ * @param compression  The compression.
+ * @param out  The compressed bytes are appended to this string.
+ * @throws std::runtime_error if the compression is not available.
+ */
+inline void compress(const std::uint8_t *data,
+                     size_t size,
+                     ColumnCompression compression,
+                     std::string &out)
+{
+    if (!is_compression_available(compression))
+    {
+        throw std::runtime_error(
+            "Compression of columnar log is not available in this build.");
+    }
+
+#ifdef ROBOT_INTERFACES_WITH_ZSTD
+    if (compression == ColumnCompression::ZSTD)
+    {
+        const size_t offset = out.size();
+        out.resize(offset + ZSTD_compressBound(size));
+        const size_t compressed_size = ZSTD_compress(
+            &out[offset], out.size() - offset, data, size, ZSTD_LEVEL);
+        if (ZSTD_isError(compressed_size))
+        {
+            throw std::runtime_error(std::string("zstd compression failed: ") +
+                                     ZSTD_getErrorName(compressed_size));
+        }
+        out.resize(offset + compressed_size);
+        return;
+    }
+#endif
+
+    rle_compress(data, size, out);
+}
+
+/**
+ * @brief Decompress data compressed with compress().
+ *
+ * @throws std::runtime_error if the data is corrupted or the compression is
+ *     not available.
+ */
+inline void decompress(const std::uint8_t *data,
+                       size_t size,
+                       ColumnCompression compression,
+                       std::uint8_t *out,
+                       size_t out_size)
+{
+    if (!is_compression_available(compression))
+    {
+        throw std::runtime_error(
+            "Columnar log uses a compression that is not available in this "
+            "build (zstd requires robot_interfaces to be built with zstd).");
+    }
+
+#ifdef ROBOT_INTERFACES_WITH_ZSTD
+    if (compression == ColumnCompression::ZSTD)
+    {
+        const size_t decompressed_size =
+            ZSTD_decompress(out, out_size, data, size);
+        if (ZSTD_isError(decompressed_size) || decompressed_size != out_size)
+        {
+            throw std::runtime_error("Corrupted column chunk.");
+        }
+        return;
+    }
+#endif
+
+    rle_decompress(data, size, out, out_size);
+}
+
+/**
+ * @brief Encode a column chunk.
+ *
+ * @param values  Values of the chunk, lane-wise (see file description).
+ * @param num_rows  Number of rows in the chunk.
+ * @param width  Number of lanes.
+ * @param encoding  Encoding of the column.
+ * @param compression  Compression of the column.
+ * @param buffer  Buffer used for intermediate results (to avoid allocations).
+ * @param out  The encoded chunk is appended to this string.
+ */
+inline void encode_chunk(const double *values,
+                         size_t num_rows,
+                         size_t width,
+                         ColumnEncoding encoding,
+                         ColumnCompression compression,
+                         std::vector<std::uint64_t> &buffer,
+                         std::string &out)
+{
+    const size_t n = num_rows * width;
+    buffer.resize(2 * n);
+    std::uint64_t *words = buffer.data();
+    std::uint8_t *bytes = reinterpret_cast<std::uint8_t *>(words + n);
+
+    std::memcpy(words, values, n * sizeof(std::uint64_t));
+
+    if (encoding == ColumnEncoding::DELTA)
+    {
+        for (size_t lane = 0; lane < width; lane++)
+        {
+            std::uint64_t *w = words + lane * num_rows;
+            for (size_t i = num_rows - 1; i > 0; i--)
+            {
+                const std::uint64_t delta = w[i] - w[i - 1];
+                // zigzag encoding
+                w[i] = (delta << 1) ^ (0 - (delta >> 63));
+            }
+        }
+    }
+
+    // byte shuffle
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t b = 0; b < sizeof(std::uint64_t); b++)
+        {
+            bytes[b * n + i] = static_cast<std::uint8_t>(words[i] >> (8 * b));
+        }
+    }
+
+    compress(bytes, n * sizeof(std::uint64_t), compression, out);
+}
+
+//! @brief Decode a column chunk encoded with encode_chunk().
+inline void decode_chunk(const char *chunk,
+                         size_t chunk_size,
+                         size_t num_rows,
+                         size_t width,
+                         ColumnEncoding encoding,
+                         ColumnCompression compression,
+                         std::vector<std::uint64_t> &buffer,
+                         double *values)
+{
+    const size_t n = num_rows * width;
+    buffer.resize(2 * n);
+    std::uint64_t *words = buffer.data();
+    std::uint8_t *bytes = reinterpret_cast<std::uint8_t *>(words + n);
+
+    decompress(reinterpret_cast<const std::uint8_t *>(chunk),
+               chunk_size,
+               compression,
+               bytes,
+               n * sizeof(std::uint64_t));
+
+    for (size_t i = 0; i < n; i++)
+    {
+        std::uint64_t w = 0;
+        for (size_t b = 0; b < sizeof(std::uint64_t); b++)
+        {
+            w |= static_cast<std::uint64_t>(bytes[b * n + i]) << (8 * b);
+        }
+        words[i] = w;
+    }
+
+    if (encoding == ColumnEncoding::DELTA)
+    {
+        for (size_t lane = 0; lane < width; lane++)
+        {
+            std::uint64_t *w = words + lane * num_rows;
+            for (size_t i = 1; i < num_rows; i++)
+            {
+                const std::uint64_t delta = (w[i] >> 1) ^ (0 - (w[i] & 1));
+                w[i] = w[i - 1] + delta;
+            }
+        }
+    }
+
+    std::memcpy(values, words, n * sizeof(double));
+}
+
+template <typename T>
+void append_value(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+//! @brief Read a value from `data` at position `pos` and advance `pos`.
+template <typename T>
+T read_value(const std::string &data, size_t &pos)
+{
+    if (pos + sizeof(T) > data.size())
+    {
+        throw std::runtime_error("Corrupted columnar log record.");
+    }
+    T value;
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+}  // namespace columnar_log
+
+/**
+ * @brief Write a table of numeric values to a columnar log file.
+ *
+ * Rows are buffered in memory and written to the file in row groups of fixed
+ * size.  Memory for the buffer is allocated once on construction, so appending
+ * rows does not allocate.  Writing a row group, however, involves encoding and
+ * file I/O, so the writer should not be used from a real-time thread.
+ *
+ * Each row group is written as one checksummed record, so if the process
+ * crashes, only the rows of the current (not yet written) row group are lost.
+ *
+ * See columnar_log.hpp for a description of the file format.
+ */
+class ColumnarLogWriter
+{
+public:
+    /**
+     * @brief Create the log file and write the header.
+     *
+     * @param filename  Path to the log file.  Existing files are overwritten!
+     * @param columns  Columns of the table.
+     * @param rows_per_group  Number of rows per row group.
+     * @throws std::invalid_argument if rows_per_group is zero or the
+     *     compression of a column is not available in this build.
+     */
+    ColumnarLogWriter(const std::string &filename,
+                      const std::vector<ColumnInfo> &columns,
+                      size_t rows_per_group = 1000)
+        : file_(filename, columnar_log::MAGIC, columnar_log::FORMAT_VERSION),
+          columns_(columns),
+          rows_per_group_(rows_per_group),
+          num_rows_(0),
+          num_rows_written_(0)
+    {
+        if (rows_per_group_ == 0)
+        {
+            throw std::invalid_argument("rows_per_group must be positive.");
+        }
+        for (const ColumnInfo &column : columns_)
+        {
+            if (!columnar_log::is_compression_available(column.compression))
+            {
+                throw std::invalid_argument(
+                    "Compression of column " + column.name +
+                    " is not available in this build.");
+            }
+        }
+
+        row_width_ = 0;
+        for (const ColumnInfo &column : columns_)
+        {
+            row_width_ += column.width;
+        }
+        buffer_.resize(row_width_ * rows_per_group_);
+
+        write_header();
+    }
+
+    ~ColumnarLogWriter()
+    {
+        close();
+    }
+
+    //! @brief Get the columns of the table.
+    const std::vector<ColumnInfo> &get_columns() const
+    {
+        return columns_;
+    }
+
+    //! @brief Get the number of values per row (sum of the column widths).
+    size_t get_row_width() const
+    {
+        return row_width_;
+    }
+
+    /**
+     * @brief Get the number of bytes written to the file so far.
+     *
+     * Rows of the current row group are not included as they are only
+     * written when the group is complete.
+     */
+    size_t get_bytes_written() const
+    {
+        return file_.get_bytes_written();
+    }
+
+    /**
+     * @brief Append a row to the table.
+     *
+     * If this completes a row group, it is written to the file.
+     *
+     * @param values  Values of all columns, in the order of the columns.  Must
+     *     contain get_row_width() elements.
+     */
+    void append_row(const double *values)
+    {
+        // store lane-wise: all values of one element of a column are
+        // contiguous
+        const double *value = values;
+        for (size_t lane = 0; lane < row_width_; lane++)
+        {
+            buffer_[lane * rows_per_group_ + num_rows_] = *value++;
+        }
+        num_rows_++;
+
+        if (num_rows_ == rows_per_group_)
+        {
+            flush();
+        }
+    }
+
+    //! @copydoc append_row(const double*)
+    void append_row(const std::vector<double> &values)
+    {
+        if (values.size() != row_width_)
+        {
+            throw std::invalid_argument("Row has wrong number of values.");
+        }
+        append_row(values.data());
+    }
+
+    //! @brief Write buffered rows to the file (as a, possibly smaller, group).
+    void flush()
+    {
+        if (num_rows_ == 0 || is_closed_)
+        {
+            return;
+        }
+
+        record_.clear();
+        columnar_log::append_value<std::uint32_t>(record_, num_rows_);
+
+        size_t lane = 0;
+        for (const ColumnInfo &column : columns_)
+        {
+            // if the group is not full, the lanes of the column are not
+            // contiguous, so move them together first
+            const double *values = &buffer_[lane * rows_per_group_];
+            if (num_rows_ < rows_per_group_)
+            {
+                compact_buffer_.resize(num_rows_ * column.width);
+                for (size_t j = 0; j < column.width; j++)
+                {
+                    std::memcpy(&compact_buffer_[j * num_rows_],
+                                &buffer_[(lane + j) * rows_per_group_],
+                                num_rows_ * sizeof(double));
+                }
+                values = compact_buffer_.data();
+            }
+
+            chunk_.clear();
+            columnar_log::encode_chunk(values,
+                                       num_rows_,
+                                       column.width,
+                                       column.encoding,
+                                       column.compression,
+                                       encode_buffer_,
+                                       chunk_);
+            columnar_log::append_value<std::uint64_t>(record_, chunk_.size());
+            record_.append(chunk_);
+
+            lane += column.width;
+        }
+
+        file_.append(record_, num_rows_written_);
+        num_rows_written_ += num_rows_;
+        num_rows_ = 0;
+    }
+
+    //! @brief Write remaining rows and close the file.
+    void close()
+    {
+        if (!is_closed_)
+        {
+            flush();
+            file_.close();
+            is_closed_ = true;
+        }
+    }
+
+private:
+    RecordLogWriter file_;
+    bool is_closed_ = false;
+    std::vector<ColumnInfo> columns_;
+    size_t rows_per_group_;
+    size_t row_width_;
+
+    //! @brief Buffered rows, lane-wise.
+    std::vector<double> buffer_;
+    size_t num_rows_;
+    size_t num_rows_written_;
+
+    std::vector<double> compact_buffer_;
+    std::vector<std::uint64_t> encode_buffer_;
+    std::string chunk_;
+    std::string record_;
+
+    void write_header()
+    {
+        record_.clear();
+        columnar_log::append_value<std::uint32_t>(record_, columns_.size());
+        for (const ColumnInfo &column : columns_)
+        {
+            columnar_log::append_value<std::uint32_t>(record_,
+                                                      column.name.size());
+            record_.append(column.name);
+            columnar_log::append_value<std::uint32_t>(record_, column.width);
+            columnar_log::append_value<std::uint8_t>(
+                record_, static_cast<std::uint8_t>(column.encoding));
+            columnar_log::append_value<std::uint8_t>(
+                record_, static_cast<std::uint8_t>(column.compression));
+        }
+        file_.append(record_, -1);
+    }
+};
+
+/**
+ * @brief Read columns from a columnar log file.
+ *
+ * Only the requested columns are decoded, chunks of other columns are skipped.
+ *
+ * Files that were not closed properly (e.g. because the logging process
+ * crashed) can be read as well.  All row groups that were completely written
+ * are recovered (see RecordLogReader).
+ *
+ * Segmented logs are supported as well: If the given file is a LogManifest,
+ * the segments listed there are read one after another and presented as one
+ * continuous log.
+ */
+class ColumnarLogReader
+{
+public:
+    /**
+     * @brief Open the file and read the header.
+     *
+     * @param filename  Path to the columnar log file or to the manifest of a
+     *     segmented columnar log.
+     */
+    ColumnarLogReader(const std::string &filename)
+    {
+        if (LogManifest::is_manifest(filename))
+        {
+            filenames_ =
+                LogManifest::read(filename).get_segment_paths(filename);
+        }
+        else
+        {
+            filenames_ = {filename};
+        }
+
+        for (const std::string &segment_filename : filenames_)
+        {
+            if (!RecordLogReader::has_magic(segment_filename,
+                                            columnar_log::MAGIC))
+            {
+                throw std::runtime_error(segment_filename +
+                                         " is not a columnar log file.");
+            }
+            files_.push_back(std::make_unique<RecordLogReader>(
+                segment_filename, columnar_log::MAGIC));
+            read_header(*files_.back(), segment_filename);
+        }
+    }
+
+    /**
+     * @brief Check if incomplete data was found at the end of a file.
+     *
+     * This is the case if the writing process did not close the file
+     * properly.  The incomplete data is ignored.
+     */
+    bool is_truncated() const
+    {
+        for (const auto &file : files_)
+        {
+            if (file->is_truncated())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! @brief Get the columns contained in the file.
+    const std::vector<ColumnInfo> &get_columns() const
+    {
+        return columns_;
+    }
+
+    //! @brief Get the names of the columns contained in the file.
+    std::vector<std::string> get_column_names() const
+    {
+        std::vector<std::string> names;
+        for (const ColumnInfo &column : columns_)
+        {
+            names.push_back(column.name);
+        }
+        return names;
+    }
+
+    //! @brief Check if the file contains a column with the given name.
+    bool has_column(const std::string &name) const
+    {
+        return find_column(name) >= 0;
+    }
+
+    /**
+     * @brief Read the values of the specified columns.
+     *
+     * @param names  Names of the columns.
+     * @return Data of the columns in the order given by `names`.
+     * @throws std::invalid_argument if one of the columns does not exist.
+     */
+    std::vector<ColumnData> read_columns(
+        const std::vector<std::string> &names) const
+    {
+        std::vector<ColumnData> result(names.size());
+        // index of the requested column in `result` for each column in the
+        // file (-1 if not requested)
+        std::vector<int> result_index(columns_.size(), -1);
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            int c = find_column(names[i]);
+            if (c < 0)
+            {
+                throw std::invalid_argument("No column " + names[i] +
+                                            " in log file.");
+            }
+            result_index[c] = i;
+            result[i].name = columns_[c].name;
+            result[i].width = columns_[c].width;
+        }
+
+        for (const auto &file : files_)
+        {
+            read_file(*file, result_index, result);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Read the values of a single column.
+     *
+     * @param name  Name of the column.
+     * @return Data of the column.
+     * @throws std::invalid_argument if the column does not exist.
+     */
+    ColumnData read_column(const std::string &name) const
+    {
+        return read_columns({name})[0];
+    }
+
+private:
+    //! @brief The files that are read (multiple in case of segmented logs).
+    std::vector<std::string> filenames_;
+    std::vector<std::unique_ptr<RecordLogReader>> files_;
+    std::vector<ColumnInfo> columns_;
+
+    int find_column(const std::string &name) const
+    {
+        for (size_t i = 0; i < columns_.size(); i++)
+        {
+            if (columns_[i].name == name)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Read the requested columns of a file and append to result.
+     *
+     * @param file  The file.
+     * @param result_index  Index in `result` for each column in the file (-1
+     *     if the column is not requested).
+     * @param result  Values of the requested columns are appended here.
+     */
+    void read_file(RecordLogReader &file,
+                   const std::vector<int> &result_index,
+                   std::vector<ColumnData> &result) const
+    {
+        std::string record;
+        std::vector<std::uint64_t> decode_buffer;
+        std::vector<double> lanes;
+        // the first record is the header
+        for (size_t i = 1; i < file.size(); i++)
+        {
+            file.read(i, record);
+            size_t pos = 0;
+
+            const std::uint32_t num_rows =
+                columnar_log::read_value<std::uint32_t>(record, pos);
+
+            for (size_t c = 0; c < columns_.size(); c++)
+            {
+                const std::uint64_t chunk_size =
+                    columnar_log::read_value<std::uint64_t>(record, pos);
+                if (pos + chunk_size > record.size())
+                {
+                    throw std::runtime_error("Corrupted columnar log record.");
+                }
+
+                if (result_index[c] < 0)
+                {
+                    pos += chunk_size;
+                    continue;
+                }
+
+                const size_t width = columns_[c].width;
+                lanes.resize(num_rows * width);
+                columnar_log::decode_chunk(record.data() + pos,
+                                           chunk_size,
+                                           num_rows,
+                                           width,
+                                           columns_[c].encoding,
+                                           columns_[c].compression,
+                                           decode_buffer,
+                                           lanes.data());
+                pos += chunk_size;
+
+                // convert from lane-wise to row-major
+                std::vector<double> &values = result[result_index[c]].values;
+                const size_t offset = values.size();
+                values.resize(offset + num_rows * width);
+                for (size_t row = 0; row < num_rows; row++)
+                {
+                    for (size_t j = 0; j < width; j++)
+                    {
+                        values[offset + row * width + j] =
+                            lanes[j * num_rows + row];
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Read the header of a file.
+     *
+     * The columns of the first file are stored in columns_, all further files
+     * (segments) need to have the same columns (name, width, encoding and
+     * compression).
+     */
+    void read_header(RecordLogReader &file, const std::string &filename)
+    {
+        const std::uint32_t format_version = file.get_format_version();
+        if (format_version < columnar_log::MIN_FORMAT_VERSION ||
+            format_version > columnar_log::FORMAT_VERSION)
+        {
+            throw std::runtime_error("Incompatible log file format.");
+        }
+        if (file.size() == 0)
+        {
+            throw std::runtime_error("Header of " + filename +
+                                     " is missing.");
+        }
+
+        std::string header;
+        file.read(0, header);
+        size_t pos = 0;
+
+        const std::uint32_t num_columns =
+            columnar_log::read_value<std::uint32_t>(header, pos);
+        std::vector<ColumnInfo> columns(num_columns);
+        for (ColumnInfo &column : columns)
+        {
+            const std::uint32_t name_length =
+                columnar_log::read_value<std::uint32_t>(header, pos);
+            if (pos + name_length > header.size())
+            {
+                throw std::runtime_error("Corrupted columnar log header.");
+            }
+            column.name = header.substr(pos, name_length);
+            pos += name_length;
+            column.width = columnar_log::read_value<std::uint32_t>(header, pos);
+            column.encoding = static_cast<ColumnEncoding>(
+                columnar_log::read_value<std::uint8_t>(header, pos));
+            // version 2 has no compression field and always uses RLE
+            column.compression =
+                format_version < 3
+                    ? ColumnCompression::RLE
+                    : static_cast<ColumnCompression>(
+                          columnar_log::read_value<std::uint8_t>(header, pos));
+        }
+
+        if (files_.size() == 1)
+        {
+            columns_ = columns;
+        }
+        else
+        {
+            bool same_columns = columns.size() == columns_.size();
+            for (size_t i = 0; same_columns && i < columns.size(); i++)
+            {
+                // encoding and compression have to match as well, as the
+                // chunks of all segments are decoded with those of columns_
+                same_columns =
+                    columns[i].name == columns_[i].name &&
+                    columns[i].width == columns_[i].width &&
+                    columns[i].encoding == columns_[i].encoding &&
+                    columns[i].compression == columns_[i].compression;
+            }
+            if (!same_columns)
+            {
+                throw std::runtime_error("Columns of segment " + filename +
+                                         " do not match the other segments.");
+            }
+        }
+    }
+};
+
+}  // namespace robot_interfaces
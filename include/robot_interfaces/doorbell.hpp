@@ -0,0 +1,310 @@
+/**
+ * @file
+ * @brief Low-latency notification channel that also works across processes.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "shared_memory_segment.hpp"
+
+namespace robot_interfaces
+{
+/**
+ * @brief Futex-based "doorbell" to notify waiting threads/processes.
+ *
+ * The doorbell consists of a sequence counter which is incremented by each
+ * call of ring().  A waiter first reads the counter with get_sequence(), then
+ * checks if the data it is waiting for is available and, if not, calls
+ * wait() with the sequence it read.  wait() returns as soon as the doorbell
+ * was rung after get_sequence() was called, so no notification is missed:
+ *
+ *     uint32_t sequence = doorbell.get_sequence();
+ *     while (!data_available())
+ *     {
+ *         doorbell.wait(sequence, timeout_s);
+ *         sequence = doorbell.get_sequence();
+ *     }
+ *
+ * The counter either lives in the memory of the process (default
+ * constructor) or in a POSIX shared memory segment (create_leader() /
+ * create_follower()), in which case the doorbell can be used across
+ * processes.  The leader removes the shared memory again on destruction.
+ * ring() only does a system call if somebody is waiting.
+ */
+class Doorbell
+{
+public:
+    //! @brief Create a doorbell for use within one process.
+    Doorbell()
+    {
+    }
+
+    /**
+     * @brief Create a doorbell in shared memory.
+     *
+     * Existing shared memory with the same ID is reset.
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     */
+    static std::shared_ptr<Doorbell> create_leader(
+        const std::string &shared_memory_id)
+    {
+        return std::shared_ptr<Doorbell>(
+            new Doorbell(shared_memory_id, true));
+    }
+
+    /**
+     * @brief Open a doorbell in shared memory created by create_leader().
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     * @throws std::runtime_error if the shared memory does not exist.
+     */
+    static std::shared_ptr<Doorbell> create_follower(
+        const std::string &shared_memory_id)
+    {
+        return std::shared_ptr<Doorbell>(
+            new Doorbell(shared_memory_id, false));
+    }
+
+    //! @brief Remove the shared memory segment with the given ID.
+    static void clear_memory(const std::string &shared_memory_id)
+    {
+        SharedMemorySegment<State>::clear_memory(shared_memory_id);
+    }
+
+    //! @brief Get the current value of the sequence counter.
+    uint32_t get_sequence() const
+    {
+        return state_->sequence.load();
+    }
+
+    //! @brief Increment the sequence counter and wake up all waiters.
+    void ring()
+    {
+        state_->sequence.fetch_add(1);
+        if (state_->num_waiters.load() > 0)
+        {
+            futex(FUTEX_WAKE, std::numeric_limits<int>::max(), nullptr);
+        }
+    }
+
+    /**
+     * @brief Wait until the doorbell is rung.
+     *
+     * @param sequence  Value returned by get_sequence() before checking the
+     *     condition that is waited for.  If the doorbell was rung since then,
+     *     this returns immediately.
+     * @param timeout_s  Maximum time to wait in seconds (infinity to wait
+     *     without timeout).
+     * @return True if the doorbell was rung, false on timeout.
+     */
+    bool wait(uint32_t sequence,
+              double timeout_s = std::numeric_limits<double>::infinity())
+    {
+        struct timespec timeout;
+        struct timespec *timeout_ptr = nullptr;
+        if (std::isfinite(timeout_s))
+        {
+            const double seconds = std::max(0.0, timeout_s);
+            timeout.tv_sec = static_cast<time_t>(seconds);
+            timeout.tv_nsec =
+                static_cast<long>((seconds - timeout.tv_sec) * 1e9);
+            timeout_ptr = &timeout;
+        }
+
+        state_->num_waiters.fetch_add(1);
+        // FUTEX_WAIT checks atomically that the counter still has the given
+        // value before going to sleep.  The timeout is relative, so spurious
+        // wake-ups simply end the wait early (the caller re-checks anyway).
+        long result = futex(FUTEX_WAIT, sequence, timeout_ptr);
+        int error = errno;
+        state_->num_waiters.fetch_sub(1);
+
+        if (result == 0 || error == EAGAIN || error == EINTR)
+        {
+            return get_sequence() != sequence;
+        }
+        if (error == ETIMEDOUT)
+        {
+            return false;
+        }
+        throw std::runtime_error(std::string("futex wait failed: ") +
+                                 std::strerror(error));
+    }
+
+    /**
+     * @brief Wait until any of the given doorbells is rung.
+     *
+     * Uses the futex_waitv system call (Linux >= 5.16), so a single thread can
+     * wait for many doorbells.  On older kernels, it falls back to waiting on
+     * the first doorbell with a short timeout and checking the others in
+     * between.
+     *
+     * @param doorbells  The doorbells (at most 128).
+     * @param sequences  For each doorbell, the value returned by
+     *     get_sequence() before checking the condition that is waited for.
+     * @param timeout_s  Maximum time to wait in seconds (infinity to wait
+     *     without timeout).
+     * @return True if one of the doorbells was rung, false on timeout.
+     */
+    static bool wait_any(
+        const std::vector<Doorbell *> &doorbells,
+        const std::vector<uint32_t> &sequences,
+        double timeout_s = std::numeric_limits<double>::infinity())
+    {
+        if (doorbells.size() != sequences.size() || doorbells.empty() ||
+            doorbells.size() > MAX_WAIT_ANY)
+        {
+            throw std::invalid_argument(
+                "Invalid number of doorbells or sequences.");
+        }
+
+        auto is_rung = [&doorbells, &sequences]() {
+            for (size_t i = 0; i < doorbells.size(); i++)
+            {
+                if (doorbells[i]->get_sequence() != sequences[i])
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        // futex_waitv expects an absolute timeout
+        struct timespec deadline;
+        struct timespec *deadline_ptr = nullptr;
+        if (std::isfinite(timeout_s))
+        {
+            const double seconds = std::max(0.0, timeout_s);
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += static_cast<time_t>(seconds);
+            deadline.tv_nsec += static_cast<long>(
+                (seconds - static_cast<time_t>(seconds)) * 1e9);
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            deadline_ptr = &deadline;
+        }
+
+        FutexWaitv waiters[MAX_WAIT_ANY] = {};
+        for (size_t i = 0; i < doorbells.size(); i++)
+        {
+            waiters[i].value = sequences[i];
+            waiters[i].address =
+                reinterpret_cast<uintptr_t>(&doorbells[i]->state_->sequence);
+            // not private, as the memory may be shared between processes
+            waiters[i].flags = FUTEX_SIZE_32;
+            doorbells[i]->state_->num_waiters.fetch_add(1);
+        }
+        long result = syscall(SYS_FUTEX_WAITV,
+                              waiters,
+                              doorbells.size(),
+                              0,
+                              deadline_ptr,
+                              CLOCK_MONOTONIC);
+        int error = errno;
+
+        if (result < 0 && error == ENOSYS)
+        {
+            // Kernel without futex_waitv.  Only the first doorbell wakes
+            // this thread up immediately, the others are noticed with up to
+            // 1 ms delay.
+            const auto start = std::chrono::steady_clock::now();
+            while (!is_rung())
+            {
+                const double elapsed =
+                    std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+                if (elapsed >= timeout_s)
+                {
+                    break;
+                }
+                doorbells[0]->wait(sequences[0],
+                                   std::min(1e-3, timeout_s - elapsed));
+            }
+            result = 0;
+        }
+
+        for (Doorbell *doorbell : doorbells)
+        {
+            doorbell->state_->num_waiters.fetch_sub(1);
+        }
+
+        if (result >= 0 || error == EAGAIN || error == EINTR ||
+            error == ETIMEDOUT)
+        {
+            return is_rung();
+        }
+        throw std::runtime_error(std::string("futex_waitv failed: ") +
+                                 std::strerror(error));
+    }
+
+private:
+    //! @brief Maximum number of doorbells for wait_any().
+    static constexpr size_t MAX_WAIT_ANY = 128;
+    static constexpr uint32_t FUTEX_SIZE_32 = 2;
+    static constexpr long SYS_FUTEX_WAITV = 449;
+
+    //! @brief Same layout as `struct futex_waitv` of newer kernel headers.
+    struct FutexWaitv
+    {
+        uint64_t value;
+        uint64_t address;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+
+    //! @brief Data shared between the processes.
+    struct State
+    {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<uint32_t> num_waiters{0};
+    };
+    static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                  "Doorbell requires lock-free 32 bit atomics.");
+
+    // zero-initialised shared memory is a valid State
+    SharedMemorySegment<State> state_;
+
+    Doorbell(const std::string &shared_memory_id, bool is_leader)
+        : state_(shared_memory_id, is_leader)
+    {
+    }
+
+    long futex(int operation, uint32_t value, struct timespec *timeout) const
+    {
+        // not FUTEX_PRIVATE_FLAG, as the memory may be shared between
+        // processes
+        return syscall(SYS_futex,
+                       reinterpret_cast<uint32_t *>(&state_->sequence),
+                       operation,
+                       value,
+                       timeout,
+                       nullptr,
+                       0);
+    }
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,307 @@
+/**
+ * @file
+ * @brief Driver wrapper that injects timing faults and errors for testing.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <robot_interfaces/robot_driver.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Distribution of an artificial delay.
+ *
+ * Use the static factory functions to create one.  The default does not add
+ * any delay.
+ */
+struct LatencyDistribution
+{
+    enum class Type
+    {
+        NONE,
+        CONSTANT,
+        UNIFORM,
+        NORMAL,
+        EXPONENTIAL
+    };
+
+    Type type = Type::NONE;
+    //! @brief Constant value, minimum (uniform) or mean (normal, exponential).
+    double a_s = 0;
+    //! @brief Maximum (uniform) or standard deviation (normal).
+    double b_s = 0;
+
+    static LatencyDistribution constant(double latency_s)
+    {
+        return LatencyDistribution{Type::CONSTANT, latency_s, 0};
+    }
+
+    static LatencyDistribution uniform(double min_s, double max_s)
+    {
+        return LatencyDistribution{Type::UNIFORM, min_s, max_s};
+    }
+
+    //! @brief Normal distribution, negative samples are clipped to zero.
+    static LatencyDistribution normal(double mean_s, double stddev_s)
+    {
+        return LatencyDistribution{Type::NORMAL, mean_s, stddev_s};
+    }
+
+    //! @brief Exponential distribution (long tail of rare, large delays).
+    static LatencyDistribution exponential(double mean_s)
+    {
+        return LatencyDistribution{Type::EXPONENTIAL, mean_s, 0};
+    }
+
+    //! @brief Draw a delay in seconds.
+    template <typename RandomEngine>
+    double sample(RandomEngine &engine) const
+    {
+        switch (type)
+        {
+            case Type::CONSTANT:
+                return a_s;
+            case Type::UNIFORM:
+                return std::uniform_real_distribution<double>(a_s,
+                                                              b_s)(engine);
+            case Type::NORMAL:
+                return std::max(
+                    0.0, std::normal_distribution<double>(a_s, b_s)(engine));
+            case Type::EXPONENTIAL:
+                return a_s > 0 ? std::exponential_distribution<double>(
+                                     1.0 / a_s)(engine)
+                               : 0.0;
+            default:
+                return 0.0;
+        }
+    }
+};
+
+/**
+ * @brief Configuration of FaultInjectingRobotDriver.
+ *
+ * All faults are disabled by default.
+ */
+struct FaultInjectionConfig
+{
+    //! @brief Delay added to each call of apply_action().
+    LatencyDistribution apply_action_latency;
+    //! @brief Delay added to each call of get_latest_observation().
+    LatencyDistribution get_observation_latency;
+
+    //! @brief Probability of a stall in a call of apply_action().
+    double stall_probability = 0;
+    //! @brief Duration of a stall.
+    double stall_duration_s = 0;
+
+    //! @brief Probability that get_error() starts reporting an error.
+    double error_probability = 0;
+    //! @brief Report an error after this many actions (0 = never).
+    uint64_t error_after_num_actions = 0;
+    //! @brief Message of injected errors.
+    std::string error_message = "Injected error.";
+
+    /**
+     * @brief Number of background threads generating CPU load.
+     *
+     * They run with normal priority and compete with the other threads of the
+     * process/machine for CPU time and caches.
+     */
+    unsigned num_load_threads = 0;
+    //! @brief Fraction of time in which the load threads are busy.
+    double load_duty_cycle = 1.0;
+
+    //! @brief Seed for the random number generator.
+    uint64_t seed = 0;
+};
+
+/**
+ * @brief Wrapper for RobotDriver that injects delays, stalls and errors.
+ *
+ * Forwards all calls to the given driver, like MonitoredRobotDriver.  Before
+ * forwarding, delays drawn from the configured distributions and occasional
+ * stalls are added, and get_error() reports errors at random or after a fixed
+ * number of actions.  Optionally, background threads generate CPU load.
+ *
+ * This makes it possible to reproduce the timing failures the backend guards
+ * against (e.g. actions that are not provided in time, or timeouts of
+ * MonitoredRobotDriver) and to find out on a given machine how much jitter a
+ * control rate and action repetition setting tolerates (see the soak
+ * benchmark).  Not meant for use with real robots.
+ *
+ * @tparam Driver  Type of the wrapped driver.
+ */
+template <typename Driver>
+class FaultInjectingRobotDriver
+    : public RobotDriver<typename Driver::Action, typename Driver::Observation>
+{
+public:
+    typedef std::shared_ptr<Driver> RobotDriverPtr;
+
+    FaultInjectingRobotDriver(RobotDriverPtr robot_driver,
+                              const FaultInjectionConfig &config)
+        : robot_driver_(robot_driver),
+          config_(config),
+          random_engine_(config.seed),
+          num_actions_(0),
+          num_stalls_(0),
+          has_error_(false),
+          is_load_running_(true)
+    {
+        for (unsigned i = 0; i < config_.num_load_threads; i++)
+        {
+            load_threads_.emplace_back(
+                &FaultInjectingRobotDriver::generate_load, this);
+        }
+    }
+
+    ~FaultInjectingRobotDriver()
+    {
+        is_load_running_ = false;
+        for (std::thread &thread : load_threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void initialize() override
+    {
+        robot_driver_->initialize();
+    }
+
+    typename Driver::Action apply_action(
+        const typename Driver::Action &desired_action) override
+    {
+        double delay_s;
+        {
+            std::lock_guard<std::mutex> lock(random_mutex_);
+            delay_s = config_.apply_action_latency.sample(random_engine_);
+            if (config_.stall_probability > 0 &&
+                std::bernoulli_distribution(config_.stall_probability)(
+                    random_engine_))
+            {
+                delay_s += config_.stall_duration_s;
+                num_stalls_++;
+            }
+        }
+        delay(delay_s);
+
+        num_actions_++;
+        return robot_driver_->apply_action(desired_action);
+    }
+
+    typename Driver::Observation get_latest_observation() override
+    {
+        double delay_s;
+        {
+            std::lock_guard<std::mutex> lock(random_mutex_);
+            delay_s = config_.get_observation_latency.sample(random_engine_);
+        }
+        delay(delay_s);
+
+        return robot_driver_->get_latest_observation();
+    }
+
+    std::string get_error() override
+    {
+        if (!has_error_)
+        {
+            std::lock_guard<std::mutex> lock(random_mutex_);
+            if (config_.error_after_num_actions > 0 &&
+                num_actions_ >= config_.error_after_num_actions)
+            {
+                has_error_ = true;
+            }
+            else if (config_.error_probability > 0 &&
+                     std::bernoulli_distribution(config_.error_probability)(
+                         random_engine_))
+            {
+                has_error_ = true;
+            }
+        }
+
+        if (has_error_)
+        {
+            return config_.error_message;
+        }
+        return robot_driver_->get_error();
+    }
+
+    void shutdown() override
+    {
+        robot_driver_->shutdown();
+    }
+
+    //! @brief Number of actions applied so far.
+    uint64_t get_number_of_actions() const
+    {
+        return num_actions_;
+    }
+
+    //! @brief Number of stalls injected so far.
+    uint64_t get_number_of_stalls() const
+    {
+        return num_stalls_;
+    }
+
+private:
+    RobotDriverPtr robot_driver_;
+    FaultInjectionConfig config_;
+
+    std::mutex random_mutex_;
+    std::mt19937_64 random_engine_;
+
+    std::atomic<uint64_t> num_actions_;
+    std::atomic<uint64_t> num_stalls_;
+    std::atomic<bool> has_error_;
+
+    std::atomic<bool> is_load_running_;
+    std::vector<std::thread> load_threads_;
+
+    static void delay(double delay_s)
+    {
+        if (delay_s > 0)
+        {
+            std::this_thread::sleep_for(
+                std::chrono::duration<double>(delay_s));
+        }
+    }
+
+    //! @brief Busy loop for load_duty_cycle of each millisecond.
+    void generate_load()
+    {
+        const auto period = std::chrono::milliseconds(1);
+        const auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            period * std::min(1.0, std::max(0.0, config_.load_duty_cycle)));
+
+        volatile uint64_t sink = 0;
+        while (is_load_running_)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            while (std::chrono::steady_clock::now() - start < busy)
+            {
+                sink = sink + 1;
+            }
+            if (busy < period)
+            {
+                std::this_thread::sleep_until(start + period);
+            }
+        }
+    }
+};
+
+}  // namespace robot_interfaces
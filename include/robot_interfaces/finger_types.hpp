@@ -9,6 +9,8 @@
 #pragma once
 
 #include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/padded_n_finger_observation.hpp>
+#include <robot_interfaces/padded_n_joint_action.hpp>
 
 namespace robot_interfaces
 {
@@ -17,11 +19,15 @@ constexpr size_t BOARDS_PER_FINGER = 2;
 
 /**
  * @brief Types for the Finger robot (basic 3-joint robot).
+ *
+ * @tparam N_FINGERS Number of fingers.
+ * @tparam Scalar Scalar type of actions and observations.
  */
-template <size_t N_FINGERS>
+template <size_t N_FINGERS, typename Scalar = double>
 struct FingerTypes
-    : public RobotInterfaceTypes<NJointAction<N_FINGERS * JOINTS_PER_FINGER>,
-                                 NFingerObservation<N_FINGERS>>
+    : public RobotInterfaceTypes<
+          NJointAction<N_FINGERS * JOINTS_PER_FINGER, Scalar>,
+          NFingerObservation<N_FINGERS, Scalar>>
 {
 };
 
@@ -29,4 +35,27 @@ struct FingerTypes
 typedef FingerTypes<1> MonoFingerTypes;
 typedef FingerTypes<3> TriFingerTypes;
 
+// single precision variants
+typedef FingerTypes<1, float> MonoFingerTypesF;
+typedef FingerTypes<3, float> TriFingerTypesF;
+
+/**
+ * @brief Types for the Finger robot with padded, SIMD-friendly layout.
+ *
+ * Same as FingerTypes but using PaddedNJointAction and
+ * PaddedNFingerObservation.
+ *
+ * @tparam N_FINGERS Number of fingers.
+ * @tparam Scalar Scalar type of actions and observations.
+ */
+template <size_t N_FINGERS, typename Scalar = double>
+struct PaddedFingerTypes
+    : public RobotInterfaceTypes<
+          PaddedNJointAction<N_FINGERS * JOINTS_PER_FINGER, Scalar>,
+          PaddedNFingerObservation<N_FINGERS, Scalar>>
+{
+};
+
+typedef PaddedFingerTypes<3> TriFingerPaddedTypes;
+
 }  // namespace robot_interfaces
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief Frontend that steps a lockstep backend in the calling thread.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <robot_interfaces/robot_backend.hpp>
+#include <robot_interfaces/robot_data.hpp>
+#include <robot_interfaces/robot_frontend.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief RobotFrontend that executes the backend steps synchronously.
+ *
+ * To be used with a RobotBackend in lockstep mode (see
+ * RobotBackend::LockstepMode).  Each call of append_desired_action() directly
+ * runs the corresponding backend step in the calling thread, i.e. when it
+ * returns, the action is applied and observation and status of the next time
+ * step are available.  Apart from that, the data is the same as for a
+ * non-real-time backend, so code using the normal RobotFrontend interface
+ * works without changes.  The append methods are virtual in RobotFrontend, so
+ * this also holds when the frontend is used via a RobotFrontend reference or
+ * pointer.
+ *
+ * Since there is no thread handoff, this allows to run many simulated robots
+ * in a single thread, e.g. for generating training data.
+ *
+ * Note that, as nothing happens in the background, methods waiting for a time
+ * step that is not reached yet (e.g. get_observation(t + 2) after appending
+ * action t) block forever.
+ */
+template <typename Action, typename Observation>
+class LockstepRobotFrontend : public RobotFrontend<Action, Observation>
+{
+public:
+    typedef RobotBackend<Action, Observation> Backend;
+
+    /**
+     * @param robot_data  Data shared with the backend.
+     * @param backend  Backend in lockstep mode using robot_data.
+     */
+    LockstepRobotFrontend(
+        std::shared_ptr<RobotData<Action, Observation>> robot_data,
+        std::shared_ptr<Backend> backend)
+        : RobotFrontend<Action, Observation>(robot_data), backend_(backend)
+    {
+        if (!backend_->is_lockstep())
+        {
+            throw std::invalid_argument(
+                "LockstepRobotFrontend requires a backend in lockstep mode.");
+        }
+    }
+
+    /**
+     * @brief Append a desired action and execute the backend step.
+     *
+     * See RobotFrontend::append_desired_action().  After the action is
+     * appended, all pending steps of the backend are executed.
+     *
+     * @return Time step at which the action was applied.
+     */
+    TimeIndex append_desired_action(const Action &desired_action) override
+    {
+        TimeIndex t =
+            RobotFrontend<Action, Observation>::append_desired_action(
+                desired_action);
+        backend_->step();
+        return t;
+    }
+
+    /**
+     * @brief Submit a trajectory and execute the backend steps.
+     *
+     * See RobotFrontend::append_desired_trajectory().  As there is no
+     * background thread, all actions of the trajectory are executed before
+     * this returns.  The trajectory must not be longer than the history of
+     * robot_data.
+     *
+     * @return Time step of the last action.
+     */
+    TimeIndex append_desired_trajectory(const std::vector<Action> &actions,
+                                        TimeIndex start_timeindex) override
+    {
+        if (actions.size() > this->robot_data_->trajectory->max_length())
+        {
+            throw std::invalid_argument(
+                "Trajectory is longer than the history of the robot data.");
+        }
+        TimeIndex t =
+            RobotFrontend<Action, Observation>::append_desired_trajectory(
+                actions, start_timeindex);
+        backend_->step();
+        return t;
+    }
+
+    // the overload without start time index calls the one above
+    using RobotFrontend<Action, Observation>::append_desired_trajectory;
+
+    //! @brief Get the backend.
+    std::shared_ptr<Backend> get_backend() const
+    {
+        return backend_;
+    }
+
+private:
+    std::shared_ptr<Backend> backend_;
+};
+
+}  // namespace robot_interfaces
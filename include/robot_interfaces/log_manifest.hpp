@@ -0,0 +1,202 @@
+/**
+ * @file
+ * @brief Manifest describing the segments of a segmented log.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Segment of a segmented log.
+ */
+struct LogSegment
+{
+    //! @brief Time index of the first time step in the segment.
+    long int start_timeindex;
+    /**
+     * @brief Time index after the last time step in the segment (exclusive).
+     *
+     * Set to -1 for the segment which is currently being written.
+     */
+    long int end_timeindex;
+    //! @brief File name of the segment (relative to the manifest).
+    std::string filename;
+};
+
+/**
+ * @brief Manifest listing the segments of a segmented log.
+ *
+ * When logging continuously for a long time, the log is split into several
+ * files ("segments").  Each segment is a complete log file on its own (i.e.
+ * has its own header) and is named after the time index of its first time
+ * step.  The manifest is a small text file listing all segments in order:
+ *
+ * @verbatim
+   # robot_interfaces log manifest
+   format columnar
+   0 100000 robot_000000000000.col
+   100000 -1 robot_000000100000.col
+   @endverbatim
+ *
+ * The manifest is rewritten whenever a segment is started or completed.
+ * Readers that support segmented logs (e.g. ColumnarLogReader and
+ * SensorLogReader) accept the path to the manifest instead of a single log
+ * file and present all segments as one continuous log.
+ */
+class LogManifest
+{
+public:
+    //! @brief First line of each manifest file.
+    static constexpr const char *HEADER = "# robot_interfaces log manifest";
+
+    //! @brief Format of the segment files (e.g. "text" or "columnar").
+    std::string format;
+
+    //! @brief The segments in chronological order.
+    std::vector<LogSegment> segments;
+
+    //! @brief Get the path of the manifest of a log with the given prefix.
+    static std::string get_manifest_path(const std::string &prefix)
+    {
+        return prefix + ".manifest";
+    }
+
+    /**
+     * @brief Construct the file name of a segment.
+     *
+     * @param prefix  Path prefix of the segmented log.
+     * @param start_timeindex  Time index of the first step in the segment.
+     * @param extension  File extension (including the dot).
+     */
+    static std::string get_segment_path(const std::string &prefix,
+                                        long int start_timeindex,
+                                        const std::string &extension)
+    {
+        std::ostringstream path;
+        path << prefix << "_" << std::setw(12) << std::setfill('0')
+             << start_timeindex << extension;
+        return path.str();
+    }
+
+    //! @brief Check if the given file is a log manifest.
+    static bool is_manifest(const std::string &filename)
+    {
+        std::ifstream file(filename);
+        std::string first_line;
+        return file && std::getline(file, first_line) && first_line == HEADER;
+    }
+
+    /**
+     * @brief Read a manifest file.
+     *
+     * @param filename  Path to the manifest file.
+     * @return The manifest.
+     */
+    static LogManifest read(const std::string &filename)
+    {
+        std::ifstream file(filename);
+        std::string line;
+        if (!file || !std::getline(file, line) || line != HEADER)
+        {
+            throw std::runtime_error(filename + " is not a log manifest.");
+        }
+
+        LogManifest manifest;
+        std::string key;
+        if (!(file >> key >> manifest.format) || key != "format")
+        {
+            throw std::runtime_error("Invalid log manifest " + filename);
+        }
+
+        LogSegment segment;
+        while (file >> segment.start_timeindex >> segment.end_timeindex >>
+               segment.filename)
+        {
+            manifest.segments.push_back(segment);
+        }
+
+        return manifest;
+    }
+
+    /**
+     * @brief Write the manifest to a file.
+     *
+     * The manifest is first written to a temporary file which is then renamed,
+     * so readers never see an incomplete manifest.
+     *
+     * @param filename  Path to the manifest file.
+     */
+    void write(const std::string &filename) const
+    {
+        const std::string tmp_filename = filename + ".tmp";
+        {
+            std::ofstream file(tmp_filename, std::ios::trunc);
+            if (!file)
+            {
+                throw std::runtime_error("Failed to open file " +
+                                         tmp_filename);
+            }
+
+            file << HEADER << "\n";
+            file << "format " << format << "\n";
+            for (const LogSegment &segment : segments)
+            {
+                file << segment.start_timeindex << " " << segment.end_timeindex
+                     << " " << segment.filename << "\n";
+            }
+        }
+
+        if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+        {
+            throw std::runtime_error("Failed to write " + filename);
+        }
+    }
+
+    /**
+     * @brief Get the paths of all segment files.
+     *
+     * @param manifest_path  Path of the manifest file.  Segment file names are
+     *     relative to its directory.
+     */
+    std::vector<std::string> get_segment_paths(
+        const std::string &manifest_path) const
+    {
+        std::string directory;
+        const size_t separator = manifest_path.find_last_of('/');
+        if (separator != std::string::npos)
+        {
+            directory = manifest_path.substr(0, separator + 1);
+        }
+
+        std::vector<std::string> paths;
+        for (const LogSegment &segment : segments)
+        {
+            paths.push_back(directory + segment.filename);
+        }
+        return paths;
+    }
+
+    /**
+     * @brief Get the file name of a path (i.e. strip the directory).
+     *
+     * Used to store segment file names relative to the manifest.
+     */
+    static std::string get_filename(const std::string &path)
+    {
+        const size_t separator = path.find_last_of('/');
+        return separator == std::string::npos ? path
+                                              : path.substr(separator + 1);
+    }
+};
+
+}  // namespace robot_interfaces
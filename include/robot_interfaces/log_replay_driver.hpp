@@ -0,0 +1,152 @@
+/**
+ * @file
+ * @brief Robot driver that replays observations from a robot log.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <robot_interfaces/replay_clock.hpp>
+#include <robot_interfaces/robot_driver.hpp>
+#include <robot_interfaces/robot_log_entry.hpp>
+#include <robot_interfaces/robot_log_reader.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Driver that replays the observations of a recorded robot log.
+ *
+ * Instead of communicating with a robot, the observations of a log (as read
+ * by RobotBinaryLogReader) are returned one after another.  This allows to
+ * run controllers and the whole frontend/backend/logger pipeline on recorded
+ * data, e.g. for regression tests or benchmarks without hardware.
+ *
+ * The timing is controlled by the ReplayMode:  Observations can be provided
+ * with the timing of the recording (optionally scaled) or as fast as possible.
+ * For deterministic runs use ReplayMode::AS_FAST_AS_POSSIBLE together with a
+ * backend in non-real-time mode (so the backend waits for each action instead
+ * of repeating actions).
+ *
+ * Actions are not applied anywhere, apply_action() simply returns the desired
+ * action.  The recorded actions can be accessed via get_log_entry() to
+ * compare them with the ones sent by the controller.
+ *
+ * The length of the log is known up front, so to shut down the backend
+ * cleanly at the end of the log, create it with max_number_of_actions set to
+ * size().  It then terminates with
+ * TerminationReason::MAXIMUM_NUMBER_OF_ACTIONS_REACHED.  Without this limit,
+ * the last observation is repeated after the end of the log (see
+ * is_finished()).  Reaching the end of the log is not reported as error.
+ */
+template <typename Action, typename Observation>
+class LogReplayDriver : public RobotDriver<Action, Observation>
+{
+public:
+    typedef RobotLogEntry<Action, Observation> LogEntry;
+
+    /**
+     * @param log_entries  Recorded log entries that are replayed.
+     * @param mode  Timing of the replay.
+     * @param speed  Speed factor for ReplayMode::SCALED_TIME.
+     */
+    LogReplayDriver(const std::vector<LogEntry> &log_entries,
+                    ReplayMode mode = ReplayMode::REAL_TIME,
+                    double speed = 1.0)
+        : log_entries_(log_entries), clock_(mode, speed), index_(0)
+    {
+    }
+
+    /**
+     * @param log_file  Path to a binary robot log file (see
+     *     RobotBinaryLogReader).
+     * @param mode  Timing of the replay.
+     * @param speed  Speed factor for ReplayMode::SCALED_TIME.
+     */
+    LogReplayDriver(const std::string &log_file,
+                    ReplayMode mode = ReplayMode::REAL_TIME,
+                    double speed = 1.0)
+        : LogReplayDriver(
+              RobotBinaryLogReader<Action, Observation>(log_file).data,
+              mode,
+              speed)
+    {
+    }
+
+    //! @brief Restart the replay from the beginning of the log.
+    void initialize() override
+    {
+        index_ = 0;
+        clock_.reset();
+    }
+
+    Action apply_action(const Action &desired_action) override
+    {
+        index_++;
+        return desired_action;
+    }
+
+    /**
+     * @brief Return the observation of the current step of the log.
+     *
+     * Blocks until the time of the step is reached (depending on the replay
+     * mode).  After the end of the log, the last observation is returned.
+     */
+    Observation get_latest_observation() override
+    {
+        if (log_entries_.empty())
+        {
+            return Observation();
+        }
+
+        const LogEntry &entry =
+            log_entries_[std::min<size_t>(index_, size() - 1)];
+        clock_.wait_until(entry.timestamp);
+        return entry.observation;
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+
+    //! @brief Get the number of steps in the log.
+    size_t size() const
+    {
+        return log_entries_.size();
+    }
+
+    //! @brief Check if all steps of the log have been replayed.
+    bool is_finished() const
+    {
+        return index_ >= log_entries_.size();
+    }
+
+    //! @brief Get the index of the step that is currently replayed.
+    size_t get_current_index() const
+    {
+        return index_;
+    }
+
+    //! @brief Get the recorded log entry of the given step.
+    const LogEntry &get_log_entry(size_t index) const
+    {
+        return log_entries_.at(index);
+    }
+
+private:
+    std::vector<LogEntry> log_entries_;
+    ReplayClock clock_;
+    //! @brief Index of the current step (atomic as it is polled by users).
+    std::atomic<size_t> index_;
+};
+
+}  // namespace robot_interfaces
@@ -8,6 +8,11 @@
 
 #pragma once
 
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace robot_interfaces
 {
 /*
@@ -31,4 +36,29 @@ public:
     virtual std::vector<std::vector<double>> get_data() = 0;
 };
 
+/**
+ * @brief Check if T provides the methods of Loggable.
+ *
+ * This is the case for all types derived from Loggable but also for types which
+ * implement get_name() and get_data() without deriving from it (e.g. to avoid
+ * the vtable pointer in types that are meant to be tightly packed).
+ */
+template <typename T, typename = void>
+struct is_loggable : std::false_type
+{
+};
+
+template <typename T>
+struct is_loggable<T,
+                   std::void_t<decltype(std::declval<T &>().get_name()),
+                               decltype(std::declval<T &>().get_data())>>
+    : std::integral_constant<
+          bool,
+          std::is_convertible<decltype(std::declval<T &>().get_name()),
+                              std::vector<std::string>>::value &&
+              std::is_convertible<decltype(std::declval<T &>().get_data()),
+                                  std::vector<std::vector<double>>>::value>
+{
+};
+
 }  // namespace robot_interfaces
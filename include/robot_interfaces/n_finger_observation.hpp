@@ -36,15 +36,17 @@ namespace robot_interfaces
  *     #. Finger n, lower joint
  *
  * @tparam N_FINGERS  Number of fingers.
+ * @tparam Scalar_t Scalar type of the values.
  */
-template <size_t N_FINGERS>
+template <size_t N_FINGERS, typename Scalar_t = double>
 struct NFingerObservation : public Loggable
 {
     static constexpr size_t num_fingers = N_FINGERS;
     static constexpr size_t num_joints = N_FINGERS * 3;
 
-    typedef Eigen::Matrix<double, num_joints, 1> JointVector;
-    typedef Eigen::Matrix<double, num_fingers, 1> FingerVector;
+    typedef Scalar_t Scalar;
+    typedef Eigen::Matrix<Scalar, num_joints, 1> JointVector;
+    typedef Eigen::Matrix<Scalar, num_fingers, 1> FingerVector;
 
     //! @brief Measured angular position of all joints in radian.
     JointVector position = JointVector::Zero();
@@ -84,10 +86,17 @@ struct NFingerObservation : public Loggable
                                     vecd(torque.size()),
                                     vecd(tip_force.size())};
 
-        JointVector::Map(&result[0][0], position.size()) = position;
-        JointVector::Map(&result[1][0], velocity.size()) = velocity;
-        JointVector::Map(&result[2][0], torque.size()) = torque;
-        FingerVector::Map(&result[3][0], tip_force.size()) = tip_force;
+        typedef Eigen::Matrix<double, num_joints, 1> JointVectorD;
+        typedef Eigen::Matrix<double, num_fingers, 1> FingerVectorD;
+
+        JointVectorD::Map(&result[0][0], position.size()) =
+            position.template cast<double>();
+        JointVectorD::Map(&result[1][0], velocity.size()) =
+            velocity.template cast<double>();
+        JointVectorD::Map(&result[2][0], torque.size()) =
+            torque.template cast<double>();
+        FingerVectorD::Map(&result[3][0], tip_force.size()) =
+            tip_force.template cast<double>();
 
         return result;
     }
@@ -24,14 +24,17 @@ namespace robot_interfaces
  * position commands on joint-level.
  *
  * @tparam N Number of joints.
+ * @tparam Scalar_t Scalar type of the values (e.g. float to avoid
+ *     conversions in drivers and policies that work in single precision).
  */
-template <size_t N>
+template <size_t N, typename Scalar_t = double>
 struct NJointAction : public Loggable
 {
     //! @brief Number of joints.
     static constexpr size_t num_joints = N;
 
-    typedef Eigen::Matrix<double, N, 1> Vector;
+    typedef Scalar_t Scalar;
+    typedef Eigen::Matrix<Scalar, N, 1> Vector;
 
     //! Desired torque command (in addition to position controller).
     Vector torque;
@@ -55,22 +58,28 @@ struct NJointAction : public Loggable
 
     std::vector<std::vector<double>> get_data() override
     {
+        typedef Eigen::Matrix<double, N, 1> VectorD;
+
         // first map the Eigen vectors to std::vectors
         std::vector<double> torque_;
         torque_.resize(torque.size());
-        Vector::Map(&torque_[0], torque.size()) = torque;
+        VectorD::Map(&torque_[0], torque.size()) =
+            torque.template cast<double>();
 
         std::vector<double> position_;
         position_.resize(position.size());
-        Vector::Map(&position_[0], position.size()) = position;
+        VectorD::Map(&position_[0], position.size()) =
+            position.template cast<double>();
 
         std::vector<double> position_kp_;
         position_kp_.resize(position_kp.size());
-        Vector::Map(&position_kp_[0], position_kp.size()) = position_kp;
+        VectorD::Map(&position_kp_[0], position_kp.size()) =
+            position_kp.template cast<double>();
 
         std::vector<double> position_kd_;
         position_kd_.resize(position_kd.size());
-        Vector::Map(&position_kd_[0], position_kd.size()) = position_kd;
+        VectorD::Map(&position_kd_[0], position_kd.size()) =
+            position_kd.template cast<double>();
 
         // then return them in a fixed size vector of vectors to avoid
         // copying due to pushing back value of information!
@@ -192,7 +201,7 @@ struct NJointAction : public Loggable
      */
     static Vector None()
     {
-        return Vector::Constant(std::numeric_limits<double>::quiet_NaN());
+        return Vector::Constant(std::numeric_limits<Scalar>::quiet_NaN());
     }
 };
 
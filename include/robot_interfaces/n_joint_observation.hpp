@@ -22,14 +22,16 @@ namespace robot_interfaces
  * Simple observation type with position, velocity and torque for each joint.
  *
  * @tparam N Number of joints.
+ * @tparam Scalar_t Scalar type of the values.
  */
-template <size_t N>
+template <size_t N, typename Scalar_t = double>
 struct NJointObservation : public Loggable
 {
     //! @brief Number of joints.
     static constexpr size_t num_joints = N;
 
-    typedef Eigen::Matrix<double, N, 1> Vector;
+    typedef Scalar_t Scalar;
+    typedef Eigen::Matrix<Scalar, N, 1> Vector;
 
     Vector position = Vector::Zero();
     Vector velocity = Vector::Zero();
@@ -53,9 +55,13 @@ struct NJointObservation : public Loggable
         std::vector<vecd> result = {
             vecd(position.size()), vecd(velocity.size()), vecd(torque.size())};
 
-        Vector::Map(&result[0][0], position.size()) = position;
-        Vector::Map(&result[1][0], velocity.size()) = velocity;
-        Vector::Map(&result[2][0], torque.size()) = torque;
+        typedef Eigen::Matrix<double, N, 1> VectorD;
+        VectorD::Map(&result[0][0], position.size()) =
+            position.template cast<double>();
+        VectorD::Map(&result[1][0], velocity.size()) =
+            velocity.template cast<double>();
+        VectorD::Map(&result[2][0], torque.size()) =
+            torque.template cast<double>();
 
         return result;
     }
@@ -21,11 +21,17 @@ namespace robot_interfaces
  * provides N observations containing measured joint angle, velocity and torque.
  *
  * @tparam N Number of joints
+ * @tparam Scalar Scalar type of actions and observations.
  */
-template <size_t N>
+template <size_t N, typename Scalar = double>
 struct SimpleNJointRobotTypes
-    : public RobotInterfaceTypes<NJointAction<N>, NJointObservation<N>>
+    : public RobotInterfaceTypes<NJointAction<N, Scalar>,
+                                 NJointObservation<N, Scalar>>
 {
 };
 
+//! @brief SimpleNJointRobotTypes with single precision values.
+template <size_t N>
+using SimpleNJointRobotTypesF = SimpleNJointRobotTypes<N, float>;
+
 }  // namespace robot_interfaces
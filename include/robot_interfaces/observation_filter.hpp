@@ -0,0 +1,283 @@
+/**
+ * @file
+ * @brief Filters applied by the backend to the observations of the driver.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Processing stage between driver and robot data for observations.
+ *
+ * If set (see RobotBackend::set_observation_filter()), the backend passes each
+ * observation it gets from the driver through the filter before appending it
+ * to the robot data.  This way, quantities like filtered velocities are
+ * computed once in the backend instead of by every reader of the
+ * observations.
+ *
+ * Filters run in the real-time loop, so they have to be of bounded cost and
+ * must not allocate memory in filter().
+ *
+ * @tparam Observation
+ */
+template <typename Observation>
+class ObservationFilter
+{
+public:
+    virtual ~ObservationFilter()
+    {
+    }
+
+    /**
+     * @brief Filter the observation in place.
+     *
+     * @param observation  The observation returned by the driver.  Modified
+     *     in place.
+     * @param time_s  Time at which the observation was acquired [s].  Only
+     *     differences between calls are meaningful.  In lockstep mode, this
+     *     is the time of the step (see RobotBackend::LockstepMode).
+     */
+    virtual void filter(Observation &observation, double time_s) = 0;
+};
+
+/**
+ * @brief Apply several filters one after the other.
+ */
+template <typename Observation>
+class ObservationFilterPipeline : public ObservationFilter<Observation>
+{
+public:
+    typedef std::shared_ptr<ObservationFilter<Observation>> FilterPtr;
+
+    //! @brief Append a filter.  Must not be called once the backend runs.
+    void add(FilterPtr filter)
+    {
+        if (!filter)
+        {
+            throw std::invalid_argument("Filter must not be null.");
+        }
+        filters_.push_back(filter);
+    }
+
+    void filter(Observation &observation, double time_s) override
+    {
+        for (auto &filter : filters_)
+        {
+            filter->filter(observation, time_s);
+        }
+    }
+
+private:
+    std::vector<FilterPtr> filters_;
+};
+
+/**
+ * @brief First-order low-pass filter of one field.
+ *
+ * output = output + alpha * (input - output) with alpha depending on the time
+ * since the previous observation, so the cut-off frequency does not depend on
+ * the control rate.  Input and output may be the same field (filtering in
+ * place) or different fields (if the observation type has a field for the
+ * filtered value).
+ *
+ * @tparam Observation
+ * @tparam Field  Type of the field (an Eigen vector).
+ */
+template <typename Observation, typename Field = typename Observation::Vector>
+class LowPassObservationFilter : public ObservationFilter<Observation>
+{
+public:
+    typedef typename Field::Scalar Scalar;
+
+    /**
+     * @param input  Field that is filtered.
+     * @param output  Field to which the result is written.
+     * @param cutoff_frequency_hz  Cut-off frequency of the filter.
+     */
+    LowPassObservationFilter(Field Observation::*input,
+                             Field Observation::*output,
+                             double cutoff_frequency_hz)
+        : input_(input),
+          output_(output),
+          time_constant_s_(1.0 / (2.0 * M_PI * cutoff_frequency_hz))
+    {
+        if (!(cutoff_frequency_hz > 0))
+        {
+            throw std::invalid_argument(
+                "Cut-off frequency must be positive.");
+        }
+    }
+
+    void filter(Observation &observation, double time_s) override
+    {
+        if (!is_initialized_)
+        {
+            state_ = observation.*input_;
+            is_initialized_ = true;
+        }
+        else
+        {
+            const double dt = std::max(0.0, time_s - last_time_s_);
+            const double alpha = dt / (dt + time_constant_s_);
+            state_ += static_cast<Scalar>(alpha) *
+                      (observation.*input_ - state_);
+        }
+        last_time_s_ = time_s;
+        observation.*output_ = state_;
+    }
+
+private:
+    Field Observation::*input_;
+    Field Observation::*output_;
+    double time_constant_s_;
+    Field state_;
+    double last_time_s_ = 0;
+    bool is_initialized_ = false;
+};
+
+/**
+ * @brief Moving average of one field over a fixed number of observations.
+ *
+ * The window is preallocated, the average is updated with a running sum
+ * which is recomputed from the window once per pass through it.
+ *
+ * @tparam Observation
+ * @tparam Field  Type of the field (an Eigen vector).
+ */
+template <typename Observation, typename Field = typename Observation::Vector>
+class MovingAverageObservationFilter : public ObservationFilter<Observation>
+{
+public:
+    typedef typename Field::Scalar Scalar;
+
+    /**
+     * @param input  Field that is averaged.
+     * @param output  Field to which the result is written.
+     * @param window_size  Number of observations that are averaged.
+     */
+    MovingAverageObservationFilter(Field Observation::*input,
+                                   Field Observation::*output,
+                                   size_t window_size)
+        : input_(input), output_(output), window_(window_size)
+    {
+        if (window_size == 0)
+        {
+            throw std::invalid_argument("Window size must not be zero.");
+        }
+    }
+
+    void filter(Observation &observation, double) override
+    {
+        const Field &value = observation.*input_;
+        if (num_samples_ == 0)
+        {
+            sum_ = value;
+        }
+        else if (num_samples_ < window_.size())
+        {
+            sum_ += value;
+        }
+        else
+        {
+            sum_ += value - window_[next_];
+        }
+        window_[next_] = value;
+        next_ = (next_ + 1) % window_.size();
+        num_samples_ = std::min(num_samples_ + 1, window_.size());
+
+        // recompute the sum once per pass through the window, so rounding
+        // errors of the running sum do not accumulate
+        if (next_ == 0)
+        {
+            sum_ = window_[0];
+            for (size_t i = 1; i < window_.size(); i++)
+            {
+                sum_ += window_[i];
+            }
+        }
+
+        observation.*output_ = sum_ / static_cast<Scalar>(num_samples_);
+    }
+
+private:
+    Field Observation::*input_;
+    Field Observation::*output_;
+    std::vector<Field> window_;
+    Field sum_;
+    size_t next_ = 0;
+    size_t num_samples_ = 0;
+};
+
+/**
+ * @brief Time derivative of one field by finite differences.
+ *
+ * output = (input - previous input) / dt, e.g. to compute velocities from
+ * positions (or accelerations from velocities, if the observation type has a
+ * field for them).  The output of the first observation is zero.  Combine
+ * with a LowPassObservationFilter on the output to reduce noise.
+ *
+ * @tparam Observation
+ * @tparam Field  Type of the field (an Eigen vector).
+ */
+template <typename Observation, typename Field = typename Observation::Vector>
+class FiniteDifferenceObservationFilter : public ObservationFilter<Observation>
+{
+public:
+    typedef typename Field::Scalar Scalar;
+
+    /**
+     * @param input  Field that is differentiated.
+     * @param output  Field to which the result is written.  Must differ from
+     *     input.
+     */
+    FiniteDifferenceObservationFilter(Field Observation::*input,
+                                      Field Observation::*output)
+        : input_(input), output_(output)
+    {
+        if (input == output)
+        {
+            throw std::invalid_argument(
+                "Input and output field must be different.");
+        }
+    }
+
+    void filter(Observation &observation, double time_s) override
+    {
+        const double dt = time_s - last_time_s_;
+        if (is_initialized_ && dt > 0)
+        {
+            derivative_ =
+                (observation.*input_ - last_value_) / static_cast<Scalar>(dt);
+        }
+        else if (!is_initialized_)
+        {
+            derivative_ = observation.*input_;
+            derivative_.setZero();
+        }
+        // for dt <= 0 the previous derivative is kept
+
+        last_value_ = observation.*input_;
+        last_time_s_ = time_s;
+        is_initialized_ = true;
+        observation.*output_ = derivative_;
+    }
+
+private:
+    Field Observation::*input_;
+    Field Observation::*output_;
+    Field last_value_;
+    Field derivative_;
+    double last_time_s_ = 0;
+    bool is_initialized_ = false;
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief Observation of a Finger robot with SIMD-friendly padded layout.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+#include <serialization_utils/cereal_eigen.hpp>
+
+#include <robot_interfaces/n_finger_observation.hpp>
+#include <robot_interfaces/padded_n_joint_action.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief NFingerObservation with vectors padded to full SIMD width.
+ *
+ * Same fields and joint order as NFingerObservation but all vectors are
+ * padded and aligned like in PaddedNJointAction (e.g. the 9 joints of the
+ * TriFinger are stored in vectors of 12 doubles).  Padding lanes are zero.
+ *
+ * Like PaddedNJointAction, this type implements the methods of Loggable
+ * without deriving from it, so it has no vtable pointer.
+ *
+ * @tparam N_FINGERS  Number of fingers.
+ * @tparam Scalar_t Scalar type of the values.
+ */
+template <size_t N_FINGERS, typename Scalar_t = double>
+struct PaddedNFingerObservation
+{
+    static constexpr size_t num_fingers = N_FINGERS;
+    static constexpr size_t num_joints = N_FINGERS * 3;
+    static constexpr size_t padded_num_joints =
+        padded_size<Scalar_t>(num_joints);
+    static constexpr size_t padded_num_fingers =
+        padded_size<Scalar_t>(num_fingers);
+
+    typedef Scalar_t Scalar;
+    //! @brief Padded joint vector, only the first num_joints are used.
+    typedef Eigen::Matrix<Scalar, padded_num_joints, 1> JointVector;
+    //! @brief Padded finger vector, only the first num_fingers are used.
+    typedef Eigen::Matrix<Scalar, padded_num_fingers, 1> FingerVector;
+    //! @brief Corresponding observation type without padding.
+    typedef NFingerObservation<N_FINGERS, Scalar> UnpaddedObservation;
+
+    //! @brief Measured angular position of all joints in radian.
+    alignas(SIMD_ALIGNMENT) JointVector position = JointVector::Zero();
+
+    //! @brief Measured velocity of all joints in radian/second.
+    alignas(SIMD_ALIGNMENT) JointVector velocity = JointVector::Zero();
+
+    //! @brief Measured torques of all joints in Nm.
+    alignas(SIMD_ALIGNMENT) JointVector torque = JointVector::Zero();
+
+    //! @brief See NFingerObservation::tip_force.
+    alignas(SIMD_ALIGNMENT) FingerVector tip_force = FingerVector::Zero();
+
+    PaddedNFingerObservation() = default;
+
+    //! @brief Create padded copy of the given observation.
+    explicit PaddedNFingerObservation(const UnpaddedObservation& observation)
+    {
+        position.template head<num_joints>() = observation.position;
+        velocity.template head<num_joints>() = observation.velocity;
+        torque.template head<num_joints>() = observation.torque;
+        tip_force.template head<num_fingers>() = observation.tip_force;
+    }
+
+    //! @brief Get copy of the observation without padding.
+    UnpaddedObservation to_unpadded() const
+    {
+        UnpaddedObservation observation;
+        observation.position = position.template head<num_joints>();
+        observation.velocity = velocity.template head<num_joints>();
+        observation.torque = torque.template head<num_joints>();
+        observation.tip_force = tip_force.template head<num_fingers>();
+        return observation;
+    }
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(position, velocity, torque, tip_force);
+    }
+
+    std::vector<std::string> get_name()
+    {
+        return {"position", "velocity", "torque", "tip_force"};
+    }
+
+    std::vector<std::vector<double>> get_data()
+    {
+        return {unpad_to_vector<num_joints>(position),
+                unpad_to_vector<num_joints>(velocity),
+                unpad_to_vector<num_joints>(torque),
+                unpad_to_vector<num_fingers>(tip_force)};
+    }
+
+private:
+    template <size_t N, typename Vector>
+    static std::vector<double> unpad_to_vector(const Vector& v)
+    {
+        std::vector<double> result(N);
+        Eigen::Matrix<double, N, 1>::Map(result.data()) =
+            v.template head<N>().template cast<double>();
+        return result;
+    }
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,185 @@
+/**
+ * @file
+ * @brief Action of a generic n-joint robot with SIMD-friendly padded layout.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+#include <serialization_utils/cereal_eigen.hpp>
+
+#include <robot_interfaces/n_joint_action.hpp>
+
+namespace robot_interfaces
+{
+//! @brief Alignment (in bytes) of the vectors of the padded types (AVX).
+constexpr size_t SIMD_ALIGNMENT = 32;
+
+/**
+ * @brief Size of a vector of n values padded to a multiple of the SIMD width.
+ *
+ * E.g. 9 joints are padded to 12 doubles or 16 floats.
+ */
+template <typename Scalar>
+constexpr size_t padded_size(size_t n)
+{
+    constexpr size_t lanes = SIMD_ALIGNMENT / sizeof(Scalar);
+    return (n + lanes - 1) / lanes * lanes;
+}
+
+/**
+ * @brief NJointAction with vectors padded to full SIMD width.
+ *
+ * Sizes like 9 joints are not vectorized well by Eigen.  In this variant, all
+ * vectors are padded to a multiple of the SIMD width and aligned accordingly,
+ * so element-wise computations (PD controller, safety checks, ...) on the full
+ * vectors can use full-width SIMD instructions.  The padding lanes are zero,
+ * so element-wise products and sums leave them at zero; only the first N
+ * elements are meaningful.
+ *
+ * Unlike NJointAction, this type does not derive from Loggable (to avoid the
+ * vtable pointer) but still implements its methods, so it can be used with
+ * RobotLogger.  Only the N joint values are logged.
+ *
+ * @tparam N Number of joints.
+ * @tparam Scalar_t Scalar type of the values.
+ */
+template <size_t N, typename Scalar_t = double>
+struct PaddedNJointAction
+{
+    //! @brief Number of joints.
+    static constexpr size_t num_joints = N;
+    //! @brief Size of the padded vectors.
+    static constexpr size_t padded_num_joints = padded_size<Scalar_t>(N);
+
+    typedef Scalar_t Scalar;
+    //! @brief Padded vector, only the first N elements are used.
+    typedef Eigen::Matrix<Scalar, padded_num_joints, 1> Vector;
+    //! @brief Vector with one element per joint (without padding).
+    typedef Eigen::Matrix<Scalar, N, 1> UnpaddedVector;
+    //! @brief Corresponding action type without padding.
+    typedef NJointAction<N, Scalar> UnpaddedAction;
+
+    //! Desired torque command (in addition to position controller).
+    alignas(SIMD_ALIGNMENT) Vector torque;
+    //! Desired position.  Set to NaN to disable position controller.
+    alignas(SIMD_ALIGNMENT) Vector position;
+    //! P-gain for position controller.  If NaN, default is used.
+    alignas(SIMD_ALIGNMENT) Vector position_kp;
+    //! D-gain for position controller.  If NaN, default is used.
+    alignas(SIMD_ALIGNMENT) Vector position_kd;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(torque, position, position_kp, position_kd);
+    }
+
+    std::vector<std::string> get_name()
+    {
+        return {"torque", "position", "position_kp", "position_kd"};
+    }
+
+    std::vector<std::vector<double>> get_data()
+    {
+        return {unpad_to_vector(torque),
+                unpad_to_vector(position),
+                unpad_to_vector(position_kp),
+                unpad_to_vector(position_kd)};
+    }
+
+    /**
+     * @brief Create action with desired torque and (optional) position.
+     *
+     * See NJointAction::NJointAction.
+     */
+    PaddedNJointAction(const UnpaddedVector& torque = UnpaddedVector::Zero(),
+                       const UnpaddedVector& position = None(),
+                       const UnpaddedVector& position_kp = None(),
+                       const UnpaddedVector& position_kd = None())
+        : torque(pad(torque)),
+          position(pad(position)),
+          position_kp(pad(position_kp)),
+          position_kd(pad(position_kd))
+    {
+    }
+
+    //! @brief Create padded copy of the given action.
+    explicit PaddedNJointAction(const UnpaddedAction& action)
+        : PaddedNJointAction(action.torque,
+                             action.position,
+                             action.position_kp,
+                             action.position_kd)
+    {
+    }
+
+    //! @brief Get copy of the action without padding.
+    UnpaddedAction to_unpadded() const
+    {
+        return UnpaddedAction(torque.template head<N>(),
+                              position.template head<N>(),
+                              position_kp.template head<N>(),
+                              position_kd.template head<N>());
+    }
+
+    //! @brief See NJointAction::Torque.
+    static PaddedNJointAction Torque(const UnpaddedVector& torque)
+    {
+        return PaddedNJointAction(torque);
+    }
+
+    //! @brief See NJointAction::Position.
+    static PaddedNJointAction Position(const UnpaddedVector& position,
+                                       const UnpaddedVector& kp = None(),
+                                       const UnpaddedVector& kd = None())
+    {
+        return PaddedNJointAction(UnpaddedVector::Zero(), position, kp, kd);
+    }
+
+    //! @brief See NJointAction::TorqueAndPosition.
+    static PaddedNJointAction TorqueAndPosition(
+        const UnpaddedVector& torque,
+        const UnpaddedVector& position,
+        const UnpaddedVector& position_kp = None(),
+        const UnpaddedVector& position_kd = None())
+    {
+        return PaddedNJointAction(torque, position, position_kp, position_kd);
+    }
+
+    //! @brief See NJointAction::Zero.
+    static PaddedNJointAction Zero()
+    {
+        return PaddedNJointAction();
+    }
+
+    //! @brief See NJointAction::None.
+    static UnpaddedVector None()
+    {
+        return UnpaddedVector::Constant(
+            std::numeric_limits<Scalar>::quiet_NaN());
+    }
+
+    //! @brief Copy v into a padded vector with zeros in the padding lanes.
+    static Vector pad(const UnpaddedVector& v)
+    {
+        Vector padded = Vector::Zero();
+        padded.template head<N>() = v;
+        return padded;
+    }
+
+private:
+    static std::vector<double> unpad_to_vector(const Vector& v)
+    {
+        std::vector<double> result(N);
+        Eigen::Matrix<double, N, 1>::Map(result.data()) =
+            v.template head<N>().template cast<double>();
+        return result;
+    }
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,171 @@
+/**
+ * @file
+ * @brief Helper function for creating Python bindings of the batch types.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <pybind11/eigen.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <robot_interfaces/batch_n_joint_robot_types.hpp>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Add the methods of BatchRobotFrontend to a Python class.
+ *
+ * All methods release the GIL, like those of the normal frontend.
+ */
+template <typename Frontend, typename PyClass>
+void bind_batch_frontend_methods(PyClass &c)
+{
+    typedef typename Frontend::Matrix Matrix;
+    typedef typename Frontend::Action Action;
+
+    c.def("append_desired_actions",
+          pybind11::overload_cast<const Matrix &>(
+              &Frontend::append_desired_actions),
+          pybind11::arg("torques"),
+          pybind11::call_guard<pybind11::gil_scoped_release>(),
+          "Append torque actions (array of shape (n_robots, n_joints)).")
+        .def("append_desired_actions",
+             pybind11::overload_cast<const Action &>(
+                 &Frontend::append_desired_actions),
+             pybind11::arg("actions"),
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_observations",
+             pybind11::overload_cast<const TimeIndex &>(
+                 &Frontend::get_observations, pybind11::const_),
+             pybind11::arg("t"),
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_observations",
+             pybind11::overload_cast<>(&Frontend::get_observations,
+                                       pybind11::const_),
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_observation",
+             &Frontend::get_observation,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_desired_action",
+             &Frontend::get_desired_action,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_applied_action",
+             &Frontend::get_applied_action,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_status",
+             &Frontend::get_status,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_timestamp_ms",
+             &Frontend::get_timestamp_ms,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("wait_until_timeindex",
+             &Frontend::wait_until_timeindex,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_current_timeindex",
+             &Frontend::get_current_timeindex,
+             pybind11::call_guard<pybind11::gil_scoped_release>());
+}
+
+/**
+ * @brief Create Python bindings for the given BatchNJointRobotTypes.
+ *
+ * Actions and observations are exposed with their fields as NumPy arrays of
+ * shape (n_robots, n_joints).  Backends are expected to be created in C++
+ * (e.g. by a simulation package) and passed to Python.
+ *
+ * @tparam Types  An instance of BatchNJointRobotTypes.
+ * @param m  Python module to which the bindings are added.
+ */
+template <typename Types>
+void create_batch_python_bindings(pybind11::module &m)
+{
+    typedef typename Types::Action Action;
+    typedef typename Types::Observation Observation;
+    typedef typename Action::Matrix Matrix;
+
+    pybind11::class_<typename Types::BaseData, typename Types::BaseDataPtr>(
+        m, "BaseData");
+
+    pybind11::class_<typename Types::SingleProcessData,
+                     typename Types::SingleProcessDataPtr,
+                     typename Types::BaseData>(m, "SingleProcessData")
+        .def(pybind11::init<size_t>(), pybind11::arg("history_size") = 1000);
+
+    pybind11::class_<typename Types::Backend, typename Types::BackendPtr>(
+        m, "Backend")
+        .def("initialize",
+             &Types::Backend::initialize,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("request_shutdown",
+             &Types::Backend::request_shutdown,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("wait_until_terminated",
+             &Types::Backend::wait_until_terminated,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("is_running",
+             &Types::Backend::is_running,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_termination_reason",
+             &Types::Backend::get_termination_reason,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("is_lockstep",
+             &Types::Backend::is_lockstep,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("step",
+             &Types::Backend::step,
+             pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    pybind11::class_<Action>(m, "Action")
+        .def(pybind11::init<size_t>(), pybind11::arg("n_robots") = 0)
+        .def(pybind11::init<Matrix, Matrix, Matrix, Matrix>(),
+             pybind11::arg("torque"),
+             pybind11::arg("position"),
+             pybind11::arg("position_kp"),
+             pybind11::arg("position_kd"))
+        .def_static("Torque", &Action::Torque, pybind11::arg("torque"))
+        .def_static("Position", &Action::Position, pybind11::arg("position"))
+        .def_readwrite("torque",
+                       &Action::torque,
+                       "Desired torques, shape (n_robots, n_joints).")
+        .def_readwrite("position",
+                       &Action::position,
+                       "Desired positions, shape (n_robots, n_joints).  Set "
+                       "to NaN to disable the position controller.")
+        .def_readwrite("position_kp", &Action::position_kp)
+        .def_readwrite("position_kd", &Action::position_kd)
+        .def_property_readonly("n_robots", &Action::num_robots);
+
+    pybind11::class_<Observation>(m, "Observation")
+        .def(pybind11::init<size_t>(), pybind11::arg("n_robots") = 0)
+        .def_readwrite("position",
+                       &Observation::position,
+                       "Joint positions, shape (n_robots, n_joints).")
+        .def_readwrite("velocity",
+                       &Observation::velocity,
+                       "Joint velocities, shape (n_robots, n_joints).")
+        .def_readwrite("torque",
+                       &Observation::torque,
+                       "Joint torques, shape (n_robots, n_joints).")
+        .def_property_readonly("n_robots", &Observation::num_robots);
+
+    auto frontend = pybind11::class_<typename Types::BatchFrontend,
+                                     typename Types::BatchFrontendPtr>(
+        m, "Frontend");
+    frontend.def(pybind11::init<typename Types::BaseDataPtr>());
+    bind_batch_frontend_methods<typename Types::BatchFrontend>(frontend);
+
+    auto lockstep_frontend =
+        pybind11::class_<typename Types::LockstepBatchFrontend,
+                         typename Types::LockstepBatchFrontendPtr>(
+            m, "LockstepFrontend");
+    lockstep_frontend.def(pybind11::init<typename Types::BaseDataPtr,
+                                         typename Types::BackendPtr>(),
+                          pybind11::arg("robot_data"),
+                          pybind11::arg("backend"));
+    bind_batch_frontend_methods<typename Types::LockstepBatchFrontend>(
+        lockstep_frontend);
+}
+
+}  // namespace robot_interfaces
@@ -19,6 +19,9 @@
  * \file
  * \brief Helper functions for creating Python bindings.
  */
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <type_traits>
 
 #include <pybind11/eigen.h>
@@ -26,6 +29,11 @@
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
 
+#include <robot_interfaces/action_hold_policy.hpp>
+#include <robot_interfaces/action_limiter.hpp>
+#include <robot_interfaces/observation_filter.hpp>
+#include <robot_interfaces/pybind_log_columns.hpp>
+#include <robot_interfaces/remote_robot_driver.hpp>
 #include <robot_interfaces/robot_frontend.hpp>
 
 namespace robot_interfaces
@@ -64,6 +72,163 @@ struct BindTipForceIfExists<Types,
     }
 };
 
+/**
+ * @brief Add "observation_tip_force" column to the log reader if it exists.
+ *
+ * Same as BindTipForceIfExists but for the column accessors of
+ * Types::BinaryLogReader (see create_python_bindings()).
+ */
+template <typename Types, typename = int>
+struct BindTipForceColumnIfExists
+{
+    typedef pybind11::class_<typename Types::BinaryLogReader,
+                             std::shared_ptr<typename Types::BinaryLogReader>>
+        PyLogReader;
+
+    static void bind(PyLogReader &)
+    {
+        // tip_force does not exist, so do nothing
+    }
+};
+template <typename Types>
+struct BindTipForceColumnIfExists<
+    Types,
+    decltype((void)Types::Observation::tip_force, 0)>
+{
+    typedef pybind11::class_<typename Types::BinaryLogReader,
+                             std::shared_ptr<typename Types::BinaryLogReader>>
+        PyLogReader;
+
+    static void bind(PyLogReader &c)
+    {
+        c.def_property_readonly(
+            "observation_tip_force",
+            [](const typename Types::BinaryLogReader &reader) {
+                return log_field_to_array(
+                    reader.data,
+                    [](const typename Types::LogEntry &entry) -> const auto & {
+                        return entry.observation.tip_force;
+                    });
+            },
+            "numpy.ndarray: Tip forces of all time steps, shape (T, "
+            "n_fingers).");
+    }
+};
+
+/**
+ * @brief Get pointer to the vector field of an NJointObservation by name.
+ *
+ * Used to select the input and output fields of the observation filters in
+ * Python.
+ *
+ * @throws std::invalid_argument if there is no such field.
+ */
+template <typename Observation>
+typename Observation::Vector Observation::*get_observation_vector_field(
+    const std::string &name)
+{
+    if (name == "position")
+    {
+        return &Observation::position;
+    }
+    if (name == "velocity")
+    {
+        return &Observation::velocity;
+    }
+    if (name == "torque")
+    {
+        return &Observation::torque;
+    }
+    throw std::invalid_argument("Unknown observation field '" + name + "'.");
+}
+
+/**
+ * @brief RobotDriver which forwards all calls to a Python object.
+ *
+ * The Python object has to implement the methods of RobotDriver.  The GIL is
+ * acquired for each call and the time waited for it is reported to the
+ * callback set with set_gil_wait_callback().
+ *
+ * This is meant to be served by a RemoteRobotDriverServer in a dedicated
+ * process, so that the real-time thread of the backend does not need the GIL.
+ */
+template <typename Types>
+class PythonRobotDriver
+    : public RobotDriver<typename Types::Action, typename Types::Observation>
+{
+public:
+    typedef typename Types::Action Action;
+    typedef typename Types::Observation Observation;
+
+    explicit PythonRobotDriver(pybind11::object driver) : driver_(driver)
+    {
+    }
+
+    ~PythonRobotDriver()
+    {
+        // the reference count of the Python object may only be changed with
+        // the GIL held
+        pybind11::gil_scoped_acquire gil;
+        driver_ = pybind11::object();
+    }
+
+    void set_gil_wait_callback(std::function<void(double)> callback)
+    {
+        on_gil_wait_ = callback;
+    }
+
+    void initialize() override
+    {
+        with_gil([this]() { driver_.attr("initialize")(); });
+    }
+
+    Action apply_action(const Action &desired_action) override
+    {
+        return with_gil([this, &desired_action]() {
+            return driver_.attr("apply_action")(desired_action)
+                .template cast<Action>();
+        });
+    }
+
+    Observation get_latest_observation() override
+    {
+        return with_gil([this]() {
+            return driver_.attr("get_latest_observation")()
+                .template cast<Observation>();
+        });
+    }
+
+    std::string get_error() override
+    {
+        return with_gil([this]() {
+            return driver_.attr("get_error")().template cast<std::string>();
+        });
+    }
+
+    void shutdown() override
+    {
+        with_gil([this]() { driver_.attr("shutdown")(); });
+    }
+
+private:
+    pybind11::object driver_;
+    std::function<void(double)> on_gil_wait_;
+
+    template <typename Function>
+    auto with_gil(Function function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        pybind11::gil_scoped_acquire gil;
+        if (on_gil_wait_)
+        {
+            on_gil_wait_(std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count());
+        }
+        return function();
+    }
+};
+
 /**
  * \brief Create Python bindings for the specified robot Types.
  *
@@ -87,20 +252,58 @@ void create_python_bindings(pybind11::module &m)
     options.disable_function_signatures();
 
     pybind11::class_<typename Types::BaseData, typename Types::BaseDataPtr>(
-        m, "BaseData");
+        m, "BaseData")
+        .def("get_history_lengths", &Types::BaseData::get_history_lengths)
+        .def("memory_footprint", &Types::BaseData::memory_footprint)
+        .def_static(
+            "estimate_memory_footprint",
+            [](const HistoryLengths &history_lengths) {
+                return Types::BaseData::estimate_memory_footprint(
+                    history_lengths);
+            },
+            pybind11::arg("history_lengths"))
+        .def_static("estimate_memory_footprint",
+                    &Types::BaseData::estimate_memory_footprint,
+                    pybind11::arg("history_lengths"),
+                    pybind11::arg("action"),
+                    pybind11::arg("observation"));
 
     pybind11::class_<typename Types::SingleProcessData,
                      typename Types::SingleProcessDataPtr,
                      typename Types::BaseData>(m, "SingleProcessData")
-        .def(pybind11::init<size_t>(), pybind11::arg("history_size") = 1000);
+        .def(pybind11::init<size_t>(), pybind11::arg("history_size") = 1000)
+        .def(pybind11::init<HistoryLengths>(),
+             pybind11::arg("history_lengths"));
 
     pybind11::class_<typename Types::MultiProcessData,
                      typename Types::MultiProcessDataPtr,
                      typename Types::BaseData>(m, "MultiProcessData")
-        .def(pybind11::init<std::string, bool, size_t>(),
+        .def(pybind11::init<std::string, bool, size_t, double>(),
              pybind11::arg("shared_memory_id_prefix"),
              pybind11::arg("is_master"),
-             pybind11::arg("history_size") = 1000);
+             pybind11::arg("history_size") = 1000,
+             pybind11::arg("attach_timeout_s") = 0.0,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def(pybind11::init<std::string, bool, HistoryLengths, double>(),
+             pybind11::arg("shared_memory_id_prefix"),
+             pybind11::arg("is_master"),
+             pybind11::arg("history_lengths"),
+             pybind11::arg("attach_timeout_s") = 0.0,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_epoch", &Types::MultiProcessData::get_epoch)
+        .def("needs_reattach", &Types::MultiProcessData::needs_reattach)
+        .def("reattach_if_needed",
+             &Types::MultiProcessData::reattach_if_needed,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def_static("clear_attach_state",
+                    &Types::MultiProcessData::clear_attach_state,
+                    pybind11::arg("shared_memory_id_prefix"))
+        .def("make_memory_resident",
+             &Types::MultiProcessData::make_memory_resident,
+             pybind11::arg("options") = MemoryResidencyOptions(),
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_memory_residency",
+             &Types::MultiProcessData::get_memory_residency);
 
     pybind11::class_<typename Types::Backend, typename Types::BackendPtr>(
         m, "Backend")
@@ -121,7 +324,274 @@ void create_python_bindings(pybind11::module &m)
              pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("get_termination_reason",
              &Types::Backend::get_termination_reason,
-             pybind11::call_guard<pybind11::gil_scoped_release>());
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("is_lockstep",
+             &Types::Backend::is_lockstep,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("step",
+             &Types::Backend::step,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("set_action_limiter",
+             &Types::Backend::set_action_limiter,
+             pybind11::arg("action_limiter"))
+        .def("set_action_hold_policy",
+             &Types::Backend::set_action_hold_policy,
+             pybind11::arg("action_hold_policy"))
+        .def("set_observation_filter",
+             &Types::Backend::set_observation_filter,
+             pybind11::arg("observation_filter"));
+
+    pybind11::class_<typename Types::RemoteDriver,
+                     typename Types::RemoteDriverPtr>(m,
+                                                      "RemoteDriver",
+                                                      R"XXX(
+            RemoteDriver(shared_memory_prefix: str, call_timeout_s=0.1, history_length=16)
+
+            Driver which forwards all calls to a ``RemoteDriverServer`` in
+            another process.  Pass it to ``create_remote_driver_backend`` to
+            run a Python-implemented driver without the backend thread
+            needing the GIL.
+)XXX")
+        .def(pybind11::init<std::string, double, size_t>(),
+             pybind11::arg("shared_memory_prefix"),
+             pybind11::arg("call_timeout_s") = 0.1,
+             pybind11::arg("history_length") = 16)
+        .def("get_statistics", &Types::RemoteDriver::get_statistics);
+
+    m.def(
+        "create_remote_driver_backend",
+        [](typename Types::RemoteDriverPtr driver,
+           typename Types::BaseDataPtr robot_data,
+           bool real_time_mode,
+           double first_action_timeout,
+           uint32_t max_number_of_actions) {
+            return std::make_shared<typename Types::Backend>(
+                driver,
+                robot_data,
+                real_time_mode,
+                first_action_timeout,
+                max_number_of_actions);
+        },
+        pybind11::arg("driver"),
+        pybind11::arg("robot_data"),
+        pybind11::arg("real_time_mode") = true,
+        pybind11::arg("first_action_timeout") =
+            std::numeric_limits<double>::infinity(),
+        pybind11::arg("max_number_of_actions") = 0,
+        "Create a backend using the given RemoteDriver.");
+
+    pybind11::class_<typename Types::RemoteDriverServer,
+                     typename Types::RemoteDriverServerPtr>(
+        m,
+        "RemoteDriverServer",
+        R"XXX(
+            RemoteDriverServer(shared_memory_prefix: str, driver)
+
+            Serve the requests of a ``RemoteDriver`` with a driver implemented
+            in Python.  The driver object needs the methods ``initialize()``,
+            ``apply_action(action)``, ``get_latest_observation()``,
+            ``get_error()`` and ``shutdown()``.  The time its calls wait for
+            the GIL is included in the statistics.
+)XXX")
+        .def(pybind11::init([](const std::string &shared_memory_prefix,
+                               pybind11::object driver) {
+                 auto python_driver =
+                     std::make_shared<PythonRobotDriver<Types>>(driver);
+                 auto server =
+                     std::make_shared<typename Types::RemoteDriverServer>(
+                         shared_memory_prefix, python_driver);
+                 // the server owns the driver, so the raw pointer stays valid
+                 auto *server_ptr = server.get();
+                 python_driver->set_gil_wait_callback(
+                     [server_ptr](double duration_s) {
+                         server_ptr->record_lock_wait(duration_s);
+                     });
+                 return server;
+             }),
+             pybind11::arg("shared_memory_prefix"),
+             pybind11::arg("driver"))
+        .def("process_request",
+             &Types::RemoteDriverServer::process_request,
+             pybind11::arg("timeout_s") =
+                 std::numeric_limits<double>::infinity(),
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("run",
+             &Types::RemoteDriverServer::run,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             "Process requests until the driver is shut down.")
+        .def("is_shutdown", &Types::RemoteDriverServer::is_shutdown)
+        .def("get_statistics", &Types::RemoteDriverServer::get_statistics);
+
+    typedef typename Types::Action Action;
+
+    pybind11::class_<typename Types::BaseActionHoldPolicy,
+                     typename Types::BaseActionHoldPolicyPtr>(
+        m, "BaseActionHoldPolicy")
+        .def("get_hold_action",
+             &Types::BaseActionHoldPolicy::get_hold_action,
+             pybind11::arg("last_action"),
+             pybind11::arg("previous_action"),
+             pybind11::arg("previous_interval"),
+             pybind11::arg("steps_since_last"));
+
+    pybind11::class_<RepeatActionHoldPolicy<Action>,
+                     std::shared_ptr<RepeatActionHoldPolicy<Action>>,
+                     typename Types::BaseActionHoldPolicy>(
+        m,
+        "RepeatActionHoldPolicy",
+        "Repeat the last action if the next one is late (default).")
+        .def(pybind11::init<>());
+
+    pybind11::class_<LinearExtrapolationHoldPolicy<Action>,
+                     std::shared_ptr<LinearExtrapolationHoldPolicy<Action>>,
+                     typename Types::BaseActionHoldPolicy>(
+        m,
+        "LinearExtrapolationHoldPolicy",
+        "Linearly extrapolate torque and position from the last two "
+        "actions if the next one is late.")
+        .def(pybind11::init<uint32_t>(),
+             pybind11::arg("max_extrapolation_steps") =
+                 std::numeric_limits<uint32_t>::max());
+
+    pybind11::class_<DecayingHoldPolicy<Action>,
+                     std::shared_ptr<DecayingHoldPolicy<Action>>,
+                     typename Types::BaseActionHoldPolicy>(
+        m,
+        "DecayingHoldPolicy",
+        "Hold the last action with exponentially decaying torque if the next "
+        "one is late.")
+        .def(pybind11::init<double>(), pybind11::arg("decay_factor"));
+
+    typedef typename Types::Observation Observation;
+
+    pybind11::class_<typename Types::BaseObservationFilter,
+                     typename Types::BaseObservationFilterPtr>(
+        m, "BaseObservationFilter")
+        .def("filter",
+             &Types::BaseObservationFilter::filter,
+             pybind11::arg("observation"),
+             pybind11::arg("time_s"));
+
+    pybind11::class_<ObservationFilterPipeline<Observation>,
+                     std::shared_ptr<ObservationFilterPipeline<Observation>>,
+                     typename Types::BaseObservationFilter>(
+        m,
+        "ObservationFilterPipeline",
+        "Apply several observation filters one after the other.")
+        .def(pybind11::init<>())
+        .def("add",
+             &ObservationFilterPipeline<Observation>::add,
+             pybind11::arg("filter"));
+
+    pybind11::class_<LowPassObservationFilter<Observation>,
+                     std::shared_ptr<LowPassObservationFilter<Observation>>,
+                     typename Types::BaseObservationFilter>(
+        m,
+        "LowPassObservationFilter",
+        "First-order low-pass filter of the observation field `input` "
+        "(\"position\", \"velocity\" or \"torque\"), written to `output`.")
+        .def(pybind11::init([](const std::string &input,
+                               const std::string &output,
+                               double cutoff_frequency_hz) {
+                 return std::make_shared<
+                     LowPassObservationFilter<Observation>>(
+                     get_observation_vector_field<Observation>(input),
+                     get_observation_vector_field<Observation>(output),
+                     cutoff_frequency_hz);
+             }),
+             pybind11::arg("input"),
+             pybind11::arg("output"),
+             pybind11::arg("cutoff_frequency_hz"));
+
+    pybind11::class_<
+        MovingAverageObservationFilter<Observation>,
+        std::shared_ptr<MovingAverageObservationFilter<Observation>>,
+        typename Types::BaseObservationFilter>(
+        m,
+        "MovingAverageObservationFilter",
+        "Moving average of the observation field `input` over `window_size` "
+        "steps, written to `output`.")
+        .def(pybind11::init([](const std::string &input,
+                               const std::string &output,
+                               size_t window_size) {
+                 return std::make_shared<
+                     MovingAverageObservationFilter<Observation>>(
+                     get_observation_vector_field<Observation>(input),
+                     get_observation_vector_field<Observation>(output),
+                     window_size);
+             }),
+             pybind11::arg("input"),
+             pybind11::arg("output"),
+             pybind11::arg("window_size"));
+
+    pybind11::class_<
+        FiniteDifferenceObservationFilter<Observation>,
+        std::shared_ptr<FiniteDifferenceObservationFilter<Observation>>,
+        typename Types::BaseObservationFilter>(
+        m,
+        "FiniteDifferenceObservationFilter",
+        "Time derivative of the observation field `input` by finite "
+        "differences, written to `output`.")
+        .def(pybind11::init([](const std::string &input,
+                               const std::string &output) {
+                 return std::make_shared<
+                     FiniteDifferenceObservationFilter<Observation>>(
+                     get_observation_vector_field<Observation>(input),
+                     get_observation_vector_field<Observation>(output));
+             }),
+             pybind11::arg("input"),
+             pybind11::arg("output"));
+
+    typedef NJointActionLimiter<typename Types::Action,
+                                typename Types::Observation>
+        NJointLimiter;
+
+    pybind11::class_<typename Types::BaseActionLimiter,
+                     typename Types::BaseActionLimiterPtr>(m,
+                                                           "BaseActionLimiter")
+        .def("limit",
+             &Types::BaseActionLimiter::limit,
+             pybind11::arg("action"),
+             pybind11::arg("observation"));
+
+    pybind11::class_<NJointLimiter,
+                     std::shared_ptr<NJointLimiter>,
+                     typename Types::BaseActionLimiter>(m,
+                                                        "ActionLimiter",
+                                                        R"XXX(
+            Safety stage applied by the backend to all desired actions.
+
+            Replaces NaN gains by the defaults, clamps the position, adds
+            velocity damping and clamps the torque.  Limits that are not
+            specified are not applied.  See Status.active_action_limits.
+)XXX")
+        .def(pybind11::init([](const typename NJointLimiter::Vector &max_torque,
+                               const typename NJointLimiter::Vector &pos_min,
+                               const typename NJointLimiter::Vector &pos_max,
+                               const typename NJointLimiter::Vector &safety_kd,
+                               const typename NJointLimiter::Vector &kp,
+                               const typename NJointLimiter::Vector &kd) {
+                 typename NJointLimiter::Limits limits;
+                 limits.max_torque = max_torque;
+                 limits.position_min = pos_min;
+                 limits.position_max = pos_max;
+                 limits.safety_kd = safety_kd;
+                 limits.default_kp = kp;
+                 limits.default_kd = kd;
+                 return std::make_shared<NJointLimiter>(limits);
+             }),
+             pybind11::arg("max_torque") =
+                 typename NJointLimiter::Limits().max_torque,
+             pybind11::arg("position_min") =
+                 typename NJointLimiter::Limits().position_min,
+             pybind11::arg("position_max") =
+                 typename NJointLimiter::Limits().position_max,
+             pybind11::arg("safety_kd") =
+                 typename NJointLimiter::Limits().safety_kd,
+             pybind11::arg("default_kp") =
+                 typename NJointLimiter::Limits().default_kp,
+             pybind11::arg("default_kd") =
+                 typename NJointLimiter::Limits().default_kd);
 
     pybind11::class_<typename Types::Action>(m,
                                              "Action",
@@ -198,34 +668,99 @@ void create_python_bindings(pybind11::module &m)
     // Release the GIL when calling any of the front-end functions, so in case
     // there are subthreads running Python, they have a chance to acquire the
     // GIL.
-    pybind11::class_<typename Types::Frontend, typename Types::FrontendPtr>(
-        m, "Frontend")
+    pybind11::class_<typename Types::ReadOnlyFrontend,
+                     typename Types::ReadOnlyFrontendPtr>(m, "ReadOnlyFrontend")
         .def(pybind11::init<typename Types::BaseDataPtr>())
         .def("get_observation",
-             &Types::Frontend::get_observation,
+             pybind11::overload_cast<const TimeIndex &>(
+                 &Types::ReadOnlyFrontend::get_observation, pybind11::const_),
+             pybind11::arg("t"),
              pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def(
+            "get_observation",
+            [](const typename Types::ReadOnlyFrontend &frontend,
+               const TimeIndex &t,
+               pybind11::object out) {
+                auto &observation = out.cast<typename Types::Observation &>();
+                {
+                    pybind11::gil_scoped_release release;
+                    frontend.get_observation(t, observation);
+                }
+                return out;
+            },
+            pybind11::arg("t"),
+            pybind11::arg("out"),
+            "Like get_observation(t) but writes the observation to `out` (and "
+            "returns it) instead of creating a new object.  Attribute views of "
+            "`out` stay valid and show the new values.")
         .def("get_desired_action",
-             &Types::Frontend::get_desired_action,
+             &Types::ReadOnlyFrontend::get_desired_action,
              pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("get_applied_action",
-             &Types::Frontend::get_applied_action,
+             &Types::ReadOnlyFrontend::get_applied_action,
              pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("get_status",
-             &Types::Frontend::get_status,
+             &Types::ReadOnlyFrontend::get_status,
              pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("get_timestamp_ms",
-             &Types::Frontend::get_timestamp_ms,
+             &Types::ReadOnlyFrontend::get_timestamp_ms,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("wait_until_timeindex",
+             &Types::ReadOnlyFrontend::wait_until_timeindex,
              pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_current_timeindex",
+             &Types::ReadOnlyFrontend::get_current_timeindex,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("peek_status", &Types::ReadOnlyFrontend::peek_status)
+        .def("has_observation",
+             &Types::ReadOnlyFrontend::has_observation,
+             pybind11::arg("t"))
+        .def("get_observation_doorbell",
+             &Types::ReadOnlyFrontend::get_observation_doorbell);
+
+    pybind11::class_<typename Types::Frontend,
+                     typename Types::FrontendPtr,
+                     typename Types::ReadOnlyFrontend>(m, "Frontend")
+        .def(pybind11::init<typename Types::BaseDataPtr>())
         .def("append_desired_action",
              &Types::Frontend::append_desired_action,
              pybind11::call_guard<pybind11::gil_scoped_release>())
-        .def("wait_until_timeindex",
-             &Types::Frontend::wait_until_timeindex,
+        .def("append_desired_trajectory",
+             pybind11::overload_cast<
+                 const std::vector<typename Types::Action> &,
+                 TimeIndex>(&Types::Frontend::append_desired_trajectory),
+             pybind11::arg("actions"),
+             pybind11::arg("start_timeindex"),
              pybind11::call_guard<pybind11::gil_scoped_release>())
-        .def("get_current_timeindex",
-             &Types::Frontend::get_current_timeindex,
+        .def("append_desired_trajectory",
+             pybind11::overload_cast<
+                 const std::vector<typename Types::Action> &>(
+                 &Types::Frontend::append_desired_trajectory),
+             pybind11::arg("actions"),
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("acquire_writer_lease",
+             &Types::Frontend::acquire_writer_lease,
+             pybind11::arg("priority") = 0,
+             pybind11::arg("lease_duration_s") =
+                 std::numeric_limits<double>::infinity(),
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("release_writer_lease",
+             &Types::Frontend::release_writer_lease,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("has_writer_lease",
+             &Types::Frontend::has_writer_lease,
              pybind11::call_guard<pybind11::gil_scoped_release>());
 
+    pybind11::class_<typename Types::LockstepFrontend,
+                     typename Types::LockstepFrontendPtr,
+                     typename Types::Frontend>(m, "LockstepFrontend")
+        .def(pybind11::init<typename Types::BaseDataPtr,
+                            typename Types::BackendPtr>(),
+             pybind11::arg("robot_data"),
+             pybind11::arg("backend"))
+        // the append methods are inherited from Frontend (they are virtual)
+        .def("get_backend", &Types::LockstepFrontend::get_backend);
+
     pybind11::class_<typename Types::LogEntry>(
         m, "LogEntry", "Represents the logged of one time step.")
         .def_readwrite("timeindex", &Types::LogEntry::timeindex)
@@ -235,11 +770,35 @@ void create_python_bindings(pybind11::module &m)
         .def_readwrite("desired_action", &Types::LogEntry::desired_action)
         .def_readwrite("applied_action", &Types::LogEntry::applied_action);
 
-    pybind11::class_<typename Types::Logger>(m, "Logger")
+    auto logger = pybind11::class_<typename Types::Logger>(m, "Logger");
+
+    pybind11::enum_<typename Types::Logger::Format>(logger, "Format")
+        .value("TEXT",
+               Types::Logger::Format::TEXT,
+               "Space-separated text file, one line per time step.")
+        .value("COLUMNAR",
+               Types::Logger::Format::COLUMNAR,
+               "Compressed columnar format.  Use "
+               ":class:`robot_interfaces.ColumnarLogReader` to read it.")
+        .value("BINARY",
+               Types::Logger::Format::BINARY,
+               "Binary format with checksummed records.  Use "
+               ":class:`BinaryLogReader` to read it.");
+
+    logger
         .def(pybind11::init<typename Types::BaseDataPtr, int>(),
              pybind11::arg("robot_data"),
              pybind11::arg("block_size") = 100)
-        .def("start", &Types::Logger::start)
+        .def("start",
+             &Types::Logger::start,
+             pybind11::arg("filename"),
+             pybind11::arg("format") = Types::Logger::Format::TEXT)
+        .def("start_segmented",
+             &Types::Logger::start_segmented,
+             pybind11::arg("prefix"),
+             pybind11::arg("format") = Types::Logger::Format::COLUMNAR,
+             pybind11::arg("max_segment_size") = 100 * 1024 * 1024,
+             pybind11::arg("max_segment_duration_s") = 0.0)
         .def("stop", &Types::Logger::stop)
         .def("write_current_buffer",
              &Types::Logger::write_current_buffer,
@@ -250,13 +809,37 @@ void create_python_bindings(pybind11::module &m)
              &Types::Logger::write_current_buffer_binary,
              pybind11::arg("filename"),
              pybind11::arg("start_index") = 0,
-             pybind11::arg("end_index") = -1);
+             pybind11::arg("end_index") = -1)
+        .def("write_current_buffer_columnar",
+             &Types::Logger::write_current_buffer_columnar,
+             pybind11::arg("filename"),
+             pybind11::arg("start_index") = 0,
+             pybind11::arg("end_index") = -1)
+        .def("allocate_snapshot",
+             &Types::Logger::allocate_snapshot,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             pybind11::arg("max_steps"))
+        .def("write_snapshot",
+             &Types::Logger::write_snapshot,
+             pybind11::call_guard<pybind11::gil_scoped_release>(),
+             pybind11::arg("filename"),
+             pybind11::arg("num_steps"),
+             pybind11::arg("format") = Types::Logger::Format::BINARY,
+             "Save the latest time steps to a file while the robot (and "
+             "the logger) keeps running.  The file is written in the "
+             "background, see :meth:`wait_for_snapshot`.")
+        .def("wait_for_snapshot",
+             &Types::Logger::wait_for_snapshot,
+             pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    typedef typename Types::LogEntry LogEntry;
+    typedef typename Types::BinaryLogReader LogReader;
 
-    pybind11::class_<typename Types::BinaryLogReader,
-                     std::shared_ptr<typename Types::BinaryLogReader>>(
+    auto log_reader = pybind11::class_<LogReader, std::shared_ptr<LogReader>>(
         m,
         "BinaryLogReader",
-        "BinaryLogReader(filename: str)\n\nSee :meth:`read_file`.")
+        "BinaryLogReader(filename: str)\n\nSee :meth:`read_file`.");
+    log_reader
         .def(pybind11::init<std::string>())
         .def("read_file",
              &Types::BinaryLogReader::read_file,
@@ -273,7 +856,122 @@ void create_python_bindings(pybind11::module &m)
 )XXX")
         .def_readonly("data",
                       &Types::BinaryLogReader::data,
-                      "List[LogEntry]: Contains the log entries.");
+                      "List[LogEntry]: Contains the log entries.  Note that "
+                      "the whole list is copied on each access.  To get the "
+                      "values of a specific field for all time steps, use "
+                      "the column accessors (e.g. "
+                      ":attr:`observation_position`) instead.")
+        .def_readonly("truncated",
+                      &Types::BinaryLogReader::truncated,
+                      "bool: True if incomplete data was found at the end of "
+                      "the file (e.g. because the logging process "
+                      "crashed).  All complete records are still read.");
+
+    // Column accessors.  They return the values of one field for all time steps
+    // as a NumPy array, which is filled in a single pass in C++.
+    log_reader
+        .def_property_readonly(
+            "timeindex",
+            [](const LogReader &reader) {
+                return log_field_to_array(
+                    reader.data,
+                    [](const LogEntry &entry) { return entry.timeindex; });
+            },
+            "numpy.ndarray: Time indices of all time steps, shape (T,).")
+        .def_property_readonly(
+            "timestamp",
+            [](const LogReader &reader) {
+                return log_field_to_array(
+                    reader.data,
+                    [](const LogEntry &entry) { return entry.timestamp; });
+            },
+            "numpy.ndarray: Timestamps of all time steps, shape (T,).")
+        .def_property_readonly(
+            "status_action_repetitions",
+            [](const LogReader &reader) {
+                return log_field_to_array(reader.data,
+                                          [](const LogEntry &entry) {
+                                              return entry.status
+                                                  .action_repetitions;
+                                          });
+            },
+            "numpy.ndarray: Action repetitions of all time steps, shape "
+            "(T,).")
+        .def_property_readonly(
+            "status_active_action_limits",
+            [](const LogReader &reader) {
+                return log_field_to_array(reader.data,
+                                          [](const LogEntry &entry) {
+                                              return entry.status
+                                                  .active_action_limits;
+                                          });
+            },
+            "numpy.ndarray: Active action limits (bit mask of "
+            "Status.ActionLimit) of all time steps, shape (T,).")
+        .def_property_readonly(
+            "status_error_status",
+            [](const LogReader &reader) {
+                return log_field_to_array(
+                    reader.data,
+                    [](const LogEntry &entry) {
+                        return entry.status.error_status;
+                    });
+            },
+            "numpy.ndarray: Error status (as integer) of all time steps, "
+            "shape (T,).");
+
+    typedef typename Types::Observation Observation;
+    typedef typename Types::Action Action;
+    typedef decltype(Observation::position) ObservationVector;
+    typedef typename Action::Vector ActionVector;
+
+    const std::vector<std::pair<std::string, ObservationVector Observation::*>>
+        observation_fields = {{"position", &Observation::position},
+                              {"velocity", &Observation::velocity},
+                              {"torque", &Observation::torque}};
+    for (const auto &[name, field] : observation_fields)
+    {
+        log_reader.def_property_readonly(
+            ("observation_" + name).c_str(),
+            [field = field](const LogReader &reader) {
+                return log_field_to_array(
+                    reader.data,
+                    [field](const LogEntry &entry) -> const auto & {
+                        return entry.observation.*field;
+                    });
+            },
+            ("numpy.ndarray: Observed " + name +
+             " of all time steps, shape (T, n_joints).")
+                .c_str());
+    }
+    BindTipForceColumnIfExists<Types>::bind(log_reader);
+
+    const std::vector<std::pair<std::string, ActionVector Action::*>>
+        action_fields = {{"torque", &Action::torque},
+                         {"position", &Action::position},
+                         {"position_kp", &Action::position_kp},
+                         {"position_kd", &Action::position_kd}};
+    const std::vector<std::pair<std::string, Action LogEntry::*>> actions = {
+        {"desired_action", &LogEntry::desired_action},
+        {"applied_action", &LogEntry::applied_action}};
+    for (const auto &[action_name, action] : actions)
+    {
+        for (const auto &[name, field] : action_fields)
+        {
+            log_reader.def_property_readonly(
+                (action_name + "_" + name).c_str(),
+                [action = action, field = field](const LogReader &reader) {
+                    return log_field_to_array(
+                        reader.data,
+                        [action, field](const LogEntry &entry) -> const auto & {
+                            return entry.*action.*field;
+                        });
+                },
+                ("numpy.ndarray: " + name + " of the " + action_name +
+                 " of all time steps, shape (T, n_joints).")
+                    .c_str());
+        }
+    }
 }
 
 }  // namespace robot_interfaces
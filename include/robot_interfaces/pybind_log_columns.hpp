@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Helper functions to expose log data as NumPy arrays.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Eigen>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Copy one field of all log entries into a NumPy array.
+ *
+ * The array is allocated once and filled in a single pass over the entries, so
+ * no Python object is created per entry.  Scalar fields (arithmetic types and
+ * enums) result in an array of shape (T,), Eigen vector fields in an array of
+ * shape (T, N), where T is the number of entries.  For vector fields of
+ * dynamic size, all entries need to have the same size.
+ *
+ * Usage:
+ *
+ *     log_field_to_array(reader.data, [](const LogEntry &entry) {
+ *         return entry.observation.position;
+ *     });
+ *
+ * @param entries  The log entries.
+ * @param get_field  Function returning the field of a given entry.  To avoid
+ *     copies, it should return a const reference.
+ * @return NumPy array containing the field of all entries.
+ * @throws pybind11::value_error (ValueError in Python) if the size of a
+ *     dynamic vector field differs between entries.
+ */
+template <typename Entry, typename GetField>
+pybind11::array log_field_to_array(const std::vector<Entry> &entries,
+                                   GetField get_field)
+{
+    typedef std::decay_t<decltype(get_field(std::declval<const Entry &>()))>
+        Field;
+    const size_t num_entries = entries.size();
+
+    if constexpr (std::is_arithmetic<Field>::value ||
+                  std::is_enum<Field>::value)
+    {
+        // enums are exported with their underlying integer type
+        typedef typename std::conditional_t<std::is_enum<Field>::value,
+                                            std::underlying_type<Field>,
+                                            std::common_type<Field>>::type
+            Scalar;
+
+        pybind11::array_t<Scalar> array(num_entries);
+        Scalar *out = array.mutable_data();
+        {
+            pybind11::gil_scoped_release release;
+            for (size_t i = 0; i < num_entries; i++)
+            {
+                out[i] = static_cast<Scalar>(get_field(entries[i]));
+            }
+        }
+        return std::move(array);
+    }
+    else
+    {
+        typedef typename Field::Scalar Scalar;
+        static_assert(Field::ColsAtCompileTime == 1,
+                      "Only column vectors are supported.");
+
+        // the size of dynamic vectors is determined from the first entry
+        const size_t width =
+            num_entries > 0
+                ? get_field(entries[0]).size()
+                : std::max<Eigen::Index>(Field::RowsAtCompileTime, 0);
+
+        pybind11::array_t<Scalar> array({num_entries, width});
+        Scalar *out = array.mutable_data();
+        // index of the first entry whose size differs from the first one
+        size_t mismatch = num_entries;
+        {
+            pybind11::gil_scoped_release release;
+            for (size_t i = 0; i < num_entries; i++)
+            {
+                const Field &value = get_field(entries[i]);
+                if (Field::RowsAtCompileTime == Eigen::Dynamic &&
+                    static_cast<size_t>(value.size()) != width)
+                {
+                    mismatch = i;
+                    break;
+                }
+                Eigen::Map<Eigen::Matrix<Scalar, Eigen::Dynamic, 1>>(
+                    out + i * width, width) = value;
+            }
+        }
+        if (mismatch < num_entries)
+        {
+            throw pybind11::value_error(
+                "Size of the field differs between log entries (entry " +
+                std::to_string(mismatch) + " has " +
+                std::to_string(get_field(entries[mismatch]).size()) +
+                " elements, the first entry " + std::to_string(width) + ").");
+        }
+        return std::move(array);
+    }
+}
+
+}  // namespace robot_interfaces
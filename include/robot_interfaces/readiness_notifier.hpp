@@ -0,0 +1,252 @@
+/**
+ * @file
+ * @brief Bridge from doorbells to a file descriptor for event loops.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "doorbell.hpp"
+
+namespace robot_interfaces
+{
+/**
+ * @brief Signals a file descriptor when one of several doorbells is rung.
+ *
+ * The getters of the frontends block until the requested data is available,
+ * which does not fit into event loops (asio, Python asyncio, ...).  To
+ * integrate robots and sensors into an event loop, add their doorbells (e.g.
+ * ReadOnlyRobotFrontend::get_observation_doorbell()) as sources and watch the
+ * file descriptor returned by get_fd() for readability.  When it becomes
+ * readable, take_ready_sources() tells which sources were rung, and the data
+ * can be fetched without blocking.
+ *
+ * A single background thread waits for all sources at once (see
+ * Doorbell::wait_any()), so one event loop thread can serve many robots and
+ * sensors without a helper thread per robot.
+ *
+ * Example with asio:
+ *
+ *     asio::posix::stream_descriptor fd(io_context, notifier.get_fd());
+ *     fd.async_wait(asio::posix::stream_descriptor::wait_read, handler);
+ *     // in handler: notifier.take_ready_sources(), then re-arm
+ */
+class ReadinessNotifier
+{
+public:
+    typedef size_t SourceId;
+
+    //! @brief Maximum number of sources.
+    static constexpr size_t MAX_SOURCES = 127;
+
+    ReadinessNotifier() : is_running_(true)
+    {
+        fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd_ < 0)
+        {
+            throw std::runtime_error(std::string("Failed to create eventfd: ") +
+                                     std::strerror(errno));
+        }
+        thread_ = std::thread(&ReadinessNotifier::loop, this);
+    }
+
+    ~ReadinessNotifier()
+    {
+        is_running_ = false;
+        wake_up_.ring();
+        thread_.join();
+        close(fd_);
+    }
+
+    ReadinessNotifier(const ReadinessNotifier &) = delete;
+    ReadinessNotifier &operator=(const ReadinessNotifier &) = delete;
+
+    /**
+     * @brief Add a doorbell as source.
+     *
+     * Only rings after this call are reported.
+     *
+     * @return ID of the source, as returned by take_ready_sources().
+     * @throws std::length_error if the maximum number of sources is exceeded.
+     */
+    SourceId add_source(std::shared_ptr<Doorbell> doorbell)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sources_.size() >= MAX_SOURCES)
+        {
+            throw std::length_error("Too many sources.");
+        }
+        Source source;
+        source.doorbell = doorbell;
+        source.sequence = doorbell->get_sequence();
+        source.is_ready = false;
+        sources_.push_back(source);
+        wake_up_.ring();
+        return sources_.size() - 1;
+    }
+
+    /**
+     * @brief Replace the doorbell of a source.
+     *
+     * Needed when the doorbell of the data changes, e.g. after
+     * RobotData::reattach_if_needed() attached to the data of a restarted
+     * backend.  Only rings after this call are reported.
+     *
+     * @throws std::out_of_range if there is no source with the given ID.
+     */
+    void replace_source(SourceId id, std::shared_ptr<Doorbell> doorbell)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Source &source = get_source(id);
+        source.doorbell = doorbell;
+        source.sequence = doorbell->get_sequence();
+        source.is_ready = false;
+        wake_up_.ring();
+    }
+
+    /**
+     * @brief Remove a source.
+     *
+     * IDs are not reused, so the removed source still counts towards
+     * MAX_SOURCES.
+     *
+     * @throws std::out_of_range if there is no source with the given ID.
+     */
+    void remove_source(SourceId id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Source &source = get_source(id);
+        source.doorbell.reset();
+        source.is_ready = false;
+        wake_up_.ring();
+    }
+
+    /**
+     * @brief File descriptor that becomes readable when a source was rung.
+     *
+     * Only use it for polling (the notifier reads it in
+     * take_ready_sources()).
+     */
+    int get_fd() const
+    {
+        return fd_;
+    }
+
+    /**
+     * @brief Get the sources that were rung since the last call.
+     *
+     * Also resets the readability of the file descriptor.  Call this before
+     * checking the data of the sources, so that no ring is missed.
+     */
+    std::vector<SourceId> take_ready_sources()
+    {
+        uint64_t counter;
+        // fails with EAGAIN if nothing is pending, which is fine
+        ssize_t result = read(fd_, &counter, sizeof(counter));
+        (void)result;
+
+        std::vector<SourceId> ready;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (SourceId i = 0; i < sources_.size(); i++)
+        {
+            if (sources_[i].is_ready)
+            {
+                sources_[i].is_ready = false;
+                ready.push_back(i);
+            }
+        }
+        return ready;
+    }
+
+private:
+    struct Source
+    {
+        //! Null if the source was removed.
+        std::shared_ptr<Doorbell> doorbell;
+        //! Sequence of the doorbell that was last reported.
+        uint32_t sequence;
+        bool is_ready;
+    };
+
+    int fd_;
+    std::atomic<bool> is_running_;
+    std::mutex mutex_;
+    std::vector<Source> sources_;
+    //! Rung to make the thread pick up new sources or terminate.
+    Doorbell wake_up_;
+    std::thread thread_;
+
+    //! Get the source with the given ID (mutex_ has to be locked).
+    Source &get_source(SourceId id)
+    {
+        if (id >= sources_.size() || !sources_[id].doorbell)
+        {
+            throw std::out_of_range("Invalid source ID.");
+        }
+        return sources_[id];
+    }
+
+    void loop()
+    {
+        std::vector<Doorbell *> doorbells;
+        std::vector<uint32_t> sequences;
+        std::vector<std::shared_ptr<Doorbell>> keep_alive;
+
+        while (is_running_)
+        {
+            // read this first, so sources added later wake up the wait below
+            const uint32_t wake_up_sequence = wake_up_.get_sequence();
+
+            doorbells.assign(1, &wake_up_);
+            sequences.assign(1, wake_up_sequence);
+            keep_alive.clear();
+
+            bool is_any_ready = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (Source &source : sources_)
+                {
+                    if (!source.doorbell)
+                    {
+                        continue;
+                    }
+                    const uint32_t sequence = source.doorbell->get_sequence();
+                    if (sequence != source.sequence)
+                    {
+                        source.sequence = sequence;
+                        source.is_ready = true;
+                        is_any_ready = true;
+                    }
+                    doorbells.push_back(source.doorbell.get());
+                    sequences.push_back(source.sequence);
+                    keep_alive.push_back(source.doorbell);
+                }
+            }
+
+            if (is_any_ready)
+            {
+                const uint64_t one = 1;
+                ssize_t result = write(fd_, &one, sizeof(one));
+                (void)result;
+            }
+
+            Doorbell::wait_any(doorbells, sequences);
+        }
+    }
+};
+
+}  // namespace robot_interfaces
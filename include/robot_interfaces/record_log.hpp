@@ -0,0 +1,533 @@
+/**
+ * @file
+ * @brief Crash-consistent file of checksummed records with an index sidecar.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * A record log file is a sequence of self-delimiting records, each protected
+ * by a checksum.  It is used as container by the streaming log writers, so
+ * that after a crash of the logging process all completely written records
+ * can be recovered, while an incomplete ("torn") record at the end of the file
+ * is detected and ignored.
+ *
+ * File layout (all integers in the native byte order of the writing machine):
+ *
+ * @verbatim
+   magic (defined by the user of the file)   8 bytes
+   format version                            uint32
+   for each record:
+       record marker (RECORD_MARKER)         uint32
+       payload size in bytes                 uint32
+       key (e.g. time index of first step)   int64
+       CRC-32 of key and payload             uint32
+       payload                               bytes
+   @endverbatim
+ *
+ * Each record is written with a single write call and the stream is flushed
+ * afterwards, so at most the last record can be incomplete if the process
+ * dies.
+ *
+ * Additionally an index sidecar file `<filename>.idx` is written.  It
+ * contains one entry (offset, key, CRC-32 of offset and key) per record and is
+ * updated periodically ("checkpoint"), always after the records it refers to
+ * have been flushed.  When opening a file, the reader takes the record
+ * positions from the index and only has to scan the records written after the
+ * last checkpoint.  Without index (e.g. if it got lost) the whole file is
+ * scanned, which is still fast as the scan jumps from record to record based
+ * on the size fields.
+ */
+#pragma once
+
+#include <unistd.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace robot_interfaces
+{
+namespace record_log
+{
+//! @brief Marker at the beginning of each record.
+constexpr std::uint32_t RECORD_MARKER = 0x31434552;  // "REC1"
+
+//! @brief Size of the file header (magic and format version).
+constexpr size_t FILE_HEADER_SIZE = 8 + sizeof(std::uint32_t);
+
+//! @brief Size of the record header (marker, size, key, checksum).
+constexpr size_t RECORD_HEADER_SIZE =
+    2 * sizeof(std::uint32_t) + sizeof(std::int64_t) + sizeof(std::uint32_t);
+
+//! @brief Size of one entry in the index file.
+constexpr size_t INDEX_ENTRY_SIZE =
+    sizeof(std::uint64_t) + sizeof(std::int64_t) + sizeof(std::uint32_t);
+
+/**
+ * @brief Compute the CRC-32 (as used by zlib) of the given data.
+ *
+ * @param data  Pointer to the data.
+ * @param size  Size of the data in bytes.
+ * @param crc  CRC of preceding data, to compute the checksum incrementally.
+ */
+inline std::uint32_t crc32(const void *data, size_t size, std::uint32_t crc = 0)
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> table;
+        for (std::uint32_t i = 0; i < 256; i++)
+        {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    const std::uint8_t *bytes = static_cast<const std::uint8_t *>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+//! @brief Position and key of a record.
+struct IndexEntry
+{
+    std::uint64_t offset;
+    std::int64_t key;
+
+    std::uint32_t checksum() const
+    {
+        return crc32(&key, sizeof(key), crc32(&offset, sizeof(offset)));
+    }
+};
+
+//! @brief Get the path of the index sidecar of the given file.
+inline std::string get_index_path(const std::string &filename)
+{
+    return filename + ".idx";
+}
+
+}  // namespace record_log
+
+/**
+ * @brief Write a record log file.
+ *
+ * See record_log.hpp for a description of the file format.
+ */
+class RecordLogWriter
+{
+public:
+    /**
+     * @brief Create the file and write the file header.
+     *
+     * @param filename  Path to the file.  Existing files are overwritten!
+     * @param magic  8 characters identifying the type of the file.
+     * @param format_version  Version of the format of the payload.
+     * @param checkpoint_interval  Number of records after which the index is
+     *     updated.
+     */
+    RecordLogWriter(const std::string &filename,
+                    const char (&magic)[8],
+                    std::uint32_t format_version,
+                    size_t checkpoint_interval = 10)
+        : checkpoint_interval_(checkpoint_interval)
+    {
+        file_.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file_)
+        {
+            throw std::runtime_error("Failed to open file " + filename);
+        }
+        index_file_.open(record_log::get_index_path(filename),
+                         std::ios::binary | std::ios::trunc);
+        if (!index_file_)
+        {
+            throw std::runtime_error("Failed to open index file for " +
+                                     filename);
+        }
+
+        file_.write(magic, sizeof(magic));
+        file_.write(reinterpret_cast<const char *>(&format_version),
+                    sizeof(format_version));
+        file_.flush();
+        offset_ = record_log::FILE_HEADER_SIZE;
+    }
+
+    ~RecordLogWriter()
+    {
+        close();
+    }
+
+    /**
+     * @brief Append a record.
+     *
+     * The record is written with a single write and flushed, so it is
+     * complete in the file once this returns (even if the process dies
+     * afterwards).
+     *
+     * @param payload  Data of the record.
+     * @param key  Key of the record (e.g. the time index of the first time
+     *     step contained in it).  Stored in the index for fast lookup.
+     */
+    void append(const std::string &payload, std::int64_t key)
+    {
+        if (payload.size() > UINT32_MAX)
+        {
+            throw std::invalid_argument("Record is too big.");
+        }
+
+        const std::uint32_t size = payload.size();
+        const std::uint32_t crc =
+            record_log::crc32(payload.data(),
+                              payload.size(),
+                              record_log::crc32(&key, sizeof(key)));
+
+        record_.resize(record_log::RECORD_HEADER_SIZE + payload.size());
+        char *p = &record_[0];
+        std::memcpy(p, &record_log::RECORD_MARKER, sizeof(std::uint32_t));
+        std::memcpy(p + 4, &size, sizeof(size));
+        std::memcpy(p + 8, &key, sizeof(key));
+        std::memcpy(p + 16, &crc, sizeof(crc));
+        std::memcpy(
+            p + record_log::RECORD_HEADER_SIZE, payload.data(), payload.size());
+
+        file_.write(record_.data(), record_.size());
+        file_.flush();
+        if (!file_)
+        {
+            throw std::runtime_error("Failed to write record.");
+        }
+
+        pending_index_.push_back({offset_, key});
+        offset_ += record_.size();
+
+        if (pending_index_.size() >= checkpoint_interval_)
+        {
+            checkpoint();
+        }
+    }
+
+    /**
+     * @brief Write index entries of all records written so far.
+     *
+     * This is done automatically every `checkpoint_interval` records.
+     */
+    void checkpoint()
+    {
+        for (const record_log::IndexEntry &entry : pending_index_)
+        {
+            const std::uint32_t crc = entry.checksum();
+            index_file_.write(reinterpret_cast<const char *>(&entry.offset),
+                              sizeof(entry.offset));
+            index_file_.write(reinterpret_cast<const char *>(&entry.key),
+                              sizeof(entry.key));
+            index_file_.write(reinterpret_cast<const char *>(&crc),
+                              sizeof(crc));
+        }
+        index_file_.flush();
+        pending_index_.clear();
+    }
+
+    //! @brief Get the number of bytes written to the file so far.
+    size_t get_bytes_written() const
+    {
+        return offset_;
+    }
+
+    //! @brief Write the index and close the files.
+    void close()
+    {
+        if (file_.is_open())
+        {
+            checkpoint();
+            file_.close();
+            index_file_.close();
+        }
+    }
+
+private:
+    std::ofstream file_;
+    std::ofstream index_file_;
+    size_t checkpoint_interval_;
+    std::uint64_t offset_;
+    std::vector<record_log::IndexEntry> pending_index_;
+    //! @brief Buffer for assembling a record (to write it at once).
+    std::string record_;
+};
+
+/**
+ * @brief Read a record log file, recovering all complete records.
+ *
+ * On construction the positions of all records are determined, using the
+ * index sidecar if available.  Records after the last index checkpoint are
+ * found by scanning and verified with their checksum.  The scan stops at the
+ * first incomplete or corrupted record, i.e. if the writing process crashed,
+ * all records that were completely written before the crash are available.
+ */
+class RecordLogReader
+{
+public:
+    /**
+     * @brief Open the file and locate all valid records.
+     *
+     * @param filename  Path to the file.
+     * @param magic  Expected magic of the file.
+     * @throws std::runtime_error if the file cannot be opened or has a
+     *     different magic.
+     */
+    RecordLogReader(const std::string &filename, const char (&magic)[8])
+        : filename_(filename), truncated_(false)
+    {
+        file_.open(filename, std::ios::binary | std::ios::ate);
+        if (!file_)
+        {
+            throw std::runtime_error("Failed to open file " + filename);
+        }
+        file_size_ = file_.tellg();
+        file_.seekg(0);
+
+        char file_magic[8];
+        file_.read(file_magic, sizeof(file_magic));
+        file_.read(reinterpret_cast<char *>(&format_version_),
+                   sizeof(format_version_));
+        if (!file_ || std::memcmp(file_magic, magic, sizeof(magic)) != 0)
+        {
+            throw std::runtime_error(filename + " has unexpected file type.");
+        }
+
+        read_index();
+        scan();
+    }
+
+    //! @brief Check if a file starts with the given magic.
+    static bool has_magic(const std::string &filename, const char (&magic)[8])
+    {
+        std::ifstream file(filename, std::ios::binary);
+        char file_magic[8];
+        return file.read(file_magic, sizeof(file_magic)) &&
+               std::memcmp(file_magic, magic, sizeof(magic)) == 0;
+    }
+
+    //! @brief Get the format version stored in the file header.
+    std::uint32_t get_format_version() const
+    {
+        return format_version_;
+    }
+
+    //! @brief Get the number of valid records.
+    size_t size() const
+    {
+        return records_.size();
+    }
+
+    //! @brief Get the key of the i-th record.
+    std::int64_t get_key(size_t i) const
+    {
+        return records_.at(i).key;
+    }
+
+    /**
+     * @brief Check if there is invalid data after the last valid record.
+     *
+     * This is the case if the writing process was terminated while writing a
+     * record.
+     */
+    bool is_truncated() const
+    {
+        return truncated_;
+    }
+
+    //! @brief Get the size of the file up to the end of the last valid record.
+    std::uint64_t get_valid_size() const
+    {
+        return valid_size_;
+    }
+
+    /**
+     * @brief Read the payload of the i-th record.
+     *
+     * @param i  Index of the record.
+     * @param payload  The payload is written to this string.
+     * @throws std::runtime_error if the checksum does not match.
+     */
+    void read(size_t i, std::string &payload)
+    {
+        std::int64_t key;
+        if (!read_record(records_.at(i).offset, key, payload))
+        {
+            throw std::runtime_error("Record " + std::to_string(i) + " of " +
+                                     filename_ + " is corrupted.");
+        }
+    }
+
+    /**
+     * @brief Cut off incomplete data at the end of a file and fix the index.
+     *
+     * Use this to repair a log file after the writing process crashed, so
+     * that further tools do not need to deal with a torn last record.
+     *
+     * @param filename  Path to the file.
+     * @return Number of valid records in the file.
+     */
+    static size_t repair(const std::string &filename)
+    {
+        char magic[8];
+        {
+            std::ifstream file(filename, std::ios::binary);
+            if (!file.read(magic, sizeof(magic)))
+            {
+                throw std::runtime_error(filename +
+                                         " is not a record log file.");
+            }
+        }
+
+        std::vector<record_log::IndexEntry> records;
+        std::uint64_t valid_size;
+        {
+            RecordLogReader reader(filename, magic);
+            records = reader.records_;
+            valid_size = reader.valid_size_;
+        }
+
+        if (::truncate(filename.c_str(), valid_size) != 0)
+        {
+            throw std::runtime_error("Failed to truncate " + filename);
+        }
+
+        std::ofstream index_file(record_log::get_index_path(filename),
+                                 std::ios::binary | std::ios::trunc);
+        for (const record_log::IndexEntry &entry : records)
+        {
+            const std::uint32_t crc = entry.checksum();
+            index_file.write(reinterpret_cast<const char *>(&entry.offset),
+                             sizeof(entry.offset));
+            index_file.write(reinterpret_cast<const char *>(&entry.key),
+                             sizeof(entry.key));
+            index_file.write(reinterpret_cast<const char *>(&crc),
+                             sizeof(crc));
+        }
+
+        return records.size();
+    }
+
+private:
+    std::string filename_;
+    std::ifstream file_;
+    std::uint64_t file_size_;
+    std::uint32_t format_version_;
+    std::vector<record_log::IndexEntry> records_;
+    std::uint64_t valid_size_;
+    bool truncated_;
+
+    //! @brief Get record positions from the index (as far as it is valid).
+    void read_index()
+    {
+        std::ifstream index_file(record_log::get_index_path(filename_),
+                                 std::ios::binary);
+
+        char buffer[record_log::INDEX_ENTRY_SIZE];
+        std::uint64_t expected_offset = record_log::FILE_HEADER_SIZE;
+        while (index_file.read(buffer, sizeof(buffer)))
+        {
+            record_log::IndexEntry entry;
+            std::uint32_t crc;
+            std::memcpy(&entry.offset, buffer, sizeof(entry.offset));
+            std::memcpy(&entry.key, buffer + 8, sizeof(entry.key));
+            std::memcpy(&crc, buffer + 16, sizeof(crc));
+
+            // The entries have to be consecutive.  Only the start of each
+            // record is known from the index, so stop at the first entry
+            // that does not match (its predecessor is then verified by the
+            // scan).
+            if (crc != entry.checksum() || entry.offset != expected_offset ||
+                entry.offset + record_log::RECORD_HEADER_SIZE > file_size_)
+            {
+                break;
+            }
+            records_.push_back(entry);
+
+            // size of the record is needed to check the next entry
+            std::uint32_t size;
+            file_.seekg(entry.offset + sizeof(std::uint32_t));
+            file_.read(reinterpret_cast<char *>(&size), sizeof(size));
+            expected_offset =
+                entry.offset + record_log::RECORD_HEADER_SIZE + size;
+        }
+    }
+
+    /**
+     * @brief Find and verify records after the last indexed one.
+     *
+     * The last indexed record is verified as well, since the index may have
+     * been written for a file that was later truncated.
+     */
+    void scan()
+    {
+        std::uint64_t offset = record_log::FILE_HEADER_SIZE;
+        if (!records_.empty())
+        {
+            offset = records_.back().offset;
+            records_.pop_back();
+        }
+
+        std::string payload;
+        std::int64_t key;
+        while (offset < file_size_ && read_record(offset, key, payload))
+        {
+            records_.push_back({offset, key});
+            offset += record_log::RECORD_HEADER_SIZE + payload.size();
+        }
+
+        valid_size_ = offset;
+        truncated_ = offset < file_size_;
+    }
+
+    /**
+     * @brief Read and verify the record at the given offset.
+     *
+     * @return True if the record is complete and the checksum matches.
+     */
+    bool read_record(std::uint64_t offset,
+                     std::int64_t &key,
+                     std::string &payload)
+    {
+        if (offset + record_log::RECORD_HEADER_SIZE > file_size_)
+        {
+            return false;
+        }
+
+        char header[record_log::RECORD_HEADER_SIZE];
+        file_.clear();
+        file_.seekg(offset);
+        file_.read(header, sizeof(header));
+
+        std::uint32_t marker, size, crc;
+        std::memcpy(&marker, header, sizeof(marker));
+        std::memcpy(&size, header + 4, sizeof(size));
+        std::memcpy(&key, header + 8, sizeof(key));
+        std::memcpy(&crc, header + 16, sizeof(crc));
+
+        if (!file_ || marker != record_log::RECORD_MARKER ||
+            offset + record_log::RECORD_HEADER_SIZE + size > file_size_)
+        {
+            return false;
+        }
+
+        payload.resize(size);
+        file_.read(&payload[0], size);
+
+        return file_ && crc == record_log::crc32(
+                                   payload.data(),
+                                   payload.size(),
+                                   record_log::crc32(&key, sizeof(key)));
+    }
+};
+
+}  // namespace robot_interfaces
@@ -0,0 +1,559 @@
+/**
+ * @file
+ * @brief Run a robot driver in a different process than the backend.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <time_series/multiprocess_time_series.hpp>
+
+#include "doorbell.hpp"
+#include "robot_driver.hpp"
+#include "shared_memory_segment.hpp"
+
+namespace robot_interfaces
+{
+/**
+ * @brief Timing statistics of a remote driver (see RemoteRobotDriver).
+ */
+struct RemoteDriverStatistics
+{
+    //! @brief Number of driver calls done so far.
+    uint64_t num_calls = 0;
+    //! @brief Mean duration of a call, including the driver method [s].
+    double mean_call_duration_s = 0;
+    //! @brief Maximum duration of a call, including the driver method [s].
+    double max_call_duration_s = 0;
+
+    //! @brief Number of lock acquisitions reported by the driver process.
+    uint64_t num_lock_waits = 0;
+    //! @brief Total time the driver process waited for locks [s].
+    double total_lock_wait_s = 0;
+    //! @brief Maximum time the driver process waited for a lock [s].
+    double max_lock_wait_s = 0;
+};
+
+/**
+ * @brief Shared memory through which RemoteRobotDriver and
+ *        RemoteRobotDriverServer communicate.
+ *
+ * Actions and observations are exchanged through multi-process time series,
+ * i.e. preallocated ring buffers in shared memory.  Requests and responses are
+ * signalled with doorbells, so neither side polls.
+ */
+template <typename Action, typename Observation>
+class RemoteDriverChannel
+{
+public:
+    //! @brief Requests sent to the driver process.
+    enum Command : uint32_t
+    {
+        INITIALIZE = 1,
+        APPLY_ACTION,
+        GET_OBSERVATION,
+        GET_ERROR,
+        SHUTDOWN
+    };
+
+    //! @brief Maximum length of error messages passed between the processes.
+    static constexpr size_t MAX_MESSAGE_LENGTH = 1024;
+
+    /**
+     * @param prefix  Prefix for the shared memory IDs.
+     * @param is_leader  If true, the shared memory is created (existing memory
+     *     with the same IDs is reset), otherwise it is opened.
+     * @param history_length  Length of the time series of the leader.
+     */
+    RemoteDriverChannel(const std::string &prefix,
+                        bool is_leader,
+                        size_t history_length)
+        : state_(prefix + "_remote_driver", is_leader)
+    {
+        typedef time_series::MultiprocessTimeSeries<Action> TS_Action;
+        typedef time_series::MultiprocessTimeSeries<Observation> TS_Observation;
+
+        if (is_leader)
+        {
+            time_series::clear_memory(prefix + "_remote_desired_action");
+            time_series::clear_memory(prefix + "_remote_applied_action");
+            time_series::clear_memory(prefix + "_remote_observation");
+
+            desired_action = TS_Action::create_leader_ptr(
+                prefix + "_remote_desired_action", history_length);
+            applied_action = TS_Action::create_leader_ptr(
+                prefix + "_remote_applied_action", history_length);
+            observation = TS_Observation::create_leader_ptr(
+                prefix + "_remote_observation", history_length);
+            request_doorbell =
+                Doorbell::create_leader(prefix + "_remote_request");
+            response_doorbell =
+                Doorbell::create_leader(prefix + "_remote_response");
+        }
+        else
+        {
+            desired_action = TS_Action::create_follower_ptr(
+                prefix + "_remote_desired_action");
+            applied_action = TS_Action::create_follower_ptr(
+                prefix + "_remote_applied_action");
+            observation = TS_Observation::create_follower_ptr(
+                prefix + "_remote_observation");
+            request_doorbell =
+                Doorbell::create_follower(prefix + "_remote_request");
+            response_doorbell =
+                Doorbell::create_follower(prefix + "_remote_response");
+        }
+    }
+
+    //! @brief Actions passed to RobotDriver::apply_action().
+    std::shared_ptr<time_series::TimeSeriesInterface<Action>> desired_action;
+    //! @brief Actions returned by RobotDriver::apply_action().
+    std::shared_ptr<time_series::TimeSeriesInterface<Action>> applied_action;
+    //! @brief Observations returned by RobotDriver::get_latest_observation().
+    std::shared_ptr<time_series::TimeSeriesInterface<Observation>> observation;
+    //! @brief Rung by the backend side when a command is requested.
+    std::shared_ptr<Doorbell> request_doorbell;
+    //! @brief Rung by the driver side when a command is processed.
+    std::shared_ptr<Doorbell> response_doorbell;
+
+    /**
+     * @brief Send a new request (backend side).
+     *
+     * Overwrites a request that was not processed yet.
+     *
+     * @return ID of the request.  The driver side sets the number of
+     *     processed requests to it once the request is processed.
+     */
+    uint32_t set_request(Command command)
+    {
+        const uint32_t request_id = get_request_id() + 1;
+        // ID and command are stored in one word, so they are always read
+        // consistently
+        state_->request = (static_cast<uint64_t>(request_id) << 32) |
+                          static_cast<uint64_t>(command);
+        return request_id;
+    }
+
+    //! @brief ID of the newest request.
+    uint32_t get_request_id() const
+    {
+        return static_cast<uint32_t>(state_->request.load() >> 32);
+    }
+
+    /**
+     * @brief Get the newest request (driver side).
+     *
+     * @param command  Is set to the command of the request.
+     * @return ID of the request to which the command belongs.
+     */
+    uint32_t get_request(Command *command) const
+    {
+        const uint64_t request = state_->request.load();
+        *command = static_cast<Command>(request & 0xFFFFFFFF);
+        return static_cast<uint32_t>(request >> 32);
+    }
+
+    /**
+     * @brief ID of the last processed request.
+     *
+     * Request IDs are consecutive, so this is the number of processed requests
+     * unless requests were overwritten before they were processed.
+     */
+    uint32_t get_number_of_processed_requests() const
+    {
+        return state_->num_processed.load();
+    }
+
+    void set_number_of_processed_requests(uint32_t num_processed)
+    {
+        state_->num_processed = num_processed;
+    }
+
+    /**
+     * @brief Set the result of the last request.
+     *
+     * @param is_failed  True if the driver method threw an exception.
+     * @param message  Exception message or result of get_error().  Truncated
+     *     to MAX_MESSAGE_LENGTH - 1 characters.
+     */
+    void set_result(bool is_failed, const std::string &message)
+    {
+        const size_t length =
+            std::min(message.size(), MAX_MESSAGE_LENGTH - 1);
+        std::memcpy(state_->message, message.data(), length);
+        state_->message[length] = '\0';
+        state_->is_failed = is_failed;
+    }
+
+    bool is_failed() const
+    {
+        return state_->is_failed.load();
+    }
+
+    std::string get_message() const
+    {
+        return std::string(state_->message);
+    }
+
+    void record_call(double duration_s)
+    {
+        record(duration_s,
+               state_->num_calls,
+               state_->total_call_ns,
+               state_->max_call_ns);
+    }
+
+    void record_lock_wait(double duration_s)
+    {
+        record(duration_s,
+               state_->num_lock_waits,
+               state_->total_lock_wait_ns,
+               state_->max_lock_wait_ns);
+    }
+
+    RemoteDriverStatistics get_statistics() const
+    {
+        RemoteDriverStatistics stats;
+        stats.num_calls = state_->num_calls;
+        if (stats.num_calls > 0)
+        {
+            stats.mean_call_duration_s =
+                state_->total_call_ns * 1e-9 / stats.num_calls;
+        }
+        stats.max_call_duration_s = state_->max_call_ns * 1e-9;
+        stats.num_lock_waits = state_->num_lock_waits;
+        stats.total_lock_wait_s = state_->total_lock_wait_ns * 1e-9;
+        stats.max_lock_wait_s = state_->max_lock_wait_ns * 1e-9;
+        return stats;
+    }
+
+private:
+    //! @brief Data shared between the processes.
+    struct State
+    {
+        //! ID of the newest request (upper 32 bits) and its command.
+        std::atomic<uint64_t> request{0};
+        std::atomic<uint32_t> num_processed{0};
+        std::atomic<bool> is_failed{false};
+        char message[MAX_MESSAGE_LENGTH] = {};
+
+        // each statistic is only written by one side
+        std::atomic<uint64_t> num_calls{0};
+        std::atomic<uint64_t> total_call_ns{0};
+        std::atomic<uint64_t> max_call_ns{0};
+        std::atomic<uint64_t> num_lock_waits{0};
+        std::atomic<uint64_t> total_lock_wait_ns{0};
+        std::atomic<uint64_t> max_lock_wait_ns{0};
+    };
+
+    // zero-initialised shared memory is a valid State
+    SharedMemorySegment<State> state_;
+
+    static void record(double duration_s,
+                       std::atomic<uint64_t> &count,
+                       std::atomic<uint64_t> &total_ns,
+                       std::atomic<uint64_t> &max_ns)
+    {
+        const uint64_t ns = static_cast<uint64_t>(duration_s * 1e9);
+        count++;
+        total_ns += ns;
+        if (ns > max_ns.load())
+        {
+            max_ns = ns;
+        }
+    }
+};
+
+/**
+ * @brief Driver which forwards all calls to a driver in another process.
+ *
+ * Use this as the driver of the RobotBackend when the actual driver should not
+ * run in the process of the backend, e.g. because it is implemented in Python:
+ * In the process of the backend, a Python driver would have to acquire the GIL
+ * in every call from the real-time thread and would thus compete with the
+ * user's Python code for it.  Instead, run the driver in its own process with
+ * a RemoteRobotDriverServer.
+ *
+ * Each call of a driver method is one round trip through shared memory (see
+ * RemoteDriverChannel).  If the other process does not answer a call within
+ * `call_timeout_s` or its driver throws an exception, the error is reported by
+ * get_error(), so the backend shuts down with a driver error.  Timing
+ * statistics of the calls are provided by get_statistics().
+ */
+template <typename Action, typename Observation>
+class RemoteRobotDriver : public RobotDriver<Action, Observation>
+{
+public:
+    typedef RemoteDriverChannel<Action, Observation> Channel;
+
+    /**
+     * @param shared_memory_prefix  Prefix for the shared memory IDs.  Has to
+     *     match the one of the RemoteRobotDriverServer.
+     * @param call_timeout_s  Maximum duration of a call of apply_action(),
+     *     get_latest_observation(), get_error() or shutdown().
+     * @param history_length  Number of actions/observations kept in the shared
+     *     memory.
+     */
+    RemoteRobotDriver(const std::string &shared_memory_prefix,
+                      double call_timeout_s = 0.1,
+                      size_t history_length = 16)
+        : channel_(shared_memory_prefix, true, history_length),
+          call_timeout_s_(call_timeout_s)
+    {
+    }
+
+    /**
+     * @brief Initialize the remote driver.
+     *
+     * Waits until the server process is running, so the backend can be
+     * started before it.
+     *
+     * @throws std::runtime_error if the remote driver fails to initialize.
+     */
+    void initialize() override
+    {
+        if (!call(Channel::INITIALIZE, std::numeric_limits<double>::infinity()))
+        {
+            throw std::runtime_error(error_);
+        }
+    }
+
+    Action apply_action(const Action &desired_action) override
+    {
+        channel_.desired_action->append(desired_action);
+        if (!error_.empty() || !call(Channel::APPLY_ACTION, call_timeout_s_))
+        {
+            return desired_action;
+        }
+        return channel_.applied_action->newest_element();
+    }
+
+    Observation get_latest_observation() override
+    {
+        if (error_.empty() && call(Channel::GET_OBSERVATION, call_timeout_s_))
+        {
+            latest_observation_ = channel_.observation->newest_element();
+        }
+        return latest_observation_;
+    }
+
+    std::string get_error() override
+    {
+        if (error_.empty() && call(Channel::GET_ERROR, call_timeout_s_))
+        {
+            return channel_.get_message();
+        }
+        return error_;
+    }
+
+    void shutdown() override
+    {
+        // also try after errors, to bring the robot into a safe state
+        call(Channel::SHUTDOWN, call_timeout_s_);
+    }
+
+    //! @brief Get timing statistics of the calls (from both processes).
+    RemoteDriverStatistics get_statistics() const
+    {
+        return channel_.get_statistics();
+    }
+
+private:
+    Channel channel_;
+    double call_timeout_s_;
+    //! @brief Set on the first failed call, all later calls are skipped.
+    std::string error_;
+    Observation latest_observation_ = Observation();
+
+    bool call(typename Channel::Command command, double timeout_s)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        const uint32_t request_id = channel_.set_request(command);
+        channel_.request_doorbell->ring();
+
+        // Responses to earlier requests that timed out may still arrive, so
+        // wait for the response with the ID of this request.
+        for (;;)
+        {
+            uint32_t sequence = channel_.response_doorbell->get_sequence();
+            if (channel_.get_number_of_processed_requests() == request_id)
+            {
+                break;
+            }
+
+            const double remaining_s =
+                timeout_s - std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+            if (remaining_s <= 0 ||
+                !channel_.response_doorbell->wait(sequence, remaining_s))
+            {
+                error_ = "Remote driver did not respond in time.";
+                return false;
+            }
+        }
+
+        channel_.record_call(std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count());
+
+        if (channel_.is_failed())
+        {
+            error_ = "Remote driver failed: " + channel_.get_message();
+            return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Serves the requests of a RemoteRobotDriver with an actual driver.
+ *
+ * Runs in the process of the driver.  The shared memory is created by the
+ * RemoteRobotDriver, so that has to be constructed first.  Requests that were
+ * sent before the server was started are processed as well.
+ */
+template <typename Action, typename Observation>
+class RemoteRobotDriverServer
+{
+public:
+    typedef RemoteDriverChannel<Action, Observation> Channel;
+
+    /**
+     * @param shared_memory_prefix  Prefix for the shared memory IDs.
+     * @param driver  The driver to which the requests are forwarded.
+     * @throws std::runtime_error if the shared memory does not exist.
+     */
+    RemoteRobotDriverServer(
+        const std::string &shared_memory_prefix,
+        std::shared_ptr<RobotDriver<Action, Observation>> driver)
+        : channel_(shared_memory_prefix, false, 0),
+          driver_(driver),
+          is_shutdown_(false)
+    {
+    }
+
+    /**
+     * @brief Process one request.
+     *
+     * @param timeout_s  Maximum time to wait for a request.
+     * @return True if a request was processed, false on timeout.
+     */
+    bool process_request(
+        double timeout_s = std::numeric_limits<double>::infinity())
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (;;)
+        {
+            uint32_t sequence = channel_.request_doorbell->get_sequence();
+            if (channel_.get_request_id() !=
+                channel_.get_number_of_processed_requests())
+            {
+                break;
+            }
+
+            const double remaining_s =
+                timeout_s - std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+            if (remaining_s <= 0 ||
+                !channel_.request_doorbell->wait(sequence, remaining_s))
+            {
+                return false;
+            }
+        }
+
+        typename Channel::Command command;
+        const uint32_t request_id = channel_.get_request(&command);
+
+        try
+        {
+            std::string message;
+            switch (command)
+            {
+                case Channel::INITIALIZE:
+                    driver_->initialize();
+                    break;
+                case Channel::APPLY_ACTION:
+                    channel_.applied_action->append(driver_->apply_action(
+                        channel_.desired_action->newest_element()));
+                    break;
+                case Channel::GET_OBSERVATION:
+                    channel_.observation->append(
+                        driver_->get_latest_observation());
+                    break;
+                case Channel::GET_ERROR:
+                    message = driver_->get_error();
+                    break;
+                case Channel::SHUTDOWN:
+                    driver_->shutdown();
+                    is_shutdown_ = true;
+                    break;
+                default:
+                    throw std::runtime_error("Invalid command.");
+            }
+            channel_.set_result(false, message);
+        }
+        catch (const std::exception &e)
+        {
+            channel_.set_result(true, e.what());
+        }
+
+        // echo the ID, so the backend side can tell which request the
+        // response belongs to
+        channel_.set_number_of_processed_requests(request_id);
+        channel_.response_doorbell->ring();
+        return true;
+    }
+
+    //! @brief Process requests until the driver is shut down.
+    void run()
+    {
+        while (!is_shutdown_)
+        {
+            process_request();
+        }
+    }
+
+    //! @brief True once the shutdown request was processed.
+    bool is_shutdown() const
+    {
+        return is_shutdown_;
+    }
+
+    /**
+     * @brief Report the time a driver call waited for a lock.
+     *
+     * For drivers that need to acquire a lock shared with other code of the
+     * process (e.g. the GIL for drivers implemented in Python), so contention
+     * shows up in the statistics.
+     */
+    void record_lock_wait(double duration_s)
+    {
+        channel_.record_lock_wait(duration_s);
+    }
+
+    //! @brief See RemoteRobotDriver::get_statistics().
+    RemoteDriverStatistics get_statistics() const
+    {
+        return channel_.get_statistics();
+    }
+
+private:
+    Channel channel_;
+    std::shared_ptr<RobotDriver<Action, Observation>> driver_;
+    bool is_shutdown_;
+};
+
+}  // namespace robot_interfaces
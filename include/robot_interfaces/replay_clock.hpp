@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief Clock for replaying recorded data with the original timing.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace robot_interfaces
+{
+//! @brief Timing of the replay of recorded data.
+enum class ReplayMode
+{
+    //! @brief Replay with the timing of the recording.
+    REAL_TIME,
+    //! @brief Replay with the timing of the recording, scaled by a factor.
+    SCALED_TIME,
+    //! @brief Do not wait at all, replay as fast as the consumer can handle.
+    AS_FAST_AS_POSSIBLE
+};
+
+/**
+ * @brief Pace the replay of recorded data according to its timestamps.
+ *
+ * The first call of wait_until() defines the reference: it returns
+ * immediately and its timestamp is mapped to the current time.  Subsequent
+ * calls block until the time corresponding to the given timestamp is reached.
+ */
+class ReplayClock
+{
+public:
+    /**
+     * @param mode  Replay mode.
+     * @param speed  Speed factor for ReplayMode::SCALED_TIME (e.g. 2 for
+     *     replaying twice as fast as recorded).  Ignored in the other modes.
+     */
+    ReplayClock(ReplayMode mode = ReplayMode::REAL_TIME, double speed = 1.0)
+        : mode_(mode), speed_(speed), is_started_(false)
+    {
+        if (mode_ == ReplayMode::REAL_TIME)
+        {
+            speed_ = 1.0;
+        }
+        else if (mode_ == ReplayMode::SCALED_TIME && !(speed_ > 0))
+        {
+            throw std::invalid_argument("Replay speed must be positive.");
+        }
+    }
+
+    //! @brief Restart, i.e. the next call of wait_until() sets the reference.
+    void reset()
+    {
+        is_started_ = false;
+    }
+
+    /**
+     * @brief Block until the time of the given recorded timestamp is reached.
+     *
+     * @param recorded_time_s  Timestamp of the recorded data in seconds.
+     */
+    void wait_until(double recorded_time_s)
+    {
+        if (mode_ == ReplayMode::AS_FAST_AS_POSSIBLE)
+        {
+            return;
+        }
+
+        if (!is_started_)
+        {
+            start_time_ = std::chrono::steady_clock::now();
+            recorded_start_time_s_ = recorded_time_s;
+            is_started_ = true;
+            return;
+        }
+
+        const std::chrono::duration<double> offset(
+            (recorded_time_s - recorded_start_time_s_) / speed_);
+        std::this_thread::sleep_until(
+            start_time_ +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                offset));
+    }
+
+private:
+    ReplayMode mode_;
+    double speed_;
+    bool is_started_;
+    std::chrono::steady_clock::time_point start_time_;
+    double recorded_start_time_s_;
+};
+
+}  // namespace robot_interfaces
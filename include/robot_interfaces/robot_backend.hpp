@@ -12,6 +12,8 @@
 #include <atomic>
 #include <cmath>
 #include <cstdint>
+#include <limits>
+#include <stdexcept>
 
 #include <pybind11/embed.h>
 
@@ -21,7 +23,12 @@
 
 #include <signal_handler/signal_handler.hpp>
 
+#include <robot_interfaces/action_hold_policy.hpp>
+#include <robot_interfaces/action_limiter.hpp>
+#include <robot_interfaces/action_trajectory.hpp>
+#include <robot_interfaces/doorbell.hpp>
 #include <robot_interfaces/loggable.hpp>
+#include <robot_interfaces/observation_filter.hpp>
 #include <robot_interfaces/robot_data.hpp>
 #include <robot_interfaces/robot_driver.hpp>
 #include <robot_interfaces/status.hpp>
@@ -87,7 +94,8 @@ public:
           max_number_of_actions_(max_number_of_actions),
           is_shutdown_requested_(false),
           max_action_repetitions_(0),
-          termination_reason_(TerminationReason::NOT_TERMINATED)
+          termination_reason_(TerminationReason::NOT_TERMINATED),
+          trajectory_queue_(robot_data->trajectory)
     {
         signal_handler::SignalHandler::initialize();
 
@@ -96,8 +104,77 @@ public:
         thread_->create_realtime_thread(&RobotBackend::loop, this);
     }
 
+    //! @brief Tag type to select the lockstep constructor.
+    struct LockstepMode
+    {
+        /**
+         * @brief Duration of one step [s].
+         *
+         * The steps are not related to wall-clock time in lockstep mode, so
+         * the observation filter (see set_observation_filter()) gets the time
+         * t * step_period_s for the observation of time step t.  The default
+         * corresponds to a control rate of 1 kHz.
+         */
+        double step_period_s = 0.001;
+    };
+
+    /**
+     * @brief Create a backend in lockstep mode.
+     *
+     * In lockstep mode, no background thread is started.  Instead, the
+     * backend steps are executed synchronously in the thread calling step()
+     * (usually done by LockstepRobotFrontend after each appended action).
+     * This avoids the thread handoff of the normal mode, which makes it
+     * possible to run many simulated robots in a single thread.
+     *
+     * The content of robot_data is the same as in non-real-time mode: When
+     * step() returns, all actions that were provided so far are applied and
+     * the observation and status of the following time step are available.
+     *
+     * @param robot_driver  Driver instance for the (simulated) robot.
+     * @param robot_data  Data is send to/retrieved from here.
+     * @param mode  Tag to select lockstep mode (see LockstepMode for
+     *     options).
+     * @param max_number_of_actions  See RobotBackend::max_number_of_actions_.
+     * @throws std::invalid_argument if the step period is not positive.
+     */
+    RobotBackend(std::shared_ptr<RobotDriver<Action, Observation>> robot_driver,
+                 std::shared_ptr<RobotData<Action, Observation>> robot_data,
+                 LockstepMode mode,
+                 const uint32_t max_number_of_actions = 0)
+        : robot_driver_(robot_driver),
+          robot_data_(robot_data),
+          real_time_mode_(false),
+          first_action_timeout_(std::numeric_limits<double>::infinity()),
+          max_number_of_actions_(max_number_of_actions),
+          is_shutdown_requested_(false),
+          max_action_repetitions_(0),
+          termination_reason_(TerminationReason::NOT_TERMINATED),
+          trajectory_queue_(robot_data->trajectory),
+          lockstep_step_period_s_(mode.step_period_s)
+    {
+        if (!(mode.step_period_s > 0))
+        {
+            throw std::invalid_argument("Step period must be positive.");
+        }
+        signal_handler::SignalHandler::initialize();
+
+        loop_is_running_ = true;
+    }
+
     virtual ~RobotBackend()
     {
+        if (!thread_)
+        {
+            // lockstep mode
+            if (loop_is_running_)
+            {
+                request_shutdown();
+                finish();
+            }
+            return;
+        }
+
         // pybind11::gil_scoped_release causes a segfault when the class is used
         // directly from C++ (i.e. no Python interpreter running).
         // Best workaround found so far is to explicitly check if Python is
@@ -146,6 +223,74 @@ public:
         max_action_repetitions_ = max_action_repetitions;
     }
 
+    /**
+     * @brief Set a limiter that is applied to all desired actions.
+     *
+     * The limiter is called with each desired action before it is passed to
+     * the driver (the desired action stored in robot_data is not modified,
+     * the applied action reflects the limited one).  The active limits are
+     * reported in Status::active_action_limits.
+     *
+     * Must be called before the first action is sent.
+     *
+     * @param action_limiter  The limiter.  Pass nullptr to disable limiting.
+     */
+    void set_action_limiter(
+        std::shared_ptr<ActionLimiter<Action, Observation>> action_limiter)
+    {
+        if (robot_data_->desired_action->length() > 0)
+        {
+            throw std::runtime_error(
+                "The action limiter must be set before the first action.");
+        }
+        action_limiter_ = action_limiter;
+    }
+
+    /**
+     * @brief Set the policy for filling in actions that are not provided in
+     *        time.
+     *
+     * Only relevant in real-time mode.  By default (or if nullptr is passed),
+     * the last action is repeated.  See ActionHoldPolicy.
+     *
+     * Must be called before the first action is sent.
+     *
+     * @param action_hold_policy  The policy.
+     */
+    void set_action_hold_policy(
+        std::shared_ptr<ActionHoldPolicy<Action>> action_hold_policy)
+    {
+        if (robot_data_->desired_action->length() > 0)
+        {
+            throw std::runtime_error(
+                "The action hold policy must be set before the first action.");
+        }
+        action_hold_policy_ = action_hold_policy;
+    }
+
+    /**
+     * @brief Set a filter that is applied to all observations.
+     *
+     * The filter is called with each observation of the driver before it is
+     * added to robot_data, so the filtered/derived values are computed once
+     * for all readers.  See ObservationFilter.
+     *
+     * Must be called before the first action is sent.
+     *
+     * @param observation_filter  The filter (use ObservationFilterPipeline to
+     *     combine several).  Pass nullptr to disable filtering.
+     */
+    void set_observation_filter(
+        std::shared_ptr<ObservationFilter<Observation>> observation_filter)
+    {
+        if (robot_data_->desired_action->length() > 0)
+        {
+            throw std::runtime_error(
+                "The observation filter must be set before the first action.");
+        }
+        observation_filter_ = observation_filter;
+    }
+
     void initialize()
     {
         robot_driver_->initialize();
@@ -202,6 +347,76 @@ public:
         return termination_reason_;
     }
 
+    //! @brief Check if the backend runs in lockstep mode (i.e. no thread).
+    bool is_lockstep() const
+    {
+        return !thread_;
+    }
+
+    /**
+     * @brief Execute all pending backend steps in the calling thread.
+     *
+     * Only allowed in lockstep mode.  Applies all desired actions that have
+     * not been applied yet and appends the observation and status of the
+     * next time step afterwards, so the data looks exactly as if the
+     * background loop of the normal mode had caught up.  Returns immediately
+     * if there is no new action or the backend is terminated.
+     *
+     * Must not be called concurrently from several threads.
+     */
+    void step()
+    {
+        if (!is_lockstep())
+        {
+            throw std::runtime_error(
+                "RobotBackend::step() is only allowed in lockstep mode.");
+        }
+
+        while (loop_is_running_)
+        {
+            if (has_shutdown_request())
+            {
+                finish();
+                return;
+            }
+
+            if (has_lockstep_observation_)
+            {
+                // the trajectory may have been extended since the last step
+                trajectory_queue_.update();
+                append_queued_action(lockstep_timeindex_);
+            }
+
+            // like in loop(), the first observation is only acquired once
+            // the first action is available
+            if (robot_data_->desired_action->length() == 0 ||
+                robot_data_->desired_action->newest_timeindex() <
+                    lockstep_timeindex_)
+            {
+                return;
+            }
+
+            if (!has_lockstep_observation_)
+            {
+                if (!update_observation_and_status(lockstep_timeindex_))
+                {
+                    finish();
+                    return;
+                }
+                has_lockstep_observation_ = true;
+            }
+
+            apply_action(lockstep_timeindex_);
+            lockstep_timeindex_++;
+
+            if (!update_observation_and_status(lockstep_timeindex_))
+            {
+                finish();
+                return;
+            }
+        }
+    }
+
 private:
     std::shared_ptr<RobotDriver<Action, Observation>> robot_driver_;
     std::shared_ptr<RobotData<Action, Observation>> robot_data_;
@@ -255,12 +470,35 @@ private:
      */
     uint32_t max_action_repetitions_;
 
-    real_time_tools::CheckpointTimer<6, false> timer_;
+    real_time_tools::CheckpointTimer<7, false> timer_;
 
     std::shared_ptr<real_time_tools::RealTimeThread> thread_;
 
     std::atomic<int> termination_reason_;
 
+    //! @brief Actions submitted in advance via the trajectory time series.
+    ActionTrajectoryQueue<Action> trajectory_queue_;
+
+    //! @brief Optional safety stage between desired and applied action.
+    std::shared_ptr<ActionLimiter<Action, Observation>> action_limiter_;
+    //! @brief Observation passed to the action limiter.
+    Observation limiter_observation_;
+    //! @brief Limits that were active for the previous action.
+    uint32_t active_action_limits_ = 0;
+
+    //! @brief Policy for filling in late actions (repeat if not set).
+    std::shared_ptr<ActionHoldPolicy<Action>> action_hold_policy_;
+
+    //! @brief Optional processing stage for the observations of the driver.
+    std::shared_ptr<ObservationFilter<Observation>> observation_filter_;
+
+    //! @brief Time index of the next action to be applied (lockstep mode).
+    long int lockstep_timeindex_ = 0;
+    //! @brief True if the observation of lockstep_timeindex_ is acquired.
+    bool has_lockstep_observation_ = false;
+    //! @brief See LockstepMode::step_period_s.
+    double lockstep_step_period_s_ = 0;
+
     bool has_shutdown_request() const
     {
         return is_shutdown_requested_ ||
@@ -289,8 +527,7 @@ private:
 
         // wait until first desired_action was received
         // ----------------------------
-        while (!has_shutdown_request() &&
-               !robot_data_->desired_action->wait_for_timeindex(0, 0.1))
+        while (!has_shutdown_request() && !wait_for_desired_action(0, 0.1))
         {
             const double now = real_time_tools::Timer::get_current_time_sec();
             if (now - start_time > first_action_timeout_)
@@ -301,6 +538,8 @@ private:
                 termination_reason_ = TerminationReason::FIRST_ACTION_TIMEOUT;
 
                 robot_data_->status->append(status);
+                robot_data_->status_word->publish(status);
+                robot_data_->observation_doorbell->ring();
 
                 std::cerr << "Error: " << status.get_error_message()
                           << "\nRobot is shut down." << std::endl;
@@ -312,103 +551,271 @@ private:
 
         for (long int t = 0; !has_shutdown_request(); t++)
         {
-            // TODO: figure out latency stuff!!
-
-            Status status;
-
-            if (max_number_of_actions_ > 0 && t >= max_number_of_actions_)
+            if (!update_observation_and_status(t))
             {
-                // TODO this is not really an error
-                status.set_error(Status::ErrorStatus::BACKEND_ERROR,
-                                 "Maximum number of actions reached.");
-                termination_reason_ =
-                    TerminationReason::MAXIMUM_NUMBER_OF_ACTIONS_REACHED;
+                break;
             }
 
-            timer_.start();
-
-            // get latest observation from robot and append it to robot_data_
-            Observation observation = robot_driver_->get_latest_observation();
-            timer_.checkpoint("get observation");
-
-            robot_data_->observation->append(observation);
-            // TODO: for some reason this sometimes takes more than 2 ms
-            // i think this may be due to a non-realtime thread blocking the
-            // timeseries. this is in fact an issue, we might have to
-            // duplicate all the timeseries and have a realtime thread
-            // writing back and forth
-            timer_.checkpoint("append observation");
-
-            // If real time mode is enabled the next action needs to be provided
-            // in time.  If this is not the case, optionally repeat the previous
-            // action or raise an error.
-            if (real_time_mode_ &&
-                robot_data_->desired_action->newest_timeindex() < t)
+            // early exit if destructor has been called
+            while (!has_shutdown_request() && !wait_for_desired_action(t, 0.1))
             {
-                uint32_t action_repetitions =
-                    robot_data_->status->newest_element().action_repetitions;
-
-                if (action_repetitions < max_action_repetitions_)
-                {
-                    robot_data_->desired_action->append(
-                        robot_data_->desired_action->newest_element());
-                    status.action_repetitions = action_repetitions + 1;
-                }
-                else
-                {
-                    // No action provided and number of allowed repetitions
-                    // of the previous action is exceeded --> Error
-                    status.set_error(Status::ErrorStatus::BACKEND_ERROR,
-                                     "Next action was not provided in time");
-                    termination_reason_ =
-                        TerminationReason::NEXT_ACTION_TIMEOUT;
-                }
             }
-
-            std::string driver_error_msg = robot_driver_->get_error();
-            if (!driver_error_msg.empty())
+            if (has_shutdown_request())
             {
-                status.set_error(Status::ErrorStatus::DRIVER_ERROR,
-                                 driver_error_msg);
-                termination_reason_ = TerminationReason::DRIVER_ERROR;
+                break;
             }
 
-            robot_data_->status->append(status);
+            apply_action(t);
+        }
 
-            // if there is an error, shut robot down and stop loop
-            if (status.error_status != Status::ErrorStatus::NO_ERROR)
-            {
-                std::cerr << "Error: " << status.get_error_message()
-                          << "\nRobot is shut down." << std::endl;
-                break;
-            }
-            timer_.checkpoint("status");
+        finish();
+    }
 
-            // early exit if destructor has been called
-            while (!has_shutdown_request() &&
-                   !robot_data_->desired_action->wait_for_timeindex(t, 0.1))
+    /**
+     * @brief First half of a backend step.
+     *
+     * Get the latest observation from the driver, check for errors and append
+     * observation and status of time step t to robot_data_.
+     *
+     * @param t  Current time index.
+     * @return False if there is an error and the robot has to be shut down.
+     */
+    bool update_observation_and_status(long int t)
+    {
+        // TODO: figure out latency stuff!!
+
+        Status status;
+
+        if (max_number_of_actions_ > 0 && t >= max_number_of_actions_)
+        {
+            // TODO this is not really an error
+            status.set_error(Status::ErrorStatus::BACKEND_ERROR,
+                             "Maximum number of actions reached.");
+            termination_reason_ =
+                TerminationReason::MAXIMUM_NUMBER_OF_ACTIONS_REACHED;
+        }
+
+        timer_.start();
+
+        // get latest observation from robot and append it to robot_data_
+        Observation observation = robot_driver_->get_latest_observation();
+        timer_.checkpoint("get observation");
+
+        if (observation_filter_)
+        {
+            // in lockstep mode, time only advances with the steps
+            const double time_s =
+                is_lockstep()
+                    ? t * lockstep_step_period_s_
+                    : real_time_tools::Timer::get_current_time_sec();
+            observation_filter_->filter(observation, time_s);
+        }
+        timer_.checkpoint("filter observation");
+
+        robot_data_->observation->append(observation);
+        if (action_limiter_)
+        {
+            limiter_observation_ = observation;
+        }
+        // TODO: for some reason this sometimes takes more than 2 ms
+        // i think this may be due to a non-realtime thread blocking the
+        // timeseries. this is in fact an issue, we might have to
+        // duplicate all the timeseries and have a realtime thread
+        // writing back and forth
+        timer_.checkpoint("append observation");
+
+        // Actions that were submitted in advance are appended when they are
+        // due, like actions that are provided by the user in time.
+        if (!trajectory_queue_.update())
+        {
+            status.set_error(Status::ErrorStatus::BACKEND_ERROR,
+                             "Trajectory points were lost before they could "
+                             "be read.");
+        }
+        append_queued_action(t);
+        status.trajectory_queue_depth = trajectory_queue_.depth();
+        robot_data_->trajectory_progress->set_number_of_received_points(
+            trajectory_queue_.get_number_of_received_points());
+
+        // If real time mode is enabled the next action needs to be provided
+        // in time.  If this is not the case, optionally repeat the previous
+        // action or raise an error.
+        if (real_time_mode_ &&
+            robot_data_->desired_action->newest_timeindex() < t)
+        {
+            uint32_t action_repetitions =
+                robot_data_->status_word->load().action_repetitions;
+
+            if (action_repetitions < max_action_repetitions_)
             {
+                robot_data_->desired_action->append(
+                    get_hold_action(t, action_repetitions));
+                status.action_repetitions = action_repetitions + 1;
             }
-            if (has_shutdown_request())
+            else
             {
-                break;
+                // No action provided and number of allowed repetitions
+                // of the previous action is exceeded --> Error
+                status.set_error(Status::ErrorStatus::BACKEND_ERROR,
+                                 "Next action was not provided in time");
+                termination_reason_ = TerminationReason::NEXT_ACTION_TIMEOUT;
             }
+        }
 
-            Action desired_action = (*robot_data_->desired_action)[t];
-            timer_.checkpoint("get action");
+        status.active_action_limits = active_action_limits_;
 
-            Action applied_action = robot_driver_->apply_action(desired_action);
-            timer_.checkpoint("apply action");
+        std::string driver_error_msg = robot_driver_->get_error();
+        if (!driver_error_msg.empty())
+        {
+            status.set_error(Status::ErrorStatus::DRIVER_ERROR,
+                             driver_error_msg);
+            termination_reason_ = TerminationReason::DRIVER_ERROR;
+        }
 
-            robot_data_->applied_action->append(applied_action);
-            timer_.checkpoint("append applied action");
+        robot_data_->status->append(status);
+        robot_data_->status_word->publish(status);
+        robot_data_->observation_doorbell->ring();
 
-            if (t % 5000 == 0 && t > 0)
+        // if there is an error, shut robot down and stop loop
+        if (status.error_status != Status::ErrorStatus::NO_ERROR)
+        {
+            std::cerr << "Error: " << status.get_error_message()
+                      << "\nRobot is shut down." << std::endl;
+            return false;
+        }
+        timer_.checkpoint("status");
+
+        return true;
+    }
+
+    /**
+     * @brief Wait until the desired action of step t is available.
+     *
+     * Wakes up as soon as the frontend rings the desired action doorbell of
+     * robot_data_ (works across processes).  Actions from the trajectory
+     * queue are taken into account as well.
+     *
+     * @param t  Time index of the action.
+     * @param timeout_s  Maximum time to wait in seconds.
+     * @return True if the action is available, false on timeout.
+     */
+    bool wait_for_desired_action(long int t, double timeout_s)
+    {
+        Doorbell &doorbell = *robot_data_->desired_action_doorbell;
+        const uint32_t sequence = doorbell.get_sequence();
+        if (has_desired_action(t))
+        {
+            return true;
+        }
+        doorbell.wait(sequence, timeout_s);
+        return has_desired_action(t);
+    }
+
+    //! @brief Check if the desired action of step t is available.
+    bool has_desired_action(long int t)
+    {
+        trajectory_queue_.update();
+        append_queued_action(t);
+        return robot_data_->desired_action->newest_timeindex(false) >= t;
+    }
+
+    /**
+     * @brief Append the action of step t from the trajectory queue if there is
+     *        one and no action is provided for step t yet.
+     */
+    void append_queued_action(long int t)
+    {
+        Action action;
+        if (robot_data_->desired_action->newest_timeindex(false) < t &&
+            trajectory_queue_.pop(t, action))
+        {
+            robot_data_->desired_action->append(action);
+        }
+    }
+
+    /**
+     * @brief Get the action that is used if action t is not provided in time.
+     *
+     * @param t  Current time index.
+     * @param action_repetitions  Number of repetitions in step t - 1.
+     */
+    Action get_hold_action(long int t, uint32_t action_repetitions)
+    {
+        const auto &desired_action = *robot_data_->desired_action;
+
+        if (!action_hold_policy_)
+        {
+            return desired_action.newest_element();
+        }
+
+        // The last action provided by the user is the one before the
+        // repetitions.  The same is done with the status of that step to find
+        // the one before.
+        const long int oldest =
+            std::max(desired_action.oldest_timeindex(),
+                     robot_data_->status->oldest_timeindex());
+        long int last_index = t - 1 - action_repetitions;
+        if (last_index < oldest)
+        {
+            // not in the history anymore, fall back to the newest action
+            last_index = t - 1;
+        }
+        long int previous_index = last_index;
+        if (last_index > oldest)
+        {
+            previous_index =
+                last_index - 1 -
+                (*robot_data_->status)[last_index - 1].action_repetitions;
+            if (previous_index < oldest)
             {
-                timer_.print_statistics();
+                previous_index = last_index;
             }
         }
 
+        const Action last_action = desired_action[last_index];
+        return action_hold_policy_->get_hold_action(
+            last_action,
+            previous_index == last_index ? last_action
+                                         : desired_action[previous_index],
+            last_index - previous_index,
+            t - last_index);
+    }
+
+    /**
+     * @brief Second half of a backend step.
+     *
+     * Apply the desired action of time step t (which has to exist already) and
+     * append the applied action to robot_data_.
+     *
+     * @param t  Current time index.
+     */
+    void apply_action(long int t)
+    {
+        Action desired_action = (*robot_data_->desired_action)[t];
+        if (action_limiter_)
+        {
+            active_action_limits_ =
+                action_limiter_->limit(desired_action, limiter_observation_);
+        }
+        timer_.checkpoint("get action");
+
+        Action applied_action = robot_driver_->apply_action(desired_action);
+        timer_.checkpoint("apply action");
+
+        robot_data_->applied_action->append(applied_action);
+        timer_.checkpoint("append applied action");
+
+        // not in lockstep mode, where this would run in the thread of the
+        // caller (typically many backends per thread)
+        if (!is_lockstep() && t % 5000 == 0 && t > 0)
+        {
+            timer_.print_statistics();
+        }
+    }
+
+    //! @brief Shut down the driver and mark the backend as terminated.
+    void finish()
+    {
         robot_driver_->shutdown();
 
         // If no specific termination reason was set, assume that the shutdown
@@ -9,17 +9,146 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <time_series/multiprocess_time_series.hpp>
 #include <time_series/time_series.hpp>
 
+#include "action_trajectory.hpp"
+#include "doorbell.hpp"
+#include "shared_memory_residency.hpp"
+#include "shared_memory_segment.hpp"
 #include "status.hpp"
+#include "status_word.hpp"
+#include "writer_arbiter.hpp"
 
 namespace robot_interfaces
 {
+/**
+ * @brief History lengths of the time series of RobotData.
+ *
+ * Can be implicitly constructed from a single value which is then used for all
+ * time series.
+ *
+ * Note that the RobotLogger reads desired action, applied action, observation
+ * and status of each time step, so when logging, all of them need a history
+ * length of at least compute_logging_history_length().  The trajectory is not
+ * logged, its history only limits how many points can be submitted ahead of
+ * the backend.
+ */
+struct HistoryLengths
+{
+    size_t desired_action;
+    size_t applied_action;
+    size_t observation;
+    size_t status;
+    size_t trajectory;
+
+    HistoryLengths(size_t history_length = 1000)
+        : desired_action(history_length),
+          applied_action(history_length),
+          observation(history_length),
+          status(history_length),
+          trajectory(history_length)
+    {
+    }
+
+    //! @brief Throw std::invalid_argument if one of the lengths is zero.
+    void validate() const
+    {
+        if (desired_action == 0 || applied_action == 0 || observation == 0 ||
+            status == 0 || trajectory == 0)
+        {
+            throw std::invalid_argument("History lengths must not be zero.");
+        }
+    }
+
+    /**
+     * @brief Minimum history length needed to log without losing steps.
+     *
+     * The logger copies a block of time steps once the last step of the block
+     * is available.  Until it is done, the backend keeps appending, so the
+     * first step of the block must not be overwritten for the time the logger
+     * lags behind.
+     *
+     * @param control_rate_hz  Rate at which the backend appends time steps.
+     * @param log_block_size  Block size of the RobotLogger.
+     * @param max_logger_lag_s  Maximum time in seconds the logger may need for
+     *     copying a block (including scheduling delays).
+     * @return Minimum history length.
+     */
+    static size_t compute_logging_history_length(double control_rate_hz,
+                                                 size_t log_block_size,
+                                                 double max_logger_lag_s)
+    {
+        if (!(control_rate_hz > 0) || !(max_logger_lag_s >= 0))
+        {
+            throw std::invalid_argument(
+                "Control rate must be positive and logger lag must not be "
+                "negative.");
+        }
+        const size_t lag_steps =
+            static_cast<size_t>(std::ceil(control_rate_hz * max_logger_lag_s));
+        // +1 for the newest step which is not part of the logged block
+        return log_block_size + lag_steps + 1;
+    }
+};
+
+/**
+ * @brief Check if T reports the heap memory it uses.
+ *
+ * Types with dynamically sized members (e.g. BatchNJointAction) have to
+ * implement `size_t dynamic_memory_size() const`, returning the number of
+ * bytes allocated by the members, so that RobotData::memory_footprint() can
+ * take it into account.  For all other types only `sizeof(T)` is counted.
+ */
+template <typename T, typename = void>
+struct has_dynamic_memory_size : std::false_type
+{
+};
+
+template <typename T>
+struct has_dynamic_memory_size<
+    T,
+    std::void_t<decltype(std::declval<const T &>().dynamic_memory_size())>>
+    : std::true_type
+{
+};
+
+/**
+ * @brief Approximate memory used by the time series of RobotData in bytes.
+ *
+ * Based on the size of the types (including heap memory reported by
+ * `dynamic_memory_size()`, see has_dynamic_memory_size) and the history
+ * lengths.  MultiProcessRobotData stores the elements in serialised form, so
+ * for it the values are only an approximation.
+ */
+struct MemoryFootprint
+{
+    size_t desired_action = 0;
+    size_t applied_action = 0;
+    size_t observation = 0;
+    size_t status = 0;
+    size_t trajectory = 0;
+
+    size_t total() const
+    {
+        return desired_action + applied_action + observation + status +
+               trajectory;
+    }
+};
+
 /**
  * @brief Contains all the input and output data of the robot.
  *
@@ -59,10 +188,159 @@ public:
     std::shared_ptr<time_series::TimeSeriesInterface<Observation>> observation;
     //! @brief Time series of status messages.
     std::shared_ptr<time_series::TimeSeriesInterface<Status>> status;
+    //! @brief Time series of trajectory segments (see ActionTrajectoryQueue).
+    std::shared_ptr<time_series::TimeSeriesInterface<TrajectoryPoint<Action>>>
+        trajectory;
+    /**
+     * @brief Number of points of `trajectory` read by the backend (see
+     *        TrajectoryProgress).
+     */
+    std::shared_ptr<TrajectoryProgress> trajectory_progress;
+
+    /**
+     * @brief Compact copy of the newest element of `status` which can be
+     *        checked lock-free.
+     */
+    std::shared_ptr<StatusWord> status_word;
+
+    /**
+     * @brief Rung by the frontend when a desired action (or trajectory) is
+     *        appended.
+     */
+    std::shared_ptr<Doorbell> desired_action_doorbell;
+    /**
+     * @brief Rung by the backend when observation and status of a new time
+     *        step are appended.
+     */
+    std::shared_ptr<Doorbell> observation_doorbell;
+
+    /**
+     * @brief Lease of the right to append actions if multiple frontends are
+     *        attached (see RobotFrontend::acquire_writer_lease()).
+     */
+    std::shared_ptr<WriterArbiter> writer_arbiter;
+
+    virtual ~RobotData()
+    {
+    }
+
+    /**
+     * @brief Estimate the memory needed for the given history lengths.
+     *
+     * Can be used to choose the history lengths before creating the data.
+     *
+     * @param history_lengths  History lengths of the time series.
+     * @param action  Example action.  Only relevant for types with dynamically
+     *     sized members (e.g. to pass the number of robots of a batch).
+     * @param observation  Example observation (see `action`).
+     */
+    static MemoryFootprint estimate_memory_footprint(
+        const HistoryLengths &history_lengths,
+        const Action &action = Action(),
+        const Observation &observation = Observation())
+    {
+        TrajectoryPoint<Action> trajectory_point;
+        trajectory_point.action = action;
+
+        MemoryFootprint footprint;
+        footprint.desired_action =
+            history_lengths.desired_action * element_footprint(action);
+        footprint.applied_action =
+            history_lengths.applied_action * element_footprint(action);
+        footprint.observation =
+            history_lengths.observation * element_footprint(observation);
+        footprint.status = history_lengths.status * element_footprint(Status());
+        footprint.trajectory =
+            history_lengths.trajectory * element_footprint(trajectory_point);
+        return footprint;
+    }
+
+    //! @brief Get the history lengths of the time series.
+    HistoryLengths get_history_lengths() const
+    {
+        HistoryLengths history_lengths;
+        history_lengths.desired_action = desired_action->max_length();
+        history_lengths.applied_action = applied_action->max_length();
+        history_lengths.observation = observation->max_length();
+        history_lengths.status = status->max_length();
+        history_lengths.trajectory = trajectory->max_length();
+        return history_lengths;
+    }
+
+    /**
+     * @brief Get the approximate memory used by the time series.
+     *
+     * For types with dynamically sized members, the newest observation and
+     * desired action are used as example, so call this after the first time
+     * step for a meaningful result.
+     */
+    MemoryFootprint memory_footprint() const
+    {
+        return estimate_memory_footprint(
+            get_history_lengths(),
+            desired_action->length() > 0 ? desired_action->newest_element()
+                                         : Action(),
+            observation->length() > 0 ? observation->newest_element()
+                                      : Observation());
+    }
+
+    /**
+     * @brief Check if the data was re-created by a new leader.
+     *
+     * Only relevant for MultiProcessRobotData.  Unlike reattach_if_needed(),
+     * this does not modify the instance, so it can be called while other
+     * threads use it.
+     */
+    virtual bool needs_reattach() const
+    {
+        return false;
+    }
+
+    /**
+     * @brief Re-attach to the data if it was re-created by a new leader.
+     *
+     * Only relevant for MultiProcessRobotData.  Time indices start from zero
+     * again after re-attaching.
+     *
+     * @return True if the data was re-attached.
+     */
+    virtual bool reattach_if_needed()
+    {
+        return false;
+    }
 
 protected:
     // make constructor protected to prevent instantiation of the base class
     RobotData(){};
+
+private:
+    //! @brief Heap memory used by an element (see has_dynamic_memory_size).
+    template <typename T>
+    static size_t dynamic_memory_size(const T &element)
+    {
+        if constexpr (has_dynamic_memory_size<T>::value)
+        {
+            return element.dynamic_memory_size();
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    template <typename A>
+    static size_t dynamic_memory_size(const TrajectoryPoint<A> &point)
+    {
+        return dynamic_memory_size(point.action);
+    }
+
+    //! @brief Memory per element of a time series (element + timestamp).
+    template <typename T>
+    static size_t element_footprint(const T &element)
+    {
+        return sizeof(T) + dynamic_memory_size(element) +
+               sizeof(time_series::Timestamp);
+    }
 };
 
 /**
@@ -82,20 +360,35 @@ public:
     /**
      * @brief Construct the time series for the robot data.
      *
-     * @param history_length History length of the time series.
+     * @param history_lengths History lengths of the time series (a single
+     *     value for all of them or a HistoryLengths instance).
+     * @throws std::invalid_argument if a history length is zero.
      */
-    SingleProcessRobotData(size_t history_length = 1000)
+    SingleProcessRobotData(
+        const HistoryLengths &history_lengths = HistoryLengths())
     {
+        history_lengths.validate();
+
         std::cout << "Using single process time series." << std::endl;
         this->desired_action =
-            std::make_shared<time_series::TimeSeries<Action>>(history_length);
+            std::make_shared<time_series::TimeSeries<Action>>(
+                history_lengths.desired_action);
         this->applied_action =
-            std::make_shared<time_series::TimeSeries<Action>>(history_length);
+            std::make_shared<time_series::TimeSeries<Action>>(
+                history_lengths.applied_action);
         this->observation =
             std::make_shared<time_series::TimeSeries<Observation>>(
-                history_length);
-        this->status =
-            std::make_shared<time_series::TimeSeries<Status>>(history_length);
+                history_lengths.observation);
+        this->status = std::make_shared<time_series::TimeSeries<Status>>(
+            history_lengths.status);
+        this->trajectory =
+            std::make_shared<time_series::TimeSeries<TrajectoryPoint<Action>>>(
+                history_lengths.trajectory);
+        this->trajectory_progress = std::make_shared<TrajectoryProgress>();
+        this->status_word = std::make_shared<StatusWord>();
+        this->desired_action_doorbell = std::make_shared<Doorbell>();
+        this->observation_doorbell = std::make_shared<Doorbell>();
+        this->writer_arbiter = std::make_shared<WriterArbiter>();
     }
 };
 
@@ -117,6 +410,12 @@ public:
     /**
      * @brief Construct the time series for the robot data.
      *
+     * Besides the data, the master maintains an "attach state" in shared
+     * memory with an epoch counter which is incremented each time a master
+     * (re-)creates the data.  It is kept when the master terminates, so
+     * followers of a restarted master notice that the data was re-created
+     * (see reattach_if_needed()).
+     *
      * @param shared_memory_id_prefix Prefix for the shared memory IDs.  Since
      *     each time series needs its own memory ID, the given value is used as
      *     prefix and unique suffixes are appended.  Make sure to use a prefix
@@ -124,59 +423,321 @@ public:
      * @param is_master If set to true, this instance will clear the shared
      *     memory on construction and destruction.  Only one instance should
      *     act as master in a multi-process setup.
-     * @param history_length History length of the time series.  Ignored if
+     * @param history_lengths History lengths of the time series (a single
+     *     value for all of them or a HistoryLengths instance).  Ignored if
      *     `is_master == false`.
+     * @param attach_timeout_s  Only used if `is_master == false`.  Maximum
+     *     time in seconds to wait for the master to create the data (also when
+     *     re-attaching).  With the default of zero, construction fails
+     *     immediately if the data does not exist.
+     * @throws std::runtime_error if `is_master == false` and the data is not
+     *     created by a master within the timeout.
+     * @throws std::invalid_argument if a history length is zero.
      *
      * @todo Make this constructor protected and implement factory methods like
      *     in MultiprocessTimeSeries..
      */
     MultiProcessRobotData(const std::string &shared_memory_id_prefix,
                           bool is_master,
-                          size_t history_length = 1000)
+                          const HistoryLengths &history_lengths =
+                              HistoryLengths(),
+                          double attach_timeout_s = 0.0)
+        : shared_memory_id_prefix_(shared_memory_id_prefix),
+          is_master_(is_master),
+          attach_timeout_s_(attach_timeout_s),
+          epoch_(0)
     {
         std::cout << "Using multi process time series." << std::endl;
 
-        // each time series needs its own shared memory ID, so add unique
-        // suffixes to the given ID.
-        const std::string id_desired_action =
-            shared_memory_id_prefix + "_desired_action";
-        const std::string id_applied_action =
-            shared_memory_id_prefix + "_applied_action";
-        const std::string id_observation =
-            shared_memory_id_prefix + "_observation";
-        const std::string id_status = shared_memory_id_prefix + "_status";
+        if (is_master)
+        {
+            attach_state_ = std::make_unique<SharedMemorySegment<AttachState>>(
+                shared_memory_id_prefix + "_attach_state",
+                SharedMemorySegment<AttachState>::Mode::OPEN_OR_CREATE);
+
+            // followers must not attach while the data is re-created
+            (*attach_state_)->ready = 0;
+            history_lengths.validate();
+            create_data(history_lengths);
+            epoch_ = ++(*attach_state_)->epoch;
+            (*attach_state_)->ready = 1;
+        }
+        else
+        {
+            attach();
+        }
+    }
+
+    ~MultiProcessRobotData()
+    {
+        if (is_master_)
+        {
+            (*attach_state_)->ready = 0;
+        }
+    }
+
+    /**
+     * @brief Remove the attach state from shared memory.
+     *
+     * The attach state is not removed by the master on destruction, so that
+     * followers can detect a restart.  Call this when the whole application
+     * is terminated and no master will be started again.
+     */
+    static void clear_attach_state(const std::string &shared_memory_id_prefix)
+    {
+        SharedMemorySegment<AttachState>::clear_memory(
+            shared_memory_id_prefix + "_attach_state");
+    }
+
+    /**
+     * @brief Prefault and lock the shared memory of the robot data.
+     *
+     * Without this, the pages of the time series are only faulted in when
+     * they are first touched, i.e. in the real-time loop of the backend during
+     * the first seconds of operation.  Call this in each process that accesses
+     * the data in real-time (mappings and locks are per process), after
+     * construction and before starting the robot.  The memory is made resident
+     * again after re-attaching (see reattach_if_needed()).
+     *
+     * @see make_shared_memory_resident()
+     * @throws std::runtime_error if locking fails.
+     */
+    void make_memory_resident(
+        const MemoryResidencyOptions &options = MemoryResidencyOptions())
+    {
+        make_shared_memory_resident(get_shared_memory_ids(), options);
+        residency_options_ =
+            std::make_unique<MemoryResidencyOptions>(options);
+    }
+
+    //! @brief Get how much of the shared memory is resident in RAM.
+    MemoryResidency get_memory_residency() const
+    {
+        return get_shared_memory_residency(get_shared_memory_ids());
+    }
+
+    /**
+     * @brief Get the IDs of the shared memory segments of the data.
+     *
+     * These are the IDs the prefix is extended to (see constructor), to be
+     * used with find_shared_memory_mappings().
+     */
+    std::vector<std::string> get_shared_memory_ids() const
+    {
+        const std::string &prefix = shared_memory_id_prefix_;
+        return {prefix + "_desired_action",
+                prefix + "_applied_action",
+                prefix + "_observation",
+                prefix + "_status",
+                prefix + "_trajectory",
+                prefix + "_trajectory_progress",
+                prefix + "_status_word",
+                prefix + "_desired_action_doorbell",
+                prefix + "_observation_doorbell",
+                prefix + "_writer_arbiter",
+                prefix + "_attach_state"};
+    }
+
+    /**
+     * @brief Get the epoch of the data this instance is attached to.
+     *
+     * The epoch is incremented each time a master (re-)creates the data.
+     */
+    uint64_t get_epoch() const
+    {
+        return epoch_;
+    }
+
+    /**
+     * @brief Check if the master was restarted since attaching.
+     *
+     * Only an atomic load of the epoch, so it is cheap enough to be called in
+     * each step.
+     */
+    bool needs_reattach() const override
+    {
+        return !is_master_ && (*attach_state_)->epoch.load() != epoch_;
+    }
+
+    /**
+     * @brief Re-attach to the data if the master was restarted.
+     *
+     * When a master is restarted, it re-creates the shared memory, so
+     * followers would keep using the memory of the terminated master.  This
+     * checks if the epoch changed (see needs_reattach()) and if so, waits (up
+     * to the attach timeout given in the constructor) for the new master and
+     * attaches to its data.
+     *
+     * Note that the members of RobotData are replaced when re-attaching, so
+     * this must not be called while other threads use this instance.  The
+     * frontends do not call it by themselves, they throw while the data needs
+     * to be re-attached (see needs_reattach()).
+     *
+     * @return True if the data was re-attached.
+     * @throws std::runtime_error if the new master does not get ready within
+     *     the timeout.
+     */
+    bool reattach_if_needed() override
+    {
+        if (!needs_reattach())
+        {
+            return false;
+        }
+        attach();
+        if (residency_options_)
+        {
+            make_shared_memory_resident(get_shared_memory_ids(),
+                                        *residency_options_);
+        }
+        return true;
+    }
+
+private:
+    //! @brief Handshake between master and followers.
+    struct AttachState
+    {
+        //! Incremented each time a master has created the data.
+        std::atomic<uint64_t> epoch{0};
+        //! 1 while the data of the current epoch can be used.
+        std::atomic<uint32_t> ready{0};
+    };
+
+    std::string shared_memory_id_prefix_;
+    bool is_master_;
+    double attach_timeout_s_;
+    uint64_t epoch_;
+    std::unique_ptr<SharedMemorySegment<AttachState>> attach_state_;
+    std::unique_ptr<MemoryResidencyOptions> residency_options_;
+
+    //! @brief Create the shared memory (master only).
+    void create_data(const HistoryLengths &history_lengths)
+    {
+        const std::string &prefix = shared_memory_id_prefix_;
 
         typedef time_series::MultiprocessTimeSeries<Action> TS_Action;
         typedef time_series::MultiprocessTimeSeries<Observation> TS_Observation;
         typedef time_series::MultiprocessTimeSeries<Status> TS_Status;
+        typedef time_series::MultiprocessTimeSeries<TrajectoryPoint<Action>>
+            TS_Trajectory;
 
-        if (is_master)
+        // the master instance is in charge of cleaning the memory
+        time_series::clear_memory(prefix + "_desired_action");
+        time_series::clear_memory(prefix + "_applied_action");
+        time_series::clear_memory(prefix + "_observation");
+        time_series::clear_memory(prefix + "_status");
+        time_series::clear_memory(prefix + "_trajectory");
+
+        this->desired_action = TS_Action::create_leader_ptr(
+            prefix + "_desired_action", history_lengths.desired_action);
+        this->applied_action = TS_Action::create_leader_ptr(
+            prefix + "_applied_action", history_lengths.applied_action);
+        this->observation = TS_Observation::create_leader_ptr(
+            prefix + "_observation", history_lengths.observation);
+        this->status = TS_Status::create_leader_ptr(prefix + "_status",
+                                                    history_lengths.status);
+        this->trajectory = TS_Trajectory::create_leader_ptr(
+            prefix + "_trajectory", history_lengths.trajectory);
+        this->trajectory_progress = TrajectoryProgress::create_leader(
+            prefix + "_trajectory_progress");
+        this->status_word =
+            StatusWord::create_leader(prefix + "_status_word");
+        this->desired_action_doorbell =
+            Doorbell::create_leader(prefix + "_desired_action_doorbell");
+        this->observation_doorbell =
+            Doorbell::create_leader(prefix + "_observation_doorbell");
+        this->writer_arbiter =
+            WriterArbiter::create_leader(prefix + "_writer_arbiter");
+    }
+
+    //! @brief Attach to the shared memory created by the master.
+    void attach()
+    {
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::duration<double>(attach_timeout_s_);
+        while (true)
         {
-            // the master instance is in charge of cleaning the memory
-            time_series::clear_memory(id_desired_action);
-            time_series::clear_memory(id_applied_action);
-            time_series::clear_memory(id_observation);
-            time_series::clear_memory(id_status);
+            if (try_attach())
+            {
+                return;
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                throw std::runtime_error(
+                    "Timeout while waiting for the master of robot data '" +
+                    shared_memory_id_prefix_ + "'.");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
 
-            this->desired_action =
-                TS_Action::create_leader_ptr(id_desired_action, history_length);
-            this->applied_action =
-                TS_Action::create_leader_ptr(id_applied_action, history_length);
-            this->observation = TS_Observation::create_leader_ptr(
-                id_observation, history_length);
-            this->status =
-                TS_Status::create_leader_ptr(id_status, history_length);
+    //! @brief Single attempt of attach().  Returns false if not ready.
+    bool try_attach()
+    {
+        const std::string &prefix = shared_memory_id_prefix_;
+
+        if (!attach_state_)
+        {
+            try
+            {
+                attach_state_ =
+                    std::make_unique<SharedMemorySegment<AttachState>>(
+                        prefix + "_attach_state",
+                        SharedMemorySegment<AttachState>::Mode::OPEN);
+            }
+            catch (const std::runtime_error &)
+            {
+                return false;
+            }
         }
-        else
+
+        AttachState &state = **attach_state_;
+        const uint64_t epoch = state.epoch.load();
+        if (state.ready.load() == 0)
+        {
+            return false;
+        }
+
+        typedef time_series::MultiprocessTimeSeries<Action> TS_Action;
+        typedef time_series::MultiprocessTimeSeries<Observation> TS_Observation;
+        typedef time_series::MultiprocessTimeSeries<Status> TS_Status;
+        typedef time_series::MultiprocessTimeSeries<TrajectoryPoint<Action>>
+            TS_Trajectory;
+
+        try
         {
             this->desired_action =
-                TS_Action::create_follower_ptr(id_desired_action);
+                TS_Action::create_follower_ptr(prefix + "_desired_action");
             this->applied_action =
-                TS_Action::create_follower_ptr(id_applied_action);
+                TS_Action::create_follower_ptr(prefix + "_applied_action");
             this->observation =
-                TS_Observation::create_follower_ptr(id_observation);
-            this->status = TS_Status::create_follower_ptr(id_status);
+                TS_Observation::create_follower_ptr(prefix + "_observation");
+            this->status = TS_Status::create_follower_ptr(prefix + "_status");
+            this->trajectory =
+                TS_Trajectory::create_follower_ptr(prefix + "_trajectory");
+            this->trajectory_progress = TrajectoryProgress::create_follower(
+                prefix + "_trajectory_progress");
+            this->status_word =
+                StatusWord::create_follower(prefix + "_status_word");
+            this->desired_action_doorbell =
+                Doorbell::create_follower(prefix + "_desired_action_doorbell");
+            this->observation_doorbell =
+                Doorbell::create_follower(prefix + "_observation_doorbell");
+            this->writer_arbiter =
+                WriterArbiter::create_follower(prefix + "_writer_arbiter");
+        }
+        catch (const std::exception &)
+        {
+            // master terminated in between
+            return false;
+        }
+
+        // make sure the master did not restart while attaching
+        if (state.ready.load() == 0 || state.epoch.load() != epoch)
+        {
+            return false;
         }
+        epoch_ = epoch;
+        return true;
     }
 };
 
@@ -10,6 +10,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
 #include <robot_interfaces/robot_backend.hpp>
 #include <robot_interfaces/robot_data.hpp>
 #include <robot_interfaces/status.hpp>
@@ -23,26 +27,33 @@ using Timeseries = time_series::TimeSeries<Type>;
 typedef time_series::Index TimeIndex;
 
 /**
- * @brief Communication link between RobotData and the user.
+ * @brief Read-only access to the RobotData.
  *
- * Takes care of communication between the RobotData and the user. It is just a
- * thin wrapper around RobotData to facilitate interaction and also to make sure
- * the user cannot use RobotData in incorrect ways.
+ * Provides all the getters of RobotFrontend but no way to append actions.
+ * Use this for monitoring (dashboards, loggers, ...) while another frontend
+ * controls the robot.  Any number of read-only frontends can be attached to
+ * the same RobotData, they do not interact with the writer arbitration at
+ * all.
  *
  * @tparam Action
  * @tparam Observation
  */
 template <typename Action, typename Observation>
-class RobotFrontend
+class ReadOnlyRobotFrontend
 {
 public:
     typedef time_series::Timestamp TimeStamp;
 
-    RobotFrontend(std::shared_ptr<RobotData<Action, Observation>> robot_data)
+    ReadOnlyRobotFrontend(
+        std::shared_ptr<RobotData<Action, Observation>> robot_data)
         : robot_data_(robot_data)
     {
     }
 
+    virtual ~ReadOnlyRobotFrontend()
+    {
+    }
+
     /**
      * @brief Get observation of time step t.
      *
@@ -54,9 +65,29 @@ public:
      */
     Observation get_observation(const TimeIndex &t) const
     {
+        wait_for_observation(t);
         return (*robot_data_->observation)[t];
     }
 
+    /**
+     * @brief Get observation of time step t, writing it to an existing object.
+     *
+     * Same as get_observation(const TimeIndex&) but for callers which reuse
+     * one observation object over all time steps (e.g. the Python bindings,
+     * where this avoids creating a new object in each step).
+     *
+     * @param t Index of the time step.  If t is in the future, this method will
+     *     block and wait.
+     * @param out  Is set to the observation of time step t.
+     * @throws std::invalid_argument if t is too old and not in the time series
+     *     buffer anymore.
+     */
+    void get_observation(const TimeIndex &t, Observation &out) const
+    {
+        wait_for_observation(t);
+        out = (*robot_data_->observation)[t];
+    }
+
     /**
      * @brief Get the desired action of time step t.
      *
@@ -93,8 +124,25 @@ public:
     {
         return (*robot_data_->applied_action)[t];
     }
+
+    /**
+     * @brief Get the status of time step t.
+     *
+     * Note that the status may exist without the observation of the same time
+     * step, e.g. if the backend stopped because the first action was not
+     * provided in time.
+     *
+     * @param t Index of the time step.  If t is in the future, this method will
+     *     block and wait.
+     * @return The status of time step t.
+     * @throws std::invalid_argument if t is too old and not in the time series
+     *     buffer anymore.
+     */
     Status get_status(const TimeIndex &t) const
     {
+        wait_for_backend([this, t]() {
+            return robot_data_->status->newest_timeindex(false) >= t;
+        });
         return (*robot_data_->status)[t];
     }
 
@@ -122,6 +170,191 @@ public:
         return robot_data_->observation->newest_timeindex();
     }
 
+    /**
+     * @brief Check without blocking if the observation of time step t exists.
+     *
+     * Use this together with get_observation_doorbell() to integrate the
+     * frontend into an event loop (see ReadinessNotifier).
+     */
+    bool has_observation(const TimeIndex &t) const
+    {
+        return robot_data_->observation->newest_timeindex(false) >= t;
+    }
+
+    /**
+     * @brief Get the doorbell which is rung when a new observation exists.
+     *
+     * Note that the doorbell is replaced when the robot data is re-attached
+     * (see RobotData::reattach_if_needed()).
+     */
+    std::shared_ptr<Doorbell> get_observation_doorbell() const
+    {
+        return robot_data_->observation_doorbell;
+    }
+
+    /**
+     * @brief Get the compact form of the latest status.
+     *
+     * This is much cheaper than get_status() as it does not access the status
+     * time series (see StatusWord), so it can be used for frequent checks,
+     * e.g. if an error occurred.  For the error message, use get_status().
+     *
+     * @return Error status, action repetitions and active action limits of
+     *     the newest status.
+     */
+    StatusWord::Value peek_status() const
+    {
+        return robot_data_->status_word->load();
+    }
+
+    /**
+     * @brief Wait until the specified time step is reached.
+     *
+     * @param t Time step until which is waited.
+     * @throws std::invalid_argument if t is too old and not in the time series
+     *     buffer anymore.
+     */
+    void wait_until_timeindex(const TimeIndex &t) const
+    {
+        wait_for_observation(t);
+        // throws if t is too old
+        robot_data_->observation->timestamp_ms(t);
+    }
+
+protected:
+    std::shared_ptr<RobotData<Action, Observation>> robot_data_;
+
+    /**
+     * @brief Wait until the observation of time step t is available.
+     */
+    void wait_for_observation(const TimeIndex &t) const
+    {
+        wait_for_backend([this, t]() {
+            return robot_data_->observation->newest_timeindex(false) >= t;
+        });
+    }
+
+    /**
+     * @brief Wait until the backend produced what is checked by is_done.
+     *
+     * Waits for the observation doorbell rung by the backend (after
+     * observation and status of a step are appended), which has less latency
+     * than the internal waiting of the time series (especially across
+     * processes).
+     *
+     * @param is_done  Returns true when the wait is over.
+     */
+    template <typename Predicate>
+    void wait_for_backend(Predicate is_done) const
+    {
+        throw_if_data_recreated();
+
+        std::shared_ptr<Doorbell> doorbell = robot_data_->observation_doorbell;
+        uint32_t sequence = doorbell->get_sequence();
+        while (!is_done())
+        {
+            doorbell->wait(sequence, 0.1);
+            sequence = doorbell->get_sequence();
+            // a restarted backend would never get there
+            throw_if_data_recreated();
+        }
+    }
+
+    /**
+     * @brief Throw std::runtime_error if the robot data was re-created.
+     *
+     * See RobotData::needs_reattach().  This happens when the backend process
+     * is restarted.  The frontend does not re-attach by itself, as this
+     * replaces the members of the robot data which may be in use by other
+     * threads.  Instead, appending and waiting for new time steps fail until
+     * the user re-attached explicitly with RobotData::reattach_if_needed().
+     */
+    void throw_if_data_recreated() const
+    {
+        if (robot_data_->needs_reattach())
+        {
+            throw std::runtime_error(
+                "Robot data was re-created by a restarted backend.  Call "
+                "reattach_if_needed() on the robot data to use the new data "
+                "(time indices start from zero again).");
+        }
+    }
+};
+
+/**
+ * @brief Communication link between RobotData and the user.
+ *
+ * Takes care of communication between the RobotData and the user. It is just a
+ * thin wrapper around RobotData to facilitate interaction and also to make sure
+ * the user cannot use RobotData in incorrect ways.
+ *
+ * If multiple frontends are attached to the same RobotData, only one of them
+ * may append actions at a time.  This is arbitrated with a lease (see
+ * acquire_writer_lease() and WriterArbiter).  A frontend without lease can
+ * only append while no other frontend holds a lease, so the single-frontend
+ * case works without explicitly acquiring a lease.
+ *
+ * @tparam Action
+ * @tparam Observation
+ */
+template <typename Action, typename Observation>
+class RobotFrontend : public ReadOnlyRobotFrontend<Action, Observation>
+{
+public:
+    RobotFrontend(std::shared_ptr<RobotData<Action, Observation>> robot_data)
+        : ReadOnlyRobotFrontend<Action, Observation>(robot_data)
+    {
+    }
+
+    virtual ~RobotFrontend()
+    {
+        release_writer_lease();
+    }
+
+    /**
+     * @brief Try to become the writer of the robot data.
+     *
+     * See WriterArbiter::acquire().  The lease is renewed with the given
+     * duration each time an action is appended, so as long as the frontend
+     * appends actions at a higher rate, it does not expire.  If the lease is
+     * lost (preempted by a frontend with higher priority or expired), the
+     * append methods throw.
+     *
+     * @param priority  Priority of this frontend.  The lease of a frontend
+     *     with lower priority is preempted.
+     * @param lease_duration_s  Duration after which the lease expires if no
+     *     action is appended.  With the default (infinity), the lease ends
+     *     when it is released, preempted or the process of this frontend
+     *     terminates (also if it crashes).
+     * @return True if the lease was acquired.
+     */
+    bool acquire_writer_lease(
+        uint32_t priority = 0,
+        double lease_duration_s = std::numeric_limits<double>::infinity())
+    {
+        release_writer_lease();
+        writer_token_ =
+            robot_data_->writer_arbiter->acquire(priority, lease_duration_s);
+        lease_duration_s_ = lease_duration_s;
+        return writer_token_ != 0;
+    }
+
+    //! @brief Release the writer lease (if held).
+    void release_writer_lease()
+    {
+        if (writer_token_ != 0)
+        {
+            robot_data_->writer_arbiter->release(writer_token_);
+            writer_token_ = 0;
+        }
+    }
+
+    //! @brief Check if this frontend currently holds the writer lease.
+    bool has_writer_lease() const
+    {
+        return robot_data_->writer_arbiter->is_holder(writer_token_);
+    }
+
     /**
      * @brief Append a desired action to the action time series.
      *
@@ -141,11 +374,132 @@ public:
      *     get_applied_action).
      * @return Time step at which the action will be applied.
      */
-    TimeIndex append_desired_action(const Action &desired_action)
+    virtual TimeIndex append_desired_action(const Action &desired_action)
     {
+        this->throw_if_data_recreated();
         // check error state. do not allow appending actions if there is an
         // error
-        if (robot_data_->status->length() > 0)
+        throw_if_error();
+
+        // since the timeseries has a finite memory, we need to make sure that
+        // by appending new actions we do not forget about actions which have
+        // not been applied yet
+        if (robot_data_->desired_action->length() ==
+                robot_data_->desired_action->max_length() &&
+            robot_data_->desired_action->oldest_timeindex() ==  // FIXME >=
+                this->get_current_timeindex())
+        {
+            std::cout
+                << "you have been appending actions too fast, waiting for "
+                   "RobotBackend to catch up with executing actions."
+                << std::endl;
+            this->wait_until_timeindex(
+                robot_data_->desired_action->oldest_timeindex() + 1);
+        }
+
+        TimeIndex t;
+        append_as_writer([this, &desired_action, &t]() {
+            robot_data_->desired_action->append(desired_action);
+            t = robot_data_->desired_action->newest_timeindex();
+        });
+        robot_data_->desired_action_doorbell->ring();
+        return t;
+    }
+
+    /**
+     * @brief Submit actions for consecutive time steps in advance.
+     *
+     * The actions are put into the trajectory queue of the @ref RobotBackend,
+     * which appends them to the desired actions when their time step is due.
+     * Unlike with append_desired_action(), this does not need any interaction
+     * per time step, so long precomputed motions can be uploaded in one go.
+     * The depth of the queue is reported in Status::trajectory_queue_depth.
+     *
+     * The new segment replaces all pending actions of previously submitted
+     * segments from start_timeindex on (preemption, see
+     * ActionTrajectoryQueue).  Actions for time steps that are already
+     * executed when the segment arrives are skipped.
+     * If an action for a time step is provided via append_desired_action(),
+     * it takes precedence over the queued one.
+     *
+     * Only one frontend should submit trajectories at a time.
+     *
+     * @param actions  Actions for the time steps start_timeindex,
+     *     start_timeindex + 1, ...
+     * @param start_timeindex  Time step of the first action.  Has to be 0 if
+     *     no action was provided yet.
+     * @return Time step of the last action.
+     */
+    virtual TimeIndex append_desired_trajectory(
+        const std::vector<Action> &actions, TimeIndex start_timeindex)
+    {
+        this->throw_if_data_recreated();
+        throw_if_error();
+
+        if (actions.empty())
+        {
+            throw std::invalid_argument("Trajectory must not be empty.");
+        }
+
+        // the backend only starts once the first action is available
+        size_t first = 0;
+        if (robot_data_->desired_action->length() == 0)
+        {
+            if (start_timeindex != 0)
+            {
+                throw std::invalid_argument(
+                    "The first trajectory has to start at time index 0.");
+            }
+            append_as_writer([this, &actions]() {
+                robot_data_->desired_action->append(actions[0]);
+            });
+            robot_data_->desired_action_doorbell->ring();
+            first = 1;
+        }
+
+        auto &trajectory = *robot_data_->trajectory;
+        for (size_t i = first; i < actions.size(); i++)
+        {
+            // make sure not to overwrite points in the time series that were
+            // not read by the backend yet
+            wait_until_trajectory_point_can_be_appended(
+                trajectory.newest_timeindex(false) + 1);
+
+            TrajectoryPoint<Action> point;
+            point.timeindex = start_timeindex + i;
+            point.action = actions[i];
+            point.is_segment_start = (i == first);
+            append_as_writer([&trajectory, &point]() {
+                trajectory.append(point);
+            });
+            robot_data_->desired_action_doorbell->ring();
+        }
+
+        return start_timeindex + actions.size() - 1;
+    }
+
+    /**
+     * @brief Submit actions for the time steps after the last desired action.
+     *
+     * Same as append_desired_trajectory(actions, start_timeindex) with the
+     * trajectory starting directly after the newest desired action.  Note that
+     * pending actions of previous trajectories are not considered here (they
+     * are replaced).
+     */
+    TimeIndex append_desired_trajectory(const std::vector<Action> &actions)
+    {
+        return append_desired_trajectory(
+            actions, robot_data_->desired_action->newest_timeindex(false) + 1);
+    }
+
+protected:
+    using ReadOnlyRobotFrontend<Action, Observation>::robot_data_;
+
+    //! @brief Throw std::runtime_error if the backend reported an error.
+    void throw_if_error() const
+    {
+        // only read the full status (for the message) if there is an error
+        if (robot_data_->status_word->load().has_error())
         {
             const Status status = robot_data_->status->newest_element();
             switch (status.error_status)
@@ -163,41 +517,72 @@ public:
                                              status.get_error_message());
             }
         }
+    }
 
-        // since the timeseries has a finite memory, we need to make sure that
-        // by appending new actions we do not forget about actions which have
-        // not been applied yet
-        if (robot_data_->desired_action->length() ==
-                robot_data_->desired_action->max_length() &&
-            robot_data_->desired_action->oldest_timeindex() ==  // FIXME >=
-                get_current_timeindex())
+    /**
+     * @brief Append via the writer arbiter.
+     *
+     * The lease is checked (and renewed) and append is called under the lock
+     * of the arbiter (see WriterArbiter::write()).
+     *
+     * @param append  Function doing the actual append.
+     * @throws std::runtime_error if this frontend may not append.
+     */
+    template <typename Function>
+    void append_as_writer(Function &&append)
+    {
+        switch (robot_data_->writer_arbiter->write(
+            writer_token_, lease_duration_s_, append))
         {
-            std::cout
-                << "you have been appending actions too fast, waiting for "
-                   "RobotBackend to catch up with executing actions."
-                << std::endl;
-            wait_until_timeindex(
-                robot_data_->desired_action->oldest_timeindex() + 1);
+            case WriterArbiter::WriteAccess::GRANTED:
+                break;
+            case WriterArbiter::WriteAccess::LEASE_REQUIRED:
+                throw std::runtime_error(
+                    "A writer lease is required to append actions, as another "
+                    "frontend holds one.");
+            case WriterArbiter::WriteAccess::LEASE_LOST:
+                writer_token_ = 0;
+                throw std::runtime_error(
+                    "Writer lease was lost (preempted by another frontend or "
+                    "expired).");
         }
-
-        robot_data_->desired_action->append(desired_action);
-        return robot_data_->desired_action->newest_timeindex();
     }
 
     /**
-     * @brief Wait until the specified time step is reached.
+     * @brief Wait until the trajectory point with the given index can be
+     *        appended without overwriting points not read by the backend.
      *
-     * @param t Time step until which is waited.
-     * @throws std::invalid_argument if t is too old and not in the time series
-     *     buffer anymore.
+     * @throws std::runtime_error if the backend reports an error while
+     *     waiting or if the robot data was re-created.
      */
-    void wait_until_timeindex(const TimeIndex &t) const
+    void wait_until_trajectory_point_can_be_appended(TimeIndex point_index)
     {
-        robot_data_->observation->timestamp_ms(t);
+        const TimeIndex max_length = robot_data_->trajectory->max_length();
+        std::shared_ptr<Doorbell> doorbell = robot_data_->observation_doorbell;
+        while (true)
+        {
+            // The backend updates the number of received points before it
+            // rings the doorbell, so get the sequence first to not miss it.
+            const uint32_t sequence = doorbell->get_sequence();
+            const TimeIndex received =
+                robot_data_->trajectory_progress
+                    ->get_number_of_received_points();
+            if (point_index - received < max_length)
+            {
+                return;
+            }
+
+            // a backend that stopped or was restarted would never read the
+            // points
+            this->throw_if_data_recreated();
+            throw_if_error();
+            doorbell->wait(sequence, 0.1);
+        }
     }
 
-protected:
-    std::shared_ptr<RobotData<Action, Observation>> robot_data_;
+private:
+    WriterArbiter::Token writer_token_ = 0;
+    double lease_duration_s_ = 0;
 };
 
 }  // namespace robot_interfaces
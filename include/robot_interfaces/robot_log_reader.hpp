@@ -7,21 +7,50 @@
 #pragma once
 
 #include <fstream>
+#include <sstream>
 #include <vector>
 
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/tuple.hpp>
 #include <cereal/types/vector.hpp>
 
+#include <robot_interfaces/log_manifest.hpp>
+#include <robot_interfaces/record_log.hpp>
 #include <robot_interfaces/robot_log_entry.hpp>
 
 namespace robot_interfaces
 {
+namespace robot_binary_log
+{
+//! @brief Magic of binary log files written by the background RobotLogger.
+constexpr char MAGIC[8] = {'R', 'I', 'L', 'O', 'G', 'B', 'I', 'N'};
+//! @brief Version of the serialization of the log entries.
+constexpr std::uint32_t FORMAT_VERSION = 4;
+/**
+ * @brief Oldest format version that can still be read.
+ *
+ * Older versions only differ in the fields of Status, see
+ * Status::load_legacy().
+ */
+constexpr std::uint32_t MIN_FORMAT_VERSION = 2;
+}  // namespace robot_binary_log
+
 /**
  * @brief Read the data from a robot log file.
  *
  * The data is read from the specified file and stored to the `data` member
  * where it can be accessed.
+ *
+ * Supported are files written with RobotLogger::write_current_buffer_binary()
+ * and files written by the background logger in binary format.  The latter
+ * consist of checksummed records, so if the logger was not stopped properly
+ * (e.g. because the process crashed) all complete records are read and the
+ * incomplete rest is ignored (see `truncated`).  Further segmented logs
+ * can be read by passing the path to the manifest.
+ *
+ * Files written with older format versions (down to
+ * robot_binary_log::MIN_FORMAT_VERSION) are converted while reading.  Fields
+ * that did not exist in the old format are set to zero.
  */
 template <typename Action, typename Observation>
 class RobotBinaryLogReader
@@ -31,6 +60,9 @@ public:
 
     std::vector<LogEntry> data;
 
+    //! @brief True if incomplete data was found at the end of the file.
+    bool truncated = false;
+
     //! @copydoc RobotBinaryLogReader::read_file()
     RobotBinaryLogReader(const std::string &filename)
     {
@@ -40,12 +72,42 @@ public:
     /**
      * @brief Read data from the specified file.
      *
-     * The data is stored to RobotBinaryLogReader::data.
+     * The data is stored to RobotBinaryLogReader::data, replacing data of
+     * previously read files.
      *
-     * @param filename Path to the robot log file.
+     * @param filename Path to the robot log file or to the manifest of a
+     *     segmented log.
      */
     void read_file(const std::string &filename)
     {
+        data.clear();
+        truncated = false;
+
+        if (LogManifest::is_manifest(filename))
+        {
+            LogManifest manifest = LogManifest::read(filename);
+            for (const std::string &segment_file :
+                 manifest.get_segment_paths(filename))
+            {
+                read_single_file(segment_file);
+            }
+        }
+        else
+        {
+            read_single_file(filename);
+        }
+    }
+
+private:
+    //! @brief Read a single log file and append its data.
+    void read_single_file(const std::string &filename)
+    {
+        if (RecordLogReader::has_magic(filename, robot_binary_log::MAGIC))
+        {
+            read_record_file(filename);
+            return;
+        }
+
         std::ifstream infile(filename, std::ios::binary);
         if (!infile)
         {
@@ -56,13 +118,85 @@ public:
 
         std::uint32_t format_version;
         archive(format_version);
+        check_format_version(format_version);
+
+        load_entries(archive, format_version);
+    }
 
-        if (format_version != 2)
+    //! @brief Read a file written by the background logger.
+    void read_record_file(const std::string &filename)
+    {
+        RecordLogReader file(filename, robot_binary_log::MAGIC);
+        check_format_version(file.get_format_version());
+        truncated = truncated || file.is_truncated();
+
+        std::string payload;
+        for (size_t i = 0; i < file.size(); i++)
+        {
+            file.read(i, payload);
+            std::istringstream stream(payload);
+            cereal::BinaryInputArchive archive(stream);
+            load_entries(archive, file.get_format_version());
+        }
+    }
+
+    //! @brief Log entry of a file with an older format version.
+    template <std::uint32_t FormatVersion>
+    struct LegacyLogEntry
+    {
+        LogEntry entry;
+
+        template <class Archive>
+        void serialize(Archive &archive)
+        {
+            archive(entry.timeindex, entry.timestamp);
+            entry.status.load_legacy(archive, FormatVersion);
+            archive(entry.observation,
+                    entry.desired_action,
+                    entry.applied_action);
+        }
+    };
+
+    static void check_format_version(std::uint32_t format_version)
+    {
+        if (format_version < robot_binary_log::MIN_FORMAT_VERSION ||
+            format_version > robot_binary_log::FORMAT_VERSION)
         {
             throw std::runtime_error("Incompatible log file format.");
         }
+    }
+
+    //! @brief Load a vector of log entries and append them to data.
+    void load_entries(cereal::BinaryInputArchive &archive,
+                      std::uint32_t format_version)
+    {
+        switch (format_version)
+        {
+            case 2:
+                load_legacy_entries<2>(archive);
+                break;
+            case 3:
+                load_legacy_entries<3>(archive);
+                break;
+            default:
+            {
+                std::vector<LogEntry> entries;
+                archive(entries);
+                data.insert(data.end(), entries.begin(), entries.end());
+                break;
+            }
+        }
+    }
 
-        archive(data);
+    template <std::uint32_t FormatVersion>
+    void load_legacy_entries(cereal::BinaryInputArchive &archive)
+    {
+        std::vector<LegacyLogEntry<FormatVersion>> entries;
+        archive(entries);
+        for (const auto &legacy_entry : entries)
+        {
+            data.push_back(legacy_entry.entry);
+        }
     }
 };
 
@@ -8,21 +8,31 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
 
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/tuple.hpp>
 #include <cereal/types/vector.hpp>
 
+#include <robot_interfaces/columnar_log.hpp>
+#include <robot_interfaces/log_manifest.hpp>
 #include <robot_interfaces/loggable.hpp>
 #include <robot_interfaces/robot_data.hpp>
+#include <robot_interfaces/record_log.hpp>
 #include <robot_interfaces/robot_log_entry.hpp>
+#include <robot_interfaces/robot_log_reader.hpp>
 #include <robot_interfaces/status.hpp>
+#include <robot_interfaces/text_log_writer.hpp>
 
 namespace robot_interfaces
 {
@@ -30,9 +40,18 @@ namespace robot_interfaces
  * @brief Log robot data (observations, actions, status) to file.
  *
  * Logs for each time step the time index, timestamp, and the values
- * Observation, Action, and Status.  The data is written to a text file, one
- * line per time step with values separated by spaces.  This format can easily
- * be read e.g. with NumPy or Pandas.
+ * Observation, Action, and Status.  Different file formats are supported (see
+ * RobotLogger::Format):
+ *
+ *  - Text: One line per time step with values separated by spaces.  This
+ *    format can easily be read e.g. with NumPy or Pandas.
+ *  - Columnar: Compressed, column-oriented binary format (see
+ *    columnar_log.hpp).  Much smaller than the text format and single columns
+ *    can be read efficiently with ColumnarLogReader.
+ *  - Binary: Serialized RobotLogEntry objects, which can be read with
+ *    RobotBinaryLogReader.  When written by the background logger, each block
+ *    is stored as a checksummed record (see record_log.hpp), so in case of a
+ *    crash all blocks that were written completely can be recovered.
  *
  * There are two different ways of using the logger:
  *
@@ -53,24 +72,42 @@ namespace robot_interfaces
  *     constraints are violated.
  *     Use the `start()` and `stop()` methods for this.
  *
- * @tparam Action  Type of the robot action.  Must derive from Loggable.
- * @tparam Observation  Type of the robot observation.  Must derive from
- *                      Loggable.
+ * Independent of this, `write_snapshot()` can be used at any time (also while
+ * the logger is running) to save the latest time steps, e.g. the last few
+ * seconds before an incident.  The steps are copied to preallocated memory in
+ * one pass and then written to the file by a separate thread, so neither the
+ * robot nor the background logger is paused.
+ *
+ * @tparam Action  Type of the robot action.  Must provide the methods of
+ *                 Loggable (see is_loggable).
+ * @tparam Observation  Type of the robot observation.  Must provide the
+ *                      methods of Loggable (see is_loggable).
  */
 template <typename Action, typename Observation>
 class RobotLogger
 {
 public:
-    // Verify that the template types are based on Loggable.
-    static_assert(std::is_base_of<Loggable, Action>::value,
-                  "Action must derive from Loggable");
-    static_assert(std::is_base_of<Loggable, Observation>::value,
-                  "Observation must derive from Loggable");
-    static_assert(std::is_base_of<Loggable, Status>::value,
-                  "Status must derive from Loggable");
+    // Verify that the template types provide the Loggable methods.
+    static_assert(is_loggable<Action>::value,
+                  "Action must implement the methods of Loggable");
+    static_assert(is_loggable<Observation>::value,
+                  "Observation must implement the methods of Loggable");
+    static_assert(is_loggable<Status>::value,
+                  "Status must implement the methods of Loggable");
 
     typedef RobotLogEntry<Action, Observation> LogEntry;
 
+    //! @brief File formats supported by the background logger.
+    enum class Format
+    {
+        //! @brief Space-separated text file, one line per time step.
+        TEXT,
+        //! @brief Compressed columnar format (see columnar_log.hpp).
+        COLUMNAR,
+        //! @brief Serialized log entries in checksummed records.
+        BINARY
+    };
+
     /**
      * @brief Initialize logger.
      *
@@ -92,6 +129,11 @@ public:
     virtual ~RobotLogger()
     {
         stop();
+
+        if (snapshot_thread_.joinable())
+        {
+            snapshot_thread_.join();
+        }
     }
 
     /**
@@ -100,11 +142,60 @@ public:
      * @see stop()
      * @param filename The name of the log file.  Existing files will be
      *     overwritten!
+     * @param format  Format of the log file.
      */
-    void start(const std::string &filename)
+    void start(const std::string &filename, Format format = Format::TEXT)
     {
         stop_was_called_ = false;
         output_file_name_ = filename;
+        format_ = format;
+        is_segmented_ = false;
+        thread_ = std::thread(&RobotLogger<Action, Observation>::loop, this);
+    }
+
+    /**
+     * @brief Start logging in the background, splitting the log into segments.
+     *
+     * Like start() but instead of writing everything to one file, a new file
+     * ("segment") is started whenever the current one exceeds the given size
+     * or duration.  This allows recording for an unbounded duration, while
+     * completed segments can already be moved/read.
+     *
+     * Segments are named `<prefix>_<start time index>.<ext>` where the start
+     * time index is the time index of the first time step in the segment and
+     * the extension depends on the format ("txt" or "col").  Each segment is a
+     * complete log file with its own header.  Additionally a manifest
+     * `<prefix>.manifest` is written, listing all segments (see LogManifest).
+     * It can be passed to ColumnarLogReader to read all segments as one
+     * continuous log.
+     *
+     * Segments are switched at the boundaries of the blocks that are written
+     * by the logger, so the actual segment size may be slightly bigger than
+     * the limit.
+     *
+     * @param prefix  Path prefix for the segment files and the manifest.
+     *     Existing files will be overwritten!
+     * @param format  Format of the segment files.
+     * @param max_segment_size  Maximum size of a segment in bytes.  Set to
+     *     zero to disable size-based rotation.
+     * @param max_segment_duration_s  Maximum duration of a segment in seconds.
+     *     Set to zero to disable time-based rotation.
+     */
+    void start_segmented(const std::string &prefix,
+                         Format format = Format::COLUMNAR,
+                         size_t max_segment_size = 100 * 1024 * 1024,
+                         double max_segment_duration_s = 0)
+    {
+        stop_was_called_ = false;
+        segment_prefix_ = prefix;
+        format_ = format;
+        is_segmented_ = true;
+        max_segment_size_ = max_segment_size;
+        max_segment_duration_s_ = max_segment_duration_s;
+
+        manifest_ = LogManifest();
+        manifest_.format = get_format_name(format);
+
         thread_ = std::thread(&RobotLogger<Action, Observation>::loop, this);
     }
 
@@ -128,8 +219,23 @@ public:
 
         if (still_running)
         {
-            append_robot_data_to_file(index_, block_size_);
+            // write all steps that are not yet logged (if the logger lagged
+            // behind, this can be more than one block)
+            const long int newest_index =
+                logger_data_->observation->newest_timeindex();
+            long int end_index = index_;
+            do
+            {
+                end_index = append_block(end_index, block_size_);
+            } while (end_index < newest_index);
+
+            if (is_segmented_)
+            {
+                close_segment(end_index);
+            }
         }
+
+        close_log_file();
     }
 
     /**
@@ -191,6 +297,7 @@ public:
         }
 
         append_robot_data_to_file(start_index, end_index - start_index);
+        text_writer_.reset();
     }
 
     void write_current_buffer_binary(const std::string filename,
@@ -228,6 +335,408 @@ public:
         std::vector<LogEntry> log_data;
         log_data.reserve(block_size);
 
+        for_each_log_entry(start_index,
+                           block_size,
+                           [&log_data](LogEntry &entry) {
+                               log_data.push_back(entry);
+                           });
+
+        std::ofstream outfile(filename, std::ios::binary);
+        cereal::BinaryOutputArchive archive(outfile);
+
+        // add version information to the output file (this can be used while
+        // loading when the data format changes
+        const std::uint32_t format_version = robot_binary_log::FORMAT_VERSION;
+
+        archive(format_version, log_data);
+    }
+
+    /**
+     * @brief Write current content of robot data to a columnar log file.
+     *
+     * Same as write_current_buffer() but using the compressed columnar format
+     * (see columnar_log.hpp).  The file can be read with ColumnarLogReader.
+     *
+     * @param filename  Path to the log file.  Existing files will be
+     *     overwritten!
+     * @param start_index  Time index at which to start logging.
+     * @param end_index  Time index at which to stop logging (exclusive).  If
+     *     negative, the newest time index is used.
+     * @throw std::runtime_error If called while the logger thread is running.
+     */
+    void write_current_buffer_columnar(const std::string filename,
+                                       long int start_index = 0,
+                                       long int end_index = -1)
+    {
+        if (is_running_)
+        {
+            throw std::runtime_error(
+                "RobotLogger is currently running.  Call stop() first.");
+        }
+
+        if (logger_data_->observation->length() == 0)
+        {
+            std::cout
+                << "Warning: RobotLogger buffer is empty.  Nothing to write."
+                << std::endl;
+            return;
+        }
+
+        long int t = logger_data_->observation->newest_timeindex();
+        if (end_index < 0)
+        {
+            end_index = t;
+        }
+        else
+        {
+            end_index = std::min(t, end_index);
+        }
+
+        ColumnarLogWriter writer(filename,
+                                 construct_columns(get_layout_entry()));
+        for_each_log_entry(
+            start_index, end_index - start_index, [&](LogEntry &entry) {
+                append_entry_to_columnar_log(entry, writer, columnar_row_);
+            });
+    }
+
+    /**
+     * @brief Preallocate memory for snapshots of up to max_steps time steps.
+     *
+     * Call this during initialisation, so write_snapshot() does not need to
+     * allocate memory when it is called.  Waits for the pending snapshot to
+     * be written (see wait_for_snapshot()).
+     *
+     * @param max_steps  Maximum number of time steps of a snapshot.
+     */
+    void allocate_snapshot(size_t max_steps)
+    {
+        wait_for_snapshot();
+        snapshot_.reserve(max_steps);
+    }
+
+    /**
+     * @brief Set the number of steps excluded from snapshots for safety.
+     *
+     * When the buffer is full, the backend drops the oldest step with each
+     * new step.  To not lose the copied steps, snapshots start this number of
+     * steps after the oldest step.  Set it to the number of steps the backend
+     * may add while a snapshot is copied.  Default is 10.
+     */
+    void set_snapshot_margin(size_t num_steps)
+    {
+        snapshot_margin_ = num_steps;
+    }
+
+    /**
+     * @brief Save the latest time steps to a file without pausing the robot.
+     *
+     * Copies the latest `num_steps` complete time steps (or all steps that
+     * are in the buffer, if there are less) of all time series of the robot
+     * data to the snapshot memory and then writes them to the file in a
+     * separate thread.  Unlike write_current_buffer(), this can be called
+     * while the logger is running.
+     *
+     * The range of time steps is determined once at the beginning, so the
+     * entries of the snapshot are consistent across observation, actions and
+     * status.  If the buffer is full, the oldest steps (see
+     * set_snapshot_margin()) are not included, as they may be dropped while
+     * the snapshot is taken.  If steps are dropped nevertheless, the snapshot
+     * starts with the oldest step that could be copied (the time index of
+     * each step is part of the log entries).
+     *
+     * The file has the same content as the ones written by
+     * write_current_buffer(), write_current_buffer_columnar() or
+     * write_current_buffer_binary(), depending on `format`.  Only one
+     * snapshot can be written at a time, so a pending snapshot is waited for
+     * before the new one is taken.
+     *
+     * @param filename  Path to the log file.  Existing files will be
+     *     overwritten!
+     * @param num_steps  Maximum number of time steps.  To save the last N
+     *     seconds, pass N times the control rate.  If greater than the size
+     *     allocated with allocate_snapshot(), memory is allocated.
+     * @param format  Format of the log file.
+     * @return Number of time steps in the snapshot.  If zero, no file is
+     *     written.
+     * @throw std::runtime_error If the robot data changes too fast to take a
+     *     consistent copy, or if writing the previous snapshot failed.
+     */
+    size_t write_snapshot(const std::string &filename,
+                          size_t num_steps,
+                          Format format = Format::BINARY)
+    {
+        wait_for_snapshot();
+
+        snapshot_.reserve(num_steps);
+        copy_snapshot(num_steps);
+
+        if (snapshot_.empty())
+        {
+            std::cout << "Warning: RobotLogger buffer is empty.  Nothing to "
+                         "write."
+                      << std::endl;
+            return 0;
+        }
+
+        snapshot_thread_ =
+            std::thread(&RobotLogger<Action, Observation>::write_snapshot_file,
+                        this,
+                        filename,
+                        format);
+
+        return snapshot_.size();
+    }
+
+    /**
+     * @brief Wait until the pending snapshot is written to the file.
+     *
+     * Returns immediately if there is no pending snapshot.
+     *
+     * @throw std::runtime_error If writing the snapshot failed.
+     */
+    void wait_for_snapshot()
+    {
+        if (snapshot_thread_.joinable())
+        {
+            snapshot_thread_.join();
+        }
+
+        if (snapshot_error_)
+        {
+            std::exception_ptr error = snapshot_error_;
+            snapshot_error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Get the columns used in the columnar log format.
+     *
+     * There is one column for the time index, one for the timestamp and one
+     * for each field of Status, Observation and the applied and desired
+     * Action.  Column names are constructed like in the header of the text
+     * format, e.g. "observation_position".
+     *
+     * The widths of the columns are taken from default-constructed actions
+     * and observations.  For types whose size is only known at run time (e.g.
+     * BatchNJointAction), use the overload taking a log entry.
+     */
+    static std::vector<ColumnInfo> construct_columns()
+    {
+        return construct_columns(LogEntry());
+    }
+
+    /**
+     * @brief Get the columns of the columnar log format for entries like the
+     *     given one.
+     *
+     * @param entry  Log entry from which the widths of the columns are taken.
+     */
+    static std::vector<ColumnInfo> construct_columns(LogEntry entry)
+    {
+        std::vector<ColumnInfo> columns;
+        columns.push_back({"timeindex", 1, ColumnEncoding::DELTA});
+        columns.push_back({"timestamp", 1, ColumnEncoding::DELTA});
+
+        append_loggable_columns("status", entry.status, columns);
+        append_loggable_columns("observation", entry.observation, columns);
+        append_loggable_columns(
+            "applied_action", entry.applied_action, columns);
+        append_loggable_columns(
+            "desired_action", entry.desired_action, columns);
+
+        return columns;
+    }
+
+private:
+    std::thread thread_;
+
+    std::shared_ptr<robot_interfaces::RobotData<Action, Observation>>
+        logger_data_;
+
+    int block_size_;
+    long int index_;
+
+    std::atomic<bool> stop_was_called_;
+    std::atomic<bool> is_running_;
+
+    std::unique_ptr<TextLogWriter> text_writer_;
+    std::string output_file_name_;
+
+    Format format_ = Format::TEXT;
+    std::unique_ptr<ColumnarLogWriter> columnar_writer_;
+    std::unique_ptr<RecordLogWriter> binary_writer_;
+    //! @brief Buffer for one row of the columnar log.
+    std::vector<double> columnar_row_;
+
+    //! @brief Whether the log is split into segments (see start_segmented()).
+    bool is_segmented_ = false;
+    std::string segment_prefix_;
+    size_t max_segment_size_ = 0;
+    double max_segment_duration_s_ = 0;
+    LogManifest manifest_;
+    std::chrono::steady_clock::time_point segment_start_time_;
+
+    //! @brief Time steps of the latest snapshot (see write_snapshot()).
+    std::vector<LogEntry> snapshot_;
+    //! @brief See set_snapshot_margin().
+    size_t snapshot_margin_ = 10;
+    //! @brief Thread writing the snapshot to file.
+    std::thread snapshot_thread_;
+    //! @brief Exception thrown while writing the snapshot.
+    std::exception_ptr snapshot_error_;
+
+    /**
+     * @brief Create output_file_name_ and write the header.
+     *
+     * Existing files are overwritten.
+     */
+    void open_log_file()
+    {
+        switch (format_)
+        {
+            case Format::TEXT:
+                write_header_to_file();
+                break;
+            case Format::COLUMNAR:
+                columnar_writer_ = std::make_unique<ColumnarLogWriter>(
+                    output_file_name_, construct_columns(get_layout_entry()));
+                break;
+            case Format::BINARY:
+                binary_writer_ = std::make_unique<RecordLogWriter>(
+                    output_file_name_,
+                    robot_binary_log::MAGIC,
+                    robot_binary_log::FORMAT_VERSION);
+                break;
+        }
+    }
+
+    //! @brief Write remaining data and close the file of a binary format.
+    void close_log_file()
+    {
+        text_writer_.reset();
+        if (columnar_writer_)
+        {
+            columnar_writer_->close();
+            columnar_writer_.reset();
+        }
+        if (binary_writer_)
+        {
+            binary_writer_->close();
+            binary_writer_.reset();
+        }
+    }
+
+    //! @brief Get name of the format, as used in the manifest.
+    static std::string get_format_name(Format format)
+    {
+        switch (format)
+        {
+            case Format::TEXT:
+                return "text";
+            case Format::COLUMNAR:
+                return "columnar";
+            case Format::BINARY:
+                return "binary";
+        }
+        return "unknown";
+    }
+
+    //! @brief Start a new segment beginning at the given time index.
+    void open_segment(long int start_index)
+    {
+        std::string extension;
+        switch (format_)
+        {
+            case Format::TEXT:
+                extension = ".txt";
+                break;
+            case Format::COLUMNAR:
+                extension = ".col";
+                break;
+            case Format::BINARY:
+                extension = ".bin";
+                break;
+        }
+        output_file_name_ = LogManifest::get_segment_path(
+            segment_prefix_, start_index, extension);
+        open_log_file();
+        segment_start_time_ = std::chrono::steady_clock::now();
+
+        manifest_.segments.push_back(
+            {start_index, -1, LogManifest::get_filename(output_file_name_)});
+        manifest_.write(LogManifest::get_manifest_path(segment_prefix_));
+    }
+
+    //! @brief Complete the current segment.
+    void close_segment(long int end_index)
+    {
+        close_log_file();
+
+        if (manifest_.segments.empty())
+        {
+            return;
+        }
+        manifest_.segments.back().end_timeindex = end_index;
+        manifest_.write(LogManifest::get_manifest_path(segment_prefix_));
+    }
+
+    //! @brief Check if the current segment reached its size or duration limit.
+    bool is_segment_full() const
+    {
+        if (max_segment_size_ > 0)
+        {
+            size_t size = 0;
+            if (columnar_writer_)
+            {
+                size = columnar_writer_->get_bytes_written();
+            }
+            else if (binary_writer_)
+            {
+                size = binary_writer_->get_bytes_written();
+            }
+            else if (text_writer_)
+            {
+                size = text_writer_->get_bytes_written();
+            }
+
+            if (size >= max_segment_size_)
+            {
+                return true;
+            }
+        }
+
+        if (max_segment_duration_s_ > 0)
+        {
+            std::chrono::duration<double> duration =
+                std::chrono::steady_clock::now() - segment_start_time_;
+            if (duration.count() >= max_segment_duration_s_)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Call `func` for the log entries of a block of time steps.
+     *
+     * Time steps which are not in the buffer anymore are skipped (a warning is
+     * printed in this case).
+     *
+     * @param start_index  Time index marking the beginning of the block.
+     * @param block_size  Number of time steps in the block.
+     * @param func  Function that is called with the LogEntry of each time
+     *     step.
+     */
+    template <typename Func>
+    void for_each_log_entry(long int start_index,
+                            long int block_size,
+                            Func func)
+    {
+        LogEntry entry;
         for (long int t = start_index;
              t < std::min(start_index + block_size,
                           logger_data_->observation->newest_timeindex());
@@ -235,15 +744,12 @@ public:
         {
             try
             {
-                LogEntry entry;
                 entry.timeindex = t;
                 entry.applied_action = (*logger_data_->applied_action)[t];
                 entry.desired_action = (*logger_data_->desired_action)[t];
                 entry.observation = (*logger_data_->observation)[t];
                 entry.status = (*logger_data_->status)[t];
                 entry.timestamp = logger_data_->observation->timestamp_s(t);
-
-                log_data.push_back(entry);
             }
             catch (const std::invalid_argument &e)
             {
@@ -261,45 +767,298 @@ public:
                 // same issue happens immediately again as t_oldest may drop out
                 // of the buffer until it is processed in the next iteration.
                 t = t_oldest;
+                continue;
             }
+
+            func(entry);
         }
+    }
 
-        std::ofstream outfile(filename, std::ios::binary);
-        cereal::BinaryOutputArchive archive(outfile);
+    //! @brief Oldest time index that is available in all time series.
+    long int oldest_complete_timeindex()
+    {
+        return std::max({logger_data_->observation->oldest_timeindex(false),
+                         logger_data_->status->oldest_timeindex(false),
+                         logger_data_->applied_action->oldest_timeindex(false),
+                         logger_data_->desired_action->oldest_timeindex(false)});
+    }
 
-        // add version information to the output file (this can be used while
-        // loading when the data format changes
-        const std::uint32_t format_version = 2;
+    /**
+     * @brief Copy the latest time steps to snapshot_.
+     *
+     * The oldest available time index is read once and, if the buffer is
+     * full, the range is clamped to keep snapshot_margin_ steps distance to
+     * it, as these steps may be dropped while the others are copied.  The
+     * range is then copied in one pass from the newest to the oldest step.
+     * If the writer nevertheless overtakes the copy, the copy ends there (all
+     * older steps are dropped as well) and the snapshot starts with the
+     * oldest step that was copied.  This way, the steps copied so far are
+     * never discarded.
+     *
+     * @param num_steps  Maximum number of time steps.
+     */
+    void copy_snapshot(size_t num_steps)
+    {
+        snapshot_.clear();
+        if (logger_data_->observation->length() == 0)
+        {
+            return;
+        }
 
-        archive(format_version, log_data);
+        // the newest step is excluded as its data is not complete yet
+        const long int end_index =
+            logger_data_->observation->newest_timeindex(false);
+        long int oldest_index = oldest_complete_timeindex();
+        if (logger_data_->observation->length() ==
+                logger_data_->observation->max_length() &&
+            oldest_index + static_cast<long int>(snapshot_margin_) <
+                end_index)
+        {
+            oldest_index += snapshot_margin_;
+        }
+        const long int start_index = std::max(
+            end_index - static_cast<long int>(num_steps), oldest_index);
+        if (start_index >= end_index)
+        {
+            return;
+        }
+
+        snapshot_.resize(end_index - start_index);
+        // index of the oldest entry of snapshot_ that was copied
+        size_t first = snapshot_.size();
+        try
+        {
+            for (long int t = end_index - 1; t >= start_index; t--)
+            {
+                LogEntry &entry = snapshot_[first - 1];
+                entry.timeindex = t;
+                entry.applied_action = (*logger_data_->applied_action)[t];
+                entry.desired_action = (*logger_data_->desired_action)[t];
+                entry.observation = (*logger_data_->observation)[t];
+                entry.status = (*logger_data_->status)[t];
+                entry.timestamp = logger_data_->observation->timestamp_s(t);
+                first--;
+            }
+        }
+        catch (const std::invalid_argument &)
+        {
+            // Step t was dropped from the buffer, and so were all older steps.
+            // The time series do not provide a non-throwing access, so this
+            // is the only way to detect it.
+        }
+        snapshot_.erase(snapshot_.begin(), snapshot_.begin() + first);
+
+        if (snapshot_.empty())
+        {
+            throw std::runtime_error(
+                "Robot data changes too fast to take a snapshot.");
+        }
     }
 
-private:
-    std::thread thread_;
+    /**
+     * @brief Write snapshot_ to a file.
+     *
+     * Runs in snapshot_thread_, so it only uses snapshot_ and local writers.
+     * Exceptions are stored in snapshot_error_.
+     */
+    void write_snapshot_file(const std::string filename, Format format)
+    {
+        try
+        {
+            switch (format)
+            {
+                case Format::TEXT:
+                {
+                    TextLogWriter writer(filename);
+                    write_header(writer, snapshot_.front());
+                    for (LogEntry &entry : snapshot_)
+                    {
+                        append_entry_to_text_log(entry, writer);
+                    }
+                    break;
+                }
+                case Format::COLUMNAR:
+                {
+                    ColumnarLogWriter writer(
+                        filename, construct_columns(snapshot_.front()));
+                    std::vector<double> row;
+                    for (LogEntry &entry : snapshot_)
+                    {
+                        append_entry_to_columnar_log(entry, writer, row);
+                    }
+                    break;
+                }
+                case Format::BINARY:
+                {
+                    std::ofstream outfile(filename, std::ios::binary);
+                    if (!outfile)
+                    {
+                        throw std::runtime_error("Failed to open file " +
+                                                 filename);
+                    }
+                    cereal::BinaryOutputArchive archive(outfile);
+                    const std::uint32_t format_version =
+                        robot_binary_log::FORMAT_VERSION;
+                    archive(format_version, snapshot_);
+                    break;
+                }
+            }
+        }
+        catch (...)
+        {
+            snapshot_error_ = std::current_exception();
+        }
+    }
 
-    std::shared_ptr<robot_interfaces::RobotData<Action, Observation>>
-        logger_data_;
+    //! @brief Add one column per field of `loggable` to `columns`.
+    template <typename T>
+    static void append_loggable_columns(const std::string &identifier,
+                                        T &loggable,
+                                        std::vector<ColumnInfo> &columns)
+    {
+        std::vector<std::string> names = loggable.get_name();
+        std::vector<std::vector<double>> data = loggable.get_data();
 
-    int block_size_;
-    long int index_;
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            ColumnInfo column;
+            column.name = identifier + "_" + names[i];
+            column.width = data[i].size();
+            column.encoding = ColumnEncoding::DELTA;
+            columns.push_back(column);
+        }
+    }
 
-    std::atomic<bool> stop_was_called_;
-    std::atomic<bool> is_running_;
+    /**
+     * @brief Append the data of a log entry as row to a columnar log.
+     *
+     * @param entry  The log entry.
+     * @param writer  Writer of the columnar log.
+     * @param row  Buffer for the row (to avoid allocating it for every row).
+     */
+    static void append_entry_to_columnar_log(LogEntry &entry,
+                                             ColumnarLogWriter &writer,
+                                             std::vector<double> &row)
+    {
+        row.clear();
+        row.push_back(static_cast<double>(entry.timeindex));
+        row.push_back(entry.timestamp);
 
-    std::ofstream output_file_;
-    std::string output_file_name_;
+        append_loggable_to_row(entry.status, row);
+        append_loggable_to_row(entry.observation, row);
+        append_loggable_to_row(entry.applied_action, row);
+        append_loggable_to_row(entry.desired_action, row);
+
+        writer.append_row(row);
+    }
+
+    //! @brief Append the values of all fields of `loggable` to `row`.
+    template <typename T>
+    static void append_loggable_to_row(T &loggable, std::vector<double> &row)
+    {
+        for (const std::vector<double> &field : loggable.get_data())
+        {
+            row.insert(row.end(), field.begin(), field.end());
+        }
+    }
+
+    /**
+     * @brief Append a block of time steps as one record to the binary log.
+     */
+    void append_block_to_binary_log(long int start_index, long int block_size)
+    {
+        std::vector<LogEntry> log_data;
+        log_data.reserve(block_size);
+        for_each_log_entry(start_index,
+                           block_size,
+                           [&log_data](LogEntry &entry) {
+                               log_data.push_back(entry);
+                           });
+
+        if (log_data.empty())
+        {
+            return;
+        }
+
+        std::ostringstream payload;
+        {
+            cereal::BinaryOutputArchive archive(payload);
+            archive(log_data);
+        }
+        binary_writer_->append(payload.str(), log_data.front().timeindex);
+    }
+
+    /**
+     * @brief Append a block of time steps to the log file.
+     *
+     * Uses the format that was specified in `start()`.
+     *
+     * @return Time index after the last logged time step.
+     */
+    long int append_block(long int start_index, long int block_size)
+    {
+        // do not log steps for which the data is not complete yet
+        const long int end_index =
+            std::min(start_index + block_size,
+                     logger_data_->observation->newest_timeindex());
+        block_size = std::max(0l, end_index - start_index);
+
+        switch (format_)
+        {
+            case Format::TEXT:
+                append_robot_data_to_file(start_index, block_size);
+                break;
+            case Format::COLUMNAR:
+                for_each_log_entry(
+                    start_index, block_size, [this](LogEntry &entry) {
+                        append_entry_to_columnar_log(
+                            entry, *columnar_writer_, columnar_row_);
+                    });
+                break;
+            case Format::BINARY:
+                append_block_to_binary_log(start_index, block_size);
+                break;
+        }
+
+        return std::max(start_index, end_index);
+    }
+
+    /**
+     * @brief Get an entry with the layout of the logged data.
+     *
+     * The size of some types (e.g. of the batch types) is only known at run
+     * time, so the layout of the log is taken from the newest elements of the
+     * robot data instead of default-constructed values.
+     */
+    LogEntry get_layout_entry() const
+    {
+        LogEntry entry;
+        if (logger_data_->observation->length() > 0)
+        {
+            entry.observation = logger_data_->observation->newest_element();
+        }
+        if (logger_data_->desired_action->length() > 0)
+        {
+            entry.desired_action =
+                logger_data_->desired_action->newest_element();
+            entry.applied_action = entry.desired_action;
+        }
+        return entry;
+    }
 
     /**
      * @brief To get the title of the log file, describing all the
      * information that will be logged in it.
      *
+     * @param entry  Log entry from which the number of values per field is
+     *     taken.
      * @return header The title of the log file.
      */
-    std::vector<std::string> construct_header()
+    static std::vector<std::string> construct_header(LogEntry entry)
     {
-        Action action;
-        Observation observation;
-        Status status;
+        Observation &observation = entry.observation;
+        Action &action = entry.desired_action;
+        Status &status = entry.status;
 
         std::vector<std::string> observation_names = observation.get_name();
         std::vector<std::string> action_names = action.get_name();
@@ -335,7 +1094,7 @@ private:
      * @param field_data The field data
      * @param &header Reference to the header of the log file
      */
-    void append_names_to_header(
+    static void append_names_to_header(
         const std::string &identifier,
         const std::vector<std::string> &field_name,
         const std::vector<std::vector<double>> &field_data,
@@ -365,15 +1124,25 @@ private:
      */
     void write_header_to_file()
     {
-        output_file_.open(output_file_name_);
-        std::ostream_iterator<std::string> string_iterator(output_file_, " ");
-
-        std::vector<std::string> header = construct_header();
-
-        std::copy(header.begin(), header.end(), string_iterator);
-        output_file_ << std::endl;
+        text_writer_ = std::make_unique<TextLogWriter>(output_file_name_);
+        write_header(*text_writer_, get_layout_entry());
+        text_writer_->flush();
+    }
 
-        output_file_.close();
+    /**
+     * @brief Write the header line of the text format.
+     *
+     * @param writer  Writer of the text log.
+     * @param entry  Log entry from which the number of values per field is
+     *     taken.
+     */
+    static void write_header(TextLogWriter &writer, const LogEntry &entry)
+    {
+        for (const std::string &name : construct_header(entry))
+        {
+            writer.write(name);
+        }
+        writer.end_line();
     }
 
     /**
@@ -384,65 +1153,34 @@ private:
      */
     void append_robot_data_to_file(long int start_index, long int block_size)
     {
-        output_file_.open(output_file_name_, std::ios_base::app);
-        output_file_.precision(27);
+        for_each_log_entry(start_index, block_size, [this](LogEntry &entry) {
+            append_entry_to_text_log(entry, *text_writer_);
+        });
 
-        for (long int t = start_index;
-             t < std::min(start_index + block_size,
-                          logger_data_->observation->newest_timeindex());
-             t++)
-        {
-            try
-            {
-                Action applied_action = (*logger_data_->applied_action)[t];
-                Action desired_action = (*logger_data_->desired_action)[t];
-                Observation observation = (*logger_data_->observation)[t];
-                Status status = (*logger_data_->status)[t];
-                auto timestamp = logger_data_->observation->timestamp_s(t);
-
-                output_file_ << t << " " << timestamp << " ";
-                append_field_data_to_file(status.get_data());
-                append_field_data_to_file(observation.get_data());
-                append_field_data_to_file(applied_action.get_data());
-                append_field_data_to_file(desired_action.get_data());
-                output_file_ << std::endl;
-            }
-            catch (const std::invalid_argument &e)
-            {
-                auto t_oldest = logger_data_->observation->oldest_timeindex();
-                auto diff = t_oldest - t;
-
-                std::cout << "Warning: Trying to log time step " << t
-                          << " which is not in the buffer anymore.  Skip "
-                          << diff << " steps to time step " << (t_oldest + 1)
-                          << std::endl;
-
-                // Note that t is incremented in the next iteration, so logging
-                // continues from t_oldest + 1.  This means that one potentially
-                // available step is dropped but it lowers the risk that the
-                // same issue happens immediately again as t_oldest may drop out
-                // of the buffer until it is processed in the next iteration.
-                t = t_oldest;
-            }
-        }
-
-        output_file_.close();
+        // write the block, so it is in the file in case of a crash
+        text_writer_->flush();
     }
 
-    /**
-     * @brief Appends the data corresponding to
-     * every field at the same time index to the log file.
-     *
-     * @param field_data The field data
-     */
-    void append_field_data_to_file(
-        const std::vector<std::vector<double>> &field_data)
+    //! @brief Write one line with the data of the given entry.
+    static void append_entry_to_text_log(LogEntry &entry, TextLogWriter &writer)
     {
-        std::ostream_iterator<double> double_iterator(output_file_, " ");
+        writer.write(entry.timeindex);
+        writer.write(entry.timestamp);
+        append_loggable_to_text_log(entry.status, writer);
+        append_loggable_to_text_log(entry.observation, writer);
+        append_loggable_to_text_log(entry.applied_action, writer);
+        append_loggable_to_text_log(entry.desired_action, writer);
+        writer.end_line();
+    }
 
-        for (auto data : field_data)
+    //! @brief Write the values of all fields of `loggable`.
+    template <typename T>
+    static void append_loggable_to_text_log(T &loggable,
+                                            TextLogWriter &writer)
+    {
+        for (const std::vector<double> &field : loggable.get_data())
         {
-            std::copy(data.begin(), data.end(), double_iterator);
+            writer.write(field);
         }
     }
 
@@ -456,8 +1194,6 @@ private:
     {
         is_running_ = true;
 
-        write_header_to_file();
-
         while (!stop_was_called_ &&
                !(logger_data_->desired_action->length() > 0))
         {
@@ -466,6 +1202,17 @@ private:
 
         index_ = logger_data_->observation->newest_timeindex();
 
+        // open the file only now, as the layout of the log is taken from the
+        // data (see get_layout_entry())
+        if (is_segmented_)
+        {
+            open_segment(index_);
+        }
+        else
+        {
+            open_log_file();
+        }
+
         while (!stop_was_called_)
         {
             if (index_ + block_size_ <=
@@ -475,7 +1222,17 @@ private:
                 auto t1 = std::chrono::high_resolution_clock::now();
 #endif
 
-                append_robot_data_to_file(index_, block_size_);
+                // only rotate if the current segment contains data (the
+                // segment file name is based on its first time index)
+                if (is_segmented_ &&
+                    index_ > manifest_.segments.back().start_timeindex &&
+                    is_segment_full())
+                {
+                    close_segment(index_);
+                    open_segment(index_);
+                }
+
+                append_block(index_, block_size_);
 
                 index_ += block_size_;
 
@@ -10,11 +10,13 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <robot_interfaces/pybind_log_columns.hpp>
 #include <robot_interfaces/sensors/sensor_backend.hpp>
 #include <robot_interfaces/sensors/sensor_data.hpp>
 #include <robot_interfaces/sensors/sensor_driver.hpp>
 #include <robot_interfaces/sensors/sensor_frontend.hpp>
 #include <robot_interfaces/sensors/sensor_log_reader.hpp>
+#include <robot_interfaces/sensors/sensor_log_replay_driver.hpp>
 #include <robot_interfaces/sensors/sensor_logger.hpp>
 
 namespace robot_interfaces
@@ -50,12 +52,37 @@ void create_sensor_bindings(pybind11::module& m)
         .def(pybind11::init<std::string, bool, size_t>(),
              pybind11::arg("shared_memory_id_prefix"),
              pybind11::arg("is_master"),
-             pybind11::arg("history_size") = 1000);
+             pybind11::arg("history_size") = 1000)
+        .def("make_memory_resident",
+             &MultiProcData::make_memory_resident,
+             pybind11::arg("options") = MemoryResidencyOptions(),
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("get_memory_residency", &MultiProcData::get_memory_residency);
 
     pybind11::class_<SensorDriver<ObservationType>,
                      std::shared_ptr<SensorDriver<ObservationType>>>(m,
                                                                      "Driver");
 
+    // module_local as the enum is bound by each sensor module
+    pybind11::enum_<ReplayMode>(m, "ReplayMode", pybind11::module_local())
+        .value("REAL_TIME", ReplayMode::REAL_TIME)
+        .value("SCALED_TIME", ReplayMode::SCALED_TIME)
+        .value("AS_FAST_AS_POSSIBLE", ReplayMode::AS_FAST_AS_POSSIBLE);
+
+    typedef SensorLogReplayDriver<ObservationType> ReplayDriver;
+    pybind11::class_<ReplayDriver,
+                     std::shared_ptr<ReplayDriver>,
+                     SensorDriver<ObservationType>>(
+        m,
+        "LogReplayDriver",
+        "Driver that replays the observations of a sensor log file.")
+        .def(pybind11::init<std::string, ReplayMode, double>(),
+             pybind11::arg("log_file"),
+             pybind11::arg("mode") = ReplayMode::REAL_TIME,
+             pybind11::arg("speed") = 1.0)
+        .def("size", &ReplayDriver::size)
+        .def("is_finished", &ReplayDriver::is_finished);
+
     pybind11::class_<SensorBackend<ObservationType>>(m, "Backend")
         .def(pybind11::init<
              typename std::shared_ptr<SensorDriver<ObservationType>>,
@@ -77,13 +104,23 @@ void create_sensor_bindings(pybind11::module& m)
              pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("get_current_timeindex",
              &SensorFrontend<ObservationType>::get_current_timeindex,
-             pybind11::call_guard<pybind11::gil_scoped_release>());
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("has_observation",
+             &SensorFrontend<ObservationType>::has_observation,
+             pybind11::arg("t"))
+        .def("get_observation_doorbell",
+             &SensorFrontend<ObservationType>::get_observation_doorbell);
 
     pybind11::class_<Logger, std::shared_ptr<Logger>>(m, "Logger")
         .def(pybind11::init<typename std::shared_ptr<BaseData>, size_t>())
         .def("start",
              &Logger::start,
              pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("start_segmented",
+             &Logger::start_segmented,
+             pybind11::arg("prefix"),
+             pybind11::arg("max_segment_duration_s") = 0.0,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("stop",
              &Logger::stop,
              pybind11::call_guard<pybind11::gil_scoped_release>())
@@ -94,14 +131,15 @@ void create_sensor_bindings(pybind11::module& m)
              &Logger::stop_and_save,
              pybind11::call_guard<pybind11::gil_scoped_release>());
 
-    pybind11::class_<LogReader, std::shared_ptr<LogReader>>(m,
-                                                            "LogReader",
-                                                            R"XXX(
+    auto log_reader =
+        pybind11::class_<LogReader, std::shared_ptr<LogReader>>(m,
+                                                                "LogReader",
+                                                                R"XXX(
             LogReader(filename: str)
 
             See :meth:`read_file`
-)XXX")
-        .def(pybind11::init<std::string>())
+)XXX");
+    log_reader.def(pybind11::init<std::string>())
         .def("read_file",
              &LogReader::read_file,
              pybind11::call_guard<pybind11::gil_scoped_release>(),
@@ -111,7 +149,8 @@ void create_sensor_bindings(pybind11::module& m)
 
                 Read data from the specified camera log file.
 
-                The data is stored in :attr:`data` and :attr:`timestamps`.
+                The data is stored in :attr:`data` and :attr:`timestamps`
+                (also available as NumPy array :attr:`timestamps_array`).
 
                 Args:
                     filename (str): Path to the camera log file.
@@ -123,7 +162,35 @@ void create_sensor_bindings(pybind11::module& m)
         .def_readonly("timestamps",
                       &LogReader::timestamps,
                       pybind11::call_guard<pybind11::gil_scoped_release>(),
-                      "List of timestamps of the camera observations.");
+                      "List of timestamps of the camera observations.")
+        .def_property_readonly(
+            "timestamps_array",
+            [](const LogReader& reader) {
+                return log_field_to_array(
+                    reader.timestamps,
+                    [](const double& timestamp) { return timestamp; });
+            },
+            "numpy.ndarray: Timestamps of the camera observations, shape "
+            "(T,).");
+
+    // For simple numeric observation types, provide the observations as a
+    // single NumPy array as well.
+    if constexpr (std::is_arithmetic<ObservationType>::value ||
+                  std::is_base_of<Eigen::MatrixBase<ObservationType>,
+                                  ObservationType>::value)
+    {
+        log_reader.def_property_readonly(
+            "data_array",
+            [](const LogReader& reader) {
+                return log_field_to_array(
+                    reader.data,
+                    [](const ObservationType& observation) -> const auto& {
+                        return observation;
+                    });
+            },
+            "numpy.ndarray: Observations from the log file as array of shape "
+            "(T,) or (T, N) for vector observations.");
+    }
 }
 
 }  // namespace robot_interfaces
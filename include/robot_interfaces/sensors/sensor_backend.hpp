@@ -88,6 +88,7 @@ private:
                 std::cerr << e.what() << std::endl;
             }
             sensor_data_->observation->append(sensor_observation);
+            sensor_data_->observation_doorbell->ring();
         }
     }
 };
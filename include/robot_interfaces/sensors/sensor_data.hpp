@@ -12,7 +12,10 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include <robot_interfaces/doorbell.hpp>
+#include <robot_interfaces/shared_memory_residency.hpp>
 #include <time_series/multiprocess_time_series.hpp>
 #include <time_series/time_series.hpp>
 
@@ -29,6 +32,8 @@ class SensorData
 public:
     //! @brief Time series of the sensor observations.
     std::shared_ptr<time_series::TimeSeriesInterface<Observation>> observation;
+    //! @brief Rung by the backend when an observation is appended.
+    std::shared_ptr<Doorbell> observation_doorbell;
 
 protected:
     // make constructor protected to prevent instantiation of the base class
@@ -54,6 +59,7 @@ public:
         this->observation =
             std::make_shared<time_series::TimeSeries<Observation>>(
                 history_length);
+        this->observation_doorbell = std::make_shared<Doorbell>();
     }
 };
 
@@ -75,6 +81,7 @@ public:
     MultiProcessSensorData(const std::string &shared_memory_id,
                            bool is_master,
                            size_t history_length = 1000)
+        : shared_memory_id_(shared_memory_id)
     {
         if (is_master)
         {
@@ -84,13 +91,49 @@ public:
             this->observation = time_series::MultiprocessTimeSeries<
                 Observation>::create_leader_ptr(shared_memory_id,
                                                 history_length);
+            this->observation_doorbell =
+                Doorbell::create_leader(shared_memory_id + "_doorbell");
         }
         else
         {
             this->observation = time_series::MultiprocessTimeSeries<
                 Observation>::create_follower_ptr(shared_memory_id);
+            this->observation_doorbell =
+                Doorbell::create_follower(shared_memory_id + "_doorbell");
         }
     }
+
+    /**
+     * @brief Prefault and lock the shared memory of the sensor data.
+     *
+     * @see MultiProcessRobotData::make_memory_resident()
+     */
+    void make_memory_resident(
+        const MemoryResidencyOptions &options = MemoryResidencyOptions())
+    {
+        make_shared_memory_resident(get_shared_memory_ids(), options);
+    }
+
+    //! @brief Get how much of the shared memory is resident in RAM.
+    MemoryResidency get_memory_residency() const
+    {
+        return get_shared_memory_residency(get_shared_memory_ids());
+    }
+
+    /**
+     * @brief Get the IDs of the shared memory segments of the data.
+     *
+     * Note that the time series uses the ID itself, so segments of other data
+     * with an ID that starts with this ID followed by an underscore are
+     * matched by find_shared_memory_mappings() as well.
+     */
+    std::vector<std::string> get_shared_memory_ids() const
+    {
+        return {shared_memory_id_, shared_memory_id_ + "_doorbell"};
+    }
+
+private:
+    std::string shared_memory_id_;
 };
 
 }  // namespace robot_interfaces
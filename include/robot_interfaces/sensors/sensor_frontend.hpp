@@ -59,6 +59,22 @@ public:
         return sensor_data_->observation->newest_timeindex();
     }
 
+    //! @brief Check without blocking if the observation of time step t exists.
+    bool has_observation(const TimeIndex t) const
+    {
+        return sensor_data_->observation->newest_timeindex(false) >= t;
+    }
+
+    /**
+     * @brief Get the doorbell which is rung when a new observation exists.
+     *
+     * See ReadinessNotifier.
+     */
+    std::shared_ptr<Doorbell> get_observation_doorbell() const
+    {
+        return sensor_data_->observation_doorbell;
+    }
+
 private:
     std::shared_ptr<SensorData<ObservationType>> sensor_data_;
 };
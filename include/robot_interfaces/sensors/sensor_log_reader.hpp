@@ -12,6 +12,8 @@
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/vector.hpp>
 
+#include <robot_interfaces/log_manifest.hpp>
+
 namespace robot_interfaces
 {
 /**
@@ -45,11 +47,36 @@ public:
     /**
      * @brief Read data from the specified file.
      *
-     * The data is stored to SensorLogReader::data.
+     * The data is stored to SensorLogReader::data, replacing data of
+     * previously read files.
      *
-     * @param filename Path to the sensor log file.
+     * @param filename Path to the sensor log file.  If it is the manifest of
+     *     a segmented log (see SensorLogger::start_segmented()), the data of
+     *     all segments is read.
      */
     void read_file(const std::string &filename)
+    {
+        data.clear();
+        timestamps.clear();
+
+        if (LogManifest::is_manifest(filename))
+        {
+            LogManifest manifest = LogManifest::read(filename);
+            for (const std::string &segment_file :
+                 manifest.get_segment_paths(filename))
+            {
+                read_single_file(segment_file);
+            }
+        }
+        else
+        {
+            read_single_file(filename);
+        }
+    }
+
+private:
+    //! @brief Read a single log file and append its data.
+    void read_single_file(const std::string &filename)
     {
         std::ifstream infile(filename, std::ios::binary);
         if (!infile)
@@ -70,8 +97,8 @@ public:
         std::vector<StampedObservation> stamped_data;
         archive(stamped_data);
 
-        data.reserve(stamped_data.size());
-        timestamps.reserve(stamped_data.size());
+        data.reserve(data.size() + stamped_data.size());
+        timestamps.reserve(timestamps.size() + stamped_data.size());
         for (auto [timestamp, observation] : stamped_data)
         {
             data.push_back(observation);
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Sensor driver that replays observations from a sensor log.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <robot_interfaces/replay_clock.hpp>
+#include "sensor_driver.hpp"
+#include "sensor_log_reader.hpp"
+
+namespace robot_interfaces
+{
+/**
+ * @brief Sensor driver that replays the observations of a sensor log.
+ *
+ * Counterpart of LogReplayDriver for sensors:  The observations of a log
+ * written by SensorLogger are returned one after another, with the timing
+ * given by the ReplayMode.
+ *
+ * Since sensor drivers have no way to signal the end of the data, the last
+ * observation is repeated once the end of the log is reached (at the average
+ * rate of the recording, or every millisecond in
+ * ReplayMode::AS_FAST_AS_POSSIBLE).  Use is_finished() to check for this.
+ *
+ * @tparam Observation Type of the sensor observation.
+ */
+template <typename Observation>
+class SensorLogReplayDriver : public SensorDriver<Observation>
+{
+public:
+    /**
+     * @param log_file  Path to the sensor log file (or manifest of a
+     *     segmented log).
+     * @param mode  Timing of the replay.
+     * @param speed  Speed factor for ReplayMode::SCALED_TIME.
+     */
+    SensorLogReplayDriver(const std::string &log_file,
+                          ReplayMode mode = ReplayMode::REAL_TIME,
+                          double speed = 1.0)
+        : log_(log_file), clock_(mode, speed), index_(0)
+    {
+        if (log_.data.empty())
+        {
+            throw std::runtime_error("Sensor log " + log_file + " is empty.");
+        }
+
+        // period at which the last observation is repeated after the end
+        double period_s = 0.001;
+        if (mode != ReplayMode::AS_FAST_AS_POSSIBLE && log_.data.size() > 1)
+        {
+            // timestamps of the sensor log are in milliseconds
+            period_s = (log_.timestamps.back() - log_.timestamps.front()) /
+                       1000.0 / (log_.data.size() - 1);
+            if (mode == ReplayMode::SCALED_TIME)
+            {
+                period_s /= speed;
+            }
+        }
+        end_period_ = std::chrono::duration<double>(period_s);
+    }
+
+    Observation get_observation() override
+    {
+        if (is_finished())
+        {
+            std::this_thread::sleep_for(end_period_);
+            return log_.data.back();
+        }
+
+        const size_t i = index_++;
+        clock_.wait_until(log_.timestamps[i] / 1000.0);
+        return log_.data[i];
+    }
+
+    //! @brief Get the number of observations in the log.
+    size_t size() const
+    {
+        return log_.data.size();
+    }
+
+    //! @brief Check if all observations of the log have been replayed.
+    bool is_finished() const
+    {
+        return index_ >= log_.data.size();
+    }
+
+private:
+    SensorLogReader<Observation> log_;
+    ReplayClock clock_;
+    std::atomic<size_t> index_;
+    std::chrono::duration<double> end_period_;
+};
+
+}  // namespace robot_interfaces
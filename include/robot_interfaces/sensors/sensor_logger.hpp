@@ -9,8 +9,11 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <fstream>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -18,6 +21,7 @@
 #include <cereal/types/tuple.hpp>
 #include <cereal/types/vector.hpp>
 
+#include <robot_interfaces/log_manifest.hpp>
 #include "sensor_data.hpp"
 
 namespace robot_interfaces
@@ -38,6 +42,11 @@ namespace robot_interfaces
  *   logger.stop_and_save("/tmp/sensordata.log");
  * @endcode
  *
+ * For long recordings, use start_segmented() instead, which writes the buffer
+ * to a new segment file whenever it is full (or a maximum segment duration is
+ * exceeded), so the buffer limit does not limit the duration of the
+ * recording.
+ *
  *
  * @tparam Observation Typ of the observation that is recorded.
  */
@@ -85,9 +94,40 @@ public:
     {
         if (!enabled_)
         {
-            enabled_ = true;
-            buffer_thread_ =
-                std::thread(&SensorLogger<Observation>::loop, this);
+            segment_prefix_.clear();
+            start_thread();
+        }
+    }
+
+    /**
+     * @brief Start logging to a sequence of segment files.
+     *
+     * Whenever the buffer is full, its content is written to a new segment
+     * file `<prefix>_<start time index>.log` and the buffer is cleared.  If
+     * max_segment_duration_s is set, this is also done when the first
+     * observation in the buffer is older than that.  The
+     * segments are listed in the manifest `<prefix>.manifest` (see
+     * LogManifest) which can be passed to SensorLogReader to read all
+     * segments at once.  Remaining observations are written when stop() is
+     * called.
+     *
+     * If the logger is already running, this is a noop.
+     *
+     * @param prefix  Path prefix for the segment files and the manifest.
+     *     Existing files will be overwritten!
+     * @param max_segment_duration_s  Maximum duration of a segment in seconds.
+     *     Set to zero to only start a new segment when the buffer is full.
+     */
+    void start_segmented(const std::string &prefix,
+                         double max_segment_duration_s = 0)
+    {
+        if (!enabled_)
+        {
+            segment_prefix_ = prefix;
+            max_segment_duration_s_ = max_segment_duration_s;
+            manifest_ = LogManifest();
+            manifest_.format = "sensor";
+            start_thread();
         }
     }
 
@@ -102,7 +142,13 @@ public:
         if (buffer_thread_.joinable())
         {
             buffer_thread_.join();
+
+            if (!segment_prefix_.empty() && !buffer_.empty())
+            {
+                write_segment();
+            }
         }
+        segment_prefix_.clear();
     }
 
     //! @brief Clear the log buffer.
@@ -116,11 +162,42 @@ public:
      *
      * @param filename Path to the output file.  Existing files will be
      *     overwritten.
+     * @throw std::runtime_error If the logger was started with
+     *     start_segmented().  Use stop() in this case.
      */
     void stop_and_save(const std::string &filename)
     {
+        if (!segment_prefix_.empty())
+        {
+            throw std::runtime_error(
+                "SensorLogger writes segments.  Use stop() instead.");
+        }
         stop();
+        write_file(filename);
+    }
+
+private:
+    DataPtr sensor_data_;
+    std::vector<StampedObservation> buffer_;
+    size_t buffer_limit_;
+    std::thread buffer_thread_;
+    bool enabled_;
+
+    //! Path prefix of the segment files.  Empty if not logging segmented.
+    std::string segment_prefix_;
+    //! Maximum duration of a segment.  Zero if not limited.
+    double max_segment_duration_s_ = 0;
+    //! Time at which the current segment was started.
+    std::chrono::steady_clock::time_point segment_start_time_;
+    LogManifest manifest_;
+    //! Time index of the first observation in the buffer.
+    time_series::Index buffer_start_timeindex_ = 0;
+    //! Time index of the next observation that will be fetched.
+    time_series::Index next_timeindex_ = 0;
 
+    //! Write the content of the buffer to the given file.
+    void write_file(const std::string &filename)
+    {
         std::ofstream outfile(filename, std::ios::binary);
         cereal::BinaryOutputArchive archive(outfile);
 
@@ -131,17 +208,50 @@ public:
         archive(format_version, buffer_);
     }
 
-private:
-    DataPtr sensor_data_;
-    std::vector<StampedObservation> buffer_;
-    size_t buffer_limit_;
-    std::thread buffer_thread_;
-    bool enabled_;
+    //! Write the buffer to a new segment file and clear it.
+    void write_segment()
+    {
+        const time_series::Index end_timeindex = next_timeindex_;
+        const std::string filename = LogManifest::get_segment_path(
+            segment_prefix_, buffer_start_timeindex_, ".log");
+
+        write_file(filename);
+        buffer_.clear();
+
+        manifest_.segments.push_back({buffer_start_timeindex_,
+                                      end_timeindex,
+                                      LogManifest::get_filename(filename)});
+        manifest_.write(LogManifest::get_manifest_path(segment_prefix_));
+
+        buffer_start_timeindex_ = end_timeindex;
+        segment_start_time_ = std::chrono::steady_clock::now();
+    }
+
+    //! Check if the current segment reached its maximum size or duration.
+    bool is_segment_full() const
+    {
+        if (buffer_.size() >= buffer_limit_)
+        {
+            return true;
+        }
+        return max_segment_duration_s_ > 0 && !buffer_.empty() &&
+               std::chrono::steady_clock::now() - segment_start_time_ >=
+                   std::chrono::duration<double>(max_segment_duration_s_);
+    }
+
+    void start_thread()
+    {
+        enabled_ = true;
+        buffer_thread_ = std::thread(&SensorLogger<Observation>::loop, this);
+    }
 
     //! Get observations from sensor_data_ and add them to the buffer.
     void loop()
     {
         auto t = sensor_data_->observation->oldest_timeindex();
+        buffer_start_timeindex_ = t;
+        next_timeindex_ = t;
+        segment_start_time_ = std::chrono::steady_clock::now();
 
         while (enabled_)
         {
@@ -158,9 +268,17 @@ private:
                           << std::endl;
             }
             t++;
+            next_timeindex_ = t;
 
+            if (!segment_prefix_.empty())
+            {
+                if (is_segment_full())
+                {
+                    write_segment();
+                }
+            }
             // Stop logging if buffer limit is reached
-            if (buffer_.size() >= buffer_limit_)
+            else if (buffer_.size() >= buffer_limit_)
             {
                 std::cerr << "WARNING: SensorLogger buffer limit is reached.  "
                              "Stop logging."
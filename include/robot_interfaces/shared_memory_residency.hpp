@@ -0,0 +1,253 @@
+/**
+ * @file
+ * @brief Prefault, lock and inspect the shared memory mapped by a process.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ *
+ * The time series of MultiProcessRobotData/MultiProcessSensorData are
+ * allocated by the time_series package in POSIX shared memory (i.e. files in
+ * /dev/shm), with pages that are only faulted in when they are first touched.
+ * Without preparation, this first touch happens in the real-time loop.  The
+ * functions here find the mappings of the segments in /proc/self/maps, so
+ * they can be prefaulted and locked right after construction, independent of
+ * who allocated them.
+ */
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// not defined by older kernel headers
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+namespace robot_interfaces
+{
+//! @brief Mapping of a shared memory segment into this process.
+struct SharedMemoryMapping
+{
+    uintptr_t start = 0;
+    uintptr_t end = 0;
+    bool is_writable = false;
+    //! @brief ID of the segment (file name in /dev/shm).
+    std::string shared_memory_id;
+
+    size_t size() const
+    {
+        return end - start;
+    }
+};
+
+//! @brief Options for make_shared_memory_resident().
+struct MemoryResidencyOptions
+{
+    /**
+     * @brief Request transparent hugepages for the mappings.
+     *
+     * Only has an effect if the kernel has hugepages for shared memory enabled
+     * (see /sys/kernel/mm/transparent_hugepage/shmem_enabled, needs to be
+     * "advise" or higher).
+     */
+    bool use_hugepages = false;
+    //! @brief Fault in all pages now instead of on first access.
+    bool prefault = true;
+    //! @brief Lock the pages in RAM (mlock), so they are never swapped out.
+    bool lock = true;
+};
+
+//! @brief Memory usage reported by get_shared_memory_residency().
+struct MemoryResidency
+{
+    //! @brief Number of matching mappings.
+    size_t num_mappings = 0;
+    //! @brief Total size of the mappings in bytes.
+    size_t mapped_bytes = 0;
+    //! @brief Bytes of the mappings that are currently in RAM.
+    size_t resident_bytes = 0;
+};
+
+/**
+ * @brief Find the shared memory segments with the given IDs mapped in this
+ *        process.
+ *
+ * @param shared_memory_ids  A segment matches if its ID is equal to one of
+ *     these or consists of one of these followed by an underscore and a
+ *     suffix (the time_series package stores one time series in several
+ *     segments with such suffixes).  Pass the IDs of the single time series
+ *     and segments, not a common prefix, so that data with a longer prefix
+ *     (e.g. "robot_two" for "robot") is not matched as well.
+ */
+inline std::vector<SharedMemoryMapping> find_shared_memory_mappings(
+    const std::vector<std::string> &shared_memory_ids)
+{
+    const std::string shm_dir = "/dev/shm/";
+
+    std::vector<SharedMemoryMapping> mappings;
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    while (std::getline(maps, line))
+    {
+        // format: "start-end perms offset dev inode path"
+        std::istringstream fields(line);
+        std::string range, perms, offset, device, inode, path;
+        fields >> range >> perms >> offset >> device >> inode;
+        std::getline(fields >> std::ws, path);
+
+        // segments that were removed in the meantime end with " (deleted)"
+        if (path.compare(0, shm_dir.size(), shm_dir) != 0 ||
+            path.find(' ') != std::string::npos)
+        {
+            continue;
+        }
+        const std::string id = path.substr(shm_dir.size());
+        bool is_match = false;
+        for (const std::string &shared_memory_id : shared_memory_ids)
+        {
+            const size_t length = shared_memory_id.size();
+            if (id.compare(0, length, shared_memory_id) == 0 &&
+                (id.size() == length || id[length] == '_'))
+            {
+                is_match = true;
+                break;
+            }
+        }
+        if (!is_match)
+        {
+            continue;
+        }
+
+        SharedMemoryMapping mapping;
+        const size_t dash = range.find('-');
+        mapping.start = std::stoull(range.substr(0, dash), nullptr, 16);
+        mapping.end = std::stoull(range.substr(dash + 1), nullptr, 16);
+        mapping.is_writable = perms.size() > 1 && perms[1] == 'w';
+        mapping.shared_memory_id = id;
+        mappings.push_back(mapping);
+    }
+
+    return mappings;
+}
+
+/**
+ * @brief Prefault and lock the shared memory segments with the given IDs.
+ *
+ * Call this after constructing the robot/sensor data and before starting the
+ * real-time loop.  Locking requires a sufficient limit for locked memory
+ * (see `ulimit -l`) or the CAP_IPC_LOCK capability.
+ *
+ * @param shared_memory_ids  See find_shared_memory_mappings().
+ * @param options  What to do with the mappings.
+ * @return Total size of the mappings in bytes.
+ * @throws std::runtime_error if one of the operations fails.
+ */
+inline size_t make_shared_memory_resident(
+    const std::vector<std::string> &shared_memory_ids,
+    const MemoryResidencyOptions &options)
+{
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+
+    size_t total_size = 0;
+    for (const SharedMemoryMapping &mapping :
+         find_shared_memory_mappings(shared_memory_ids))
+    {
+        void *address = reinterpret_cast<void *>(mapping.start);
+        total_size += mapping.size();
+
+        if (options.use_hugepages &&
+            madvise(address, mapping.size(), MADV_HUGEPAGE) != 0)
+        {
+            throw std::runtime_error("Failed to request hugepages for '" +
+                                     mapping.shared_memory_id +
+                                     "': " + std::strerror(errno));
+        }
+
+        if (options.prefault &&
+            madvise(address,
+                    mapping.size(),
+                    mapping.is_writable ? MADV_POPULATE_WRITE
+                                        : MADV_POPULATE_READ) != 0)
+        {
+            // Kernel before 5.14, touch each page instead.  Pages are
+            // "written" with an atomic no-op, so other processes using the
+            // memory concurrently are not affected.
+            for (uintptr_t page = mapping.start; page < mapping.end;
+                 page += page_size)
+            {
+                char *byte = reinterpret_cast<char *>(page);
+                if (mapping.is_writable)
+                {
+                    __atomic_fetch_add(byte, 0, __ATOMIC_RELAXED);
+                }
+                else
+                {
+                    *static_cast<volatile char *>(byte);
+                }
+            }
+        }
+
+        if (options.lock && mlock(address, mapping.size()) != 0)
+        {
+            throw std::runtime_error(
+                "Failed to lock shared memory '" + mapping.shared_memory_id +
+                "' (check the limit for locked memory, `ulimit -l`): " +
+                std::strerror(errno));
+        }
+    }
+
+    return total_size;
+}
+
+/**
+ * @brief Get how much of the shared memory segments with the given IDs is in
+ *        RAM.
+ *
+ * @param shared_memory_ids  See find_shared_memory_mappings().
+ */
+inline MemoryResidency get_shared_memory_residency(
+    const std::vector<std::string> &shared_memory_ids)
+{
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+
+    MemoryResidency residency;
+    for (const SharedMemoryMapping &mapping :
+         find_shared_memory_mappings(shared_memory_ids))
+    {
+        const size_t num_pages = (mapping.size() + page_size - 1) / page_size;
+        std::vector<unsigned char> pages(num_pages);
+        if (mincore(reinterpret_cast<void *>(mapping.start),
+                    mapping.size(),
+                    pages.data()) != 0)
+        {
+            throw std::runtime_error("Failed to get residency of '" +
+                                     mapping.shared_memory_id +
+                                     "': " + std::strerror(errno));
+        }
+
+        residency.num_mappings++;
+        residency.mapped_bytes += mapping.size();
+        for (unsigned char page : pages)
+        {
+            if (page & 1)
+            {
+                residency.resident_bytes += page_size;
+            }
+        }
+    }
+
+    return residency;
+}
+
+}  // namespace robot_interfaces
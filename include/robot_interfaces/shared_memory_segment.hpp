@@ -0,0 +1,203 @@
+/**
+ * @file
+ * @brief Small POSIX shared memory segment holding a fixed struct.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Object of type T in process memory or in POSIX shared memory.
+ *
+ * Used for the small synchronisation structures of RobotData (see Doorbell,
+ * WriterArbiter) which, unlike the time series, need to be accessed with
+ * atomic operations by several processes.
+ *
+ * The leader creates the segment (resetting an existing one with the same
+ * ID) and removes it again on destruction.  Followers attach to an existing
+ * segment.  See Mode for further options.
+ *
+ * @tparam T  Type of the shared object.  Must be standard layout and valid
+ *     when all bytes are zero (it is zero-initialised by ftruncate).
+ */
+template <typename T>
+class SharedMemorySegment
+{
+    static_assert(std::is_standard_layout<T>::value,
+                  "T must have standard layout.");
+
+public:
+    //! @brief Create the object in the memory of this process.
+    SharedMemorySegment()
+        : local_object_(new T()), object_(local_object_.get()), fd_(-1)
+    {
+    }
+
+    //! @brief How the shared memory segment is opened.
+    enum class Mode
+    {
+        //! Create the segment, replacing an existing one with the same ID.
+        //! It is removed again on destruction.
+        CREATE,
+        //! Open an existing segment.
+        OPEN,
+        //! Open the segment if it exists, otherwise create it.  It is kept
+        //! on destruction, so that its content survives a restart of the
+        //! creating process.
+        OPEN_OR_CREATE
+    };
+
+    /**
+     * @brief Create or attach to the object in shared memory.
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     * @param is_leader  If true, the segment is created, otherwise an
+     *     existing segment is opened.
+     * @throws std::runtime_error if the segment cannot be created/opened.
+     */
+    SharedMemorySegment(const std::string &shared_memory_id, bool is_leader)
+        : SharedMemorySegment(shared_memory_id,
+                              is_leader ? Mode::CREATE : Mode::OPEN)
+    {
+    }
+
+    /**
+     * @brief Create or attach to the object in shared memory.
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     * @param mode  See Mode.
+     * @throws std::runtime_error if the segment cannot be created/opened.
+     */
+    SharedMemorySegment(const std::string &shared_memory_id, Mode mode)
+        : object_(nullptr),
+          shared_memory_id_(shared_memory_id),
+          is_leader_(mode == Mode::CREATE),
+          fd_(-1)
+    {
+        const std::string name = to_shm_name(shared_memory_id);
+        switch (mode)
+        {
+            case Mode::CREATE:
+                shm_unlink(name.c_str());
+                fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+                break;
+            case Mode::OPEN:
+                fd_ = shm_open(name.c_str(), O_RDWR, 0666);
+                break;
+            case Mode::OPEN_OR_CREATE:
+                fd_ = shm_open(name.c_str(), O_CREAT | O_RDWR, 0666);
+                break;
+        }
+        if (fd_ < 0)
+        {
+            throw std::runtime_error("Failed to open shared memory '" + name +
+                                     "': " + std::strerror(errno));
+        }
+
+        // Only grow the segment, as an existing one may already be in use.
+        // Growing zero-fills the new bytes.
+        struct stat file_stat;
+        if (mode != Mode::OPEN && fstat(fd_, &file_stat) == 0 &&
+            file_stat.st_size < static_cast<off_t>(sizeof(T)) &&
+            ftruncate(fd_, sizeof(T)) != 0)
+        {
+            const int error = errno;
+            close(fd_);
+            throw std::runtime_error("Failed to allocate shared memory '" +
+                                     name + "': " + std::strerror(error));
+        }
+
+        // the leader may not have allocated the memory yet
+        if (fstat(fd_, &file_stat) != 0 ||
+            file_stat.st_size < static_cast<off_t>(sizeof(T)))
+        {
+            close(fd_);
+            throw std::runtime_error("Shared memory '" + name +
+                                     "' is not initialised.");
+        }
+
+        void *memory = mmap(
+            nullptr, sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (memory == MAP_FAILED)
+        {
+            const int error = errno;
+            close(fd_);
+            throw std::runtime_error("Failed to map shared memory '" + name +
+                                     "': " + std::strerror(error));
+        }
+
+        // ftruncate zero-initialises the memory
+        object_ = static_cast<T *>(memory);
+    }
+
+    ~SharedMemorySegment()
+    {
+        if (fd_ >= 0)
+        {
+            munmap(object_, sizeof(T));
+            close(fd_);
+            if (is_leader_)
+            {
+                clear_memory(shared_memory_id_);
+            }
+        }
+    }
+
+    SharedMemorySegment(const SharedMemorySegment &) = delete;
+    SharedMemorySegment &operator=(const SharedMemorySegment &) = delete;
+
+    //! @brief Remove the shared memory segment with the given ID.
+    static void clear_memory(const std::string &shared_memory_id)
+    {
+        shm_unlink(to_shm_name(shared_memory_id).c_str());
+    }
+
+    //! @brief True if the object is in shared memory.
+    bool is_shared() const
+    {
+        return fd_ >= 0;
+    }
+
+    T *get() const
+    {
+        return object_;
+    }
+
+    T *operator->() const
+    {
+        return object_;
+    }
+
+    T &operator*() const
+    {
+        return *object_;
+    }
+
+private:
+    std::unique_ptr<T> local_object_;
+    T *object_;
+    std::string shared_memory_id_;
+    bool is_leader_ = false;
+    int fd_;
+
+    static std::string to_shm_name(const std::string &shared_memory_id)
+    {
+        return "/" + shared_memory_id;
+    }
+};
+
+}  // namespace robot_interfaces
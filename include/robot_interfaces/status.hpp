@@ -15,6 +15,8 @@
 
 #include <cereal/types/string.hpp>
 #include <robot_interfaces/loggable.hpp>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -55,6 +57,25 @@ struct Status : public Loggable
         BACKEND_ERROR
     };
 
+    /**
+     * @brief Flags for @ref active_action_limits.
+     *
+     * See ActionLimiter.
+     */
+    enum ActionLimit : uint32_t
+    {
+        //! @brief The desired torque exceeded the torque limit.
+        TORQUE_LIMIT = 1 << 0,
+        //! @brief The desired position was outside of the position limits.
+        POSITION_LIMIT = 1 << 1,
+        //! @brief Velocity damping was added to the torque.
+        VELOCITY_DAMPING = 1 << 2,
+        //! @brief NaN gains were replaced by the default gains.
+        DEFAULT_GAINS = 1 << 3,
+        //! @brief Non-finite torques (NaN or infinity) were replaced by zero.
+        NON_FINITE_TORQUE = 1 << 4
+    };
+
     /**
      * @brief Number of times the current action has been repeated.
      *
@@ -68,6 +89,23 @@ struct Status : public Loggable
      */
     uint32_t action_repetitions = 0;
 
+    /**
+     * @brief Bit mask of the limits that were active for the previous action.
+     *
+     * If an ActionLimiter is set in the RobotBackend, this reports which of
+     * the limits (see @ref ActionLimit) modified the action of the *previous*
+     * time step (t - 1).  The status of time step t is published before the
+     * action of that step is received, so it cannot refer to it.
+     */
+    uint32_t active_action_limits = 0;
+
+    /**
+     * @brief Number of actions that are pending in the trajectory queue.
+     *
+     * See RobotFrontend::append_desired_trajectory().
+     */
+    uint32_t trajectory_queue_depth = 0;
+
     /**
      * @brief Indicates if there is an error and, if yes, in which component.
      *
@@ -127,12 +165,50 @@ struct Status : public Loggable
     template <class Archive>
     void serialize(Archive& archive)
     {
-        archive(action_repetitions, error_status, error_message);
+        archive(action_repetitions,
+                active_action_limits,
+                trajectory_queue_depth,
+                error_status,
+                error_message);
+    }
+
+    /**
+     * @brief Load a status from a binary robot log with an older format.
+     *
+     * The fields of the status were extended in later versions of the binary
+     * robot log format (see robot_binary_log::FORMAT_VERSION).  This loads a
+     * status serialized with the given older format version.  Fields that
+     * did not exist in that version are set to zero.
+     *
+     * @param archive  The input archive.
+     * @param format_version  Format version of the log file.
+     */
+    template <class Archive>
+    void load_legacy(Archive& archive, std::uint32_t format_version)
+    {
+        *this = Status();
+        switch (format_version)
+        {
+            case 2:
+                archive(action_repetitions, error_status, error_message);
+                break;
+            case 3:
+                archive(action_repetitions,
+                        active_action_limits,
+                        error_status,
+                        error_message);
+                break;
+            default:
+                throw std::runtime_error("Incompatible log file format.");
+        }
     }
 
     std::vector<std::string> get_name() override
     {
-        return {"action_repetitions", "error_status"};
+        return {"action_repetitions",
+                "active_action_limits",
+                "trajectory_queue_depth",
+                "error_status"};
     }
 
     std::vector<std::vector<double>> get_data() override
@@ -140,6 +216,8 @@ struct Status : public Loggable
         // FIXME error message cannot be logged because only numeric types are
         // supported
         return {{static_cast<double>(action_repetitions)},
+                {static_cast<double>(active_action_limits)},
+                {static_cast<double>(trajectory_queue_depth)},
                 {static_cast<double>(error_status)}};
     }
 
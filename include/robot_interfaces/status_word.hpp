@@ -0,0 +1,150 @@
+/**
+ * @file
+ * @brief Compact copy of the latest Status that can be read lock-free.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "shared_memory_segment.hpp"
+#include "status.hpp"
+
+namespace robot_interfaces
+{
+/**
+ * @brief The frequently checked fields of the latest Status in one atomic word.
+ *
+ * The backend appends a full Status (including the error message) to the
+ * status time series in each step.  Reading the newest element of that time
+ * series means copying (for multi-process data: deserialising) the whole
+ * struct.  For the checks done all the time, like "is there an error?" before
+ * each append of an action, this is unnecessary, so the backend additionally
+ * publishes error status, action repetitions and active action limits of the
+ * latest status in a single 64 bit word, which readers can load without any
+ * locking.  Only if the word reports an error, the full status with the
+ * message needs to be read from the time series.
+ *
+ * Like Doorbell, the word lives either in process memory or in shared memory
+ * (create_leader() / create_follower()).
+ */
+class StatusWord
+{
+public:
+    //! @brief Unpacked content of the word.
+    struct Value
+    {
+        //! @brief See Status::action_repetitions (saturates at 2^32 - 1).
+        uint32_t action_repetitions = 0;
+        //! @brief See Status::active_action_limits (lowest 16 bits).
+        uint32_t active_action_limits = 0;
+        //! @brief See Status::error_status.
+        Status::ErrorStatus error_status = Status::ErrorStatus::NO_ERROR;
+        //! @brief False if no status was published yet.
+        bool is_valid = false;
+
+        bool has_error() const
+        {
+            return error_status != Status::ErrorStatus::NO_ERROR;
+        }
+    };
+
+    //! @brief Create a status word for use within one process.
+    StatusWord()
+    {
+    }
+
+    /**
+     * @brief Create a status word in shared memory.
+     *
+     * Existing shared memory with the same ID is reset.
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     */
+    static std::shared_ptr<StatusWord> create_leader(
+        const std::string &shared_memory_id)
+    {
+        return std::shared_ptr<StatusWord>(
+            new StatusWord(shared_memory_id, true));
+    }
+
+    /**
+     * @brief Open a status word in shared memory created by create_leader().
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     * @throws std::runtime_error if the shared memory does not exist.
+     */
+    static std::shared_ptr<StatusWord> create_follower(
+        const std::string &shared_memory_id)
+    {
+        return std::shared_ptr<StatusWord>(
+            new StatusWord(shared_memory_id, false));
+    }
+
+    //! @brief Publish the given status (called by the backend).
+    void publish(const Status &status)
+    {
+        state_->word.store(pack(status), std::memory_order_release);
+    }
+
+    //! @brief Get the latest published status.
+    Value load() const
+    {
+        return unpack(state_->word.load(std::memory_order_acquire));
+    }
+
+private:
+    //! @brief Data shared between the processes.
+    struct State
+    {
+        std::atomic<uint64_t> word{0};
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "StatusWord requires lock-free 64 bit atomics.");
+
+    // Layout of the word:
+    //   bit  0:     valid flag
+    //   bits 1-7:   error status
+    //   bits 8-31:  active action limits (16 bits used)
+    //   bits 32-63: action repetitions
+    static constexpr uint64_t VALID_FLAG = 1;
+
+    // zero-initialised shared memory is a valid State
+    SharedMemorySegment<State> state_;
+
+    StatusWord(const std::string &shared_memory_id, bool is_leader)
+        : state_(shared_memory_id, is_leader)
+    {
+    }
+
+    static uint64_t pack(const Status &status)
+    {
+        const uint64_t error_status =
+            static_cast<uint64_t>(status.error_status) & 0x7f;
+        const uint64_t limits = status.active_action_limits & 0xffff;
+        const uint64_t repetitions = std::min<uint64_t>(
+            status.action_repetitions, std::numeric_limits<uint32_t>::max());
+
+        return VALID_FLAG | (error_status << 1) | (limits << 8) |
+               (repetitions << 32);
+    }
+
+    static Value unpack(uint64_t word)
+    {
+        Value value;
+        value.is_valid = (word & VALID_FLAG) != 0;
+        value.error_status =
+            static_cast<Status::ErrorStatus>((word >> 1) & 0x7f);
+        value.active_action_limits = (word >> 8) & 0xffff;
+        value.action_repetitions = static_cast<uint32_t>(word >> 32);
+        return value;
+    }
+};
+
+}  // namespace robot_interfaces
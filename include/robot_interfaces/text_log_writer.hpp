@@ -0,0 +1,179 @@
+/**
+ * @file
+ * @brief Buffered writer for space-separated text log files.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace robot_interfaces
+{
+/**
+ * @brief Write space-separated values to a text file, one line per entry.
+ *
+ * Values are formatted directly into a preallocated buffer, which is written
+ * to the file in large chunks.  The file is kept open until the writer is
+ * closed.
+ *
+ * Floating point values are written in the shortest representation that
+ * reads back to exactly the same value (using `std::to_chars`, if supported
+ * by the standard library, otherwise with 17 significant digits).
+ *
+ * The buffer is only written at line ends (unless a single line does not fit
+ * into half of the buffer), so usually only complete lines end up in the
+ * file.
+ */
+class TextLogWriter
+{
+public:
+    /**
+     * @brief Open the file.
+     *
+     * @param filename  Path to the file.
+     * @param append  If true, append to an existing file, otherwise existing
+     *     files are overwritten.
+     * @param buffer_size  Size of the buffer in bytes.
+     */
+    TextLogWriter(const std::string &filename,
+                  bool append = false,
+                  size_t buffer_size = 1 << 20)
+        : buffer_(std::max(buffer_size, MIN_BUFFER_SIZE)),
+          used_(0),
+          bytes_written_(0)
+    {
+        file_.open(filename,
+                   append ? std::ios::binary | std::ios::app
+                          : std::ios::binary | std::ios::trunc);
+        if (!file_)
+        {
+            throw std::runtime_error("Failed to open file " + filename);
+        }
+    }
+
+    ~TextLogWriter()
+    {
+        close();
+    }
+
+    //! @brief Write a floating point value followed by a space.
+    void write(double value)
+    {
+        reserve(MAX_VALUE_LENGTH + 1);
+        char *begin = buffer_.data() + used_;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        char *end =
+            std::to_chars(begin, begin + MAX_VALUE_LENGTH, value).ptr;
+#else
+        char *end = begin + std::snprintf(begin, MAX_VALUE_LENGTH, "%.17g",
+                                          value);
+#endif
+        *end = ' ';
+        used_ = end + 1 - buffer_.data();
+    }
+
+    //! @brief Write an integer value followed by a space.
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral<T>::value>>
+    void write(T value)
+    {
+        reserve(MAX_VALUE_LENGTH + 1);
+        char *begin = buffer_.data() + used_;
+        char *end = std::to_chars(begin, begin + MAX_VALUE_LENGTH, value).ptr;
+        *end = ' ';
+        used_ = end + 1 - buffer_.data();
+    }
+
+    //! @brief Write all values of a container, each followed by a space.
+    void write(const std::vector<double> &values)
+    {
+        for (double value : values)
+        {
+            write(value);
+        }
+    }
+
+    //! @brief Write a string followed by a space.
+    void write(const std::string &value)
+    {
+        reserve(value.size() + 1);
+        value.copy(buffer_.data() + used_, value.size());
+        used_ += value.size();
+        buffer_[used_++] = ' ';
+    }
+
+    //! @brief Terminate the current line.
+    void end_line()
+    {
+        reserve(1);
+        buffer_[used_++] = '\n';
+
+        // write at line ends, so the file usually contains only complete
+        // lines
+        if (used_ > buffer_.size() / 2)
+        {
+            flush();
+        }
+    }
+
+    //! @brief Write the buffer to the file.
+    void flush()
+    {
+        if (used_ > 0)
+        {
+            file_.write(buffer_.data(), used_);
+            bytes_written_ += used_;
+            used_ = 0;
+        }
+        file_.flush();
+    }
+
+    //! @brief Get the number of bytes written to the file (excluding buffer).
+    size_t get_bytes_written() const
+    {
+        return bytes_written_;
+    }
+
+    //! @brief Flush the buffer and close the file.
+    void close()
+    {
+        if (file_.is_open())
+        {
+            flush();
+            file_.close();
+        }
+    }
+
+private:
+    //! @brief Upper bound for the length of a formatted number.
+    static constexpr size_t MAX_VALUE_LENGTH = 32;
+    static constexpr size_t MIN_BUFFER_SIZE = 4 * MAX_VALUE_LENGTH;
+
+    std::ofstream file_;
+    std::vector<char> buffer_;
+    size_t used_;
+    size_t bytes_written_;
+
+    //! @brief Make sure there is space for n more characters in the buffer.
+    void reserve(size_t n)
+    {
+        if (used_ + n > buffer_.size())
+        {
+            flush();
+            if (n > buffer_.size())
+            {
+                buffer_.resize(n);
+            }
+        }
+    }
+};
+
+}  // namespace robot_interfaces
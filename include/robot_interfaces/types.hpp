@@ -8,6 +8,11 @@
 
 #include <memory>
 
+#include "action_hold_policy.hpp"
+#include "action_limiter.hpp"
+#include "lockstep_robot_frontend.hpp"
+#include "observation_filter.hpp"
+#include "remote_robot_driver.hpp"
 #include "robot_backend.hpp"
 #include "robot_data.hpp"
 #include "robot_frontend.hpp"
@@ -25,6 +30,12 @@ struct RobotInterfaceTypes
 
     typedef RobotBackend<Action, Observation> Backend;
     typedef std::shared_ptr<Backend> BackendPtr;
+    typedef ActionLimiter<Action, Observation> BaseActionLimiter;
+    typedef std::shared_ptr<BaseActionLimiter> BaseActionLimiterPtr;
+    typedef ActionHoldPolicy<Action> BaseActionHoldPolicy;
+    typedef std::shared_ptr<BaseActionHoldPolicy> BaseActionHoldPolicyPtr;
+    typedef ObservationFilter<Observation> BaseObservationFilter;
+    typedef std::shared_ptr<BaseObservationFilter> BaseObservationFilterPtr;
 
     typedef RobotData<Action, Observation> BaseData;
     typedef std::shared_ptr<BaseData> BaseDataPtr;
@@ -33,8 +44,17 @@ struct RobotInterfaceTypes
     typedef MultiProcessRobotData<Action, Observation> MultiProcessData;
     typedef std::shared_ptr<MultiProcessData> MultiProcessDataPtr;
 
+    typedef ReadOnlyRobotFrontend<Action, Observation> ReadOnlyFrontend;
+    typedef std::shared_ptr<ReadOnlyFrontend> ReadOnlyFrontendPtr;
     typedef RobotFrontend<Action, Observation> Frontend;
     typedef std::shared_ptr<Frontend> FrontendPtr;
+    typedef LockstepRobotFrontend<Action, Observation> LockstepFrontend;
+    typedef std::shared_ptr<LockstepFrontend> LockstepFrontendPtr;
+
+    typedef RemoteRobotDriver<Action, Observation> RemoteDriver;
+    typedef std::shared_ptr<RemoteDriver> RemoteDriverPtr;
+    typedef RemoteRobotDriverServer<Action, Observation> RemoteDriverServer;
+    typedef std::shared_ptr<RemoteDriverServer> RemoteDriverServerPtr;
 
     typedef RobotLogEntry<Action, Observation> LogEntry;
     typedef RobotLogger<Action, Observation> Logger;
@@ -0,0 +1,376 @@
+/**
+ * @file
+ * @brief Lease-based arbitration between multiple writing frontends.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "shared_memory_segment.hpp"
+
+namespace robot_interfaces
+{
+/**
+ * @brief Grants the right to write actions to one frontend at a time.
+ *
+ * Several frontends can be attached to the same RobotData but the time
+ * indices of the actions only make sense if there is a single writer.  A
+ * frontend that wants to write acquires a *lease* with a priority and a
+ * duration and gets a token which identifies it as the current writer.  The
+ * lease is granted if
+ *
+ * - nobody holds a lease,
+ * - the lease of the current holder has expired or the process holding it
+ *   died without releasing it (so also leases with infinite duration end
+ *   when the holder crashes) or
+ * - the current holder has a lower priority (preemption, e.g. for a safety
+ *   controller taking over).
+ *
+ * The holder keeps the lease alive by renewing it.  Once preempted, renewing
+ * fails, so the preempted frontend notices that it lost write access.
+ *
+ * Writers do the actual write through write(), which checks the lease and
+ * writes under the lock of the arbiter.  This way, a preempted writer cannot
+ * append anything after acquire() returned to the new holder.  While a lease
+ * is held, writers without lease are rejected, so frontends without lease
+ * cannot interleave with the lease holder either.  Once the lease is released
+ * or has expired, they can write again.
+ *
+ * Readers do not interact with the arbiter at all.
+ *
+ * The state either lives in the memory of the process (default constructor)
+ * or in a POSIX shared memory segment (create_leader() / create_follower()).
+ * Lease expiry is based on CLOCK_MONOTONIC (std::chrono::steady_clock) which
+ * is the same for all processes on the machine.
+ */
+class WriterArbiter
+{
+public:
+    //! @brief Token of a lease.  0 is never a valid token.
+    typedef uint64_t Token;
+
+    //! @brief Result of write().
+    enum class WriteAccess
+    {
+        //! The write was done.
+        GRANTED,
+        //! Writer without lease while another writer holds a lease.
+        LEASE_REQUIRED,
+        //! The lease of the writer was preempted or has expired.
+        LEASE_LOST
+    };
+
+    //! @brief Create an arbiter for use within one process.
+    WriterArbiter()
+    {
+        init_mutex();
+    }
+
+    /**
+     * @brief Create an arbiter in shared memory.
+     *
+     * Existing shared memory with the same ID is reset.
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     */
+    static std::shared_ptr<WriterArbiter> create_leader(
+        const std::string &shared_memory_id)
+    {
+        return std::shared_ptr<WriterArbiter>(
+            new WriterArbiter(shared_memory_id, true));
+    }
+
+    /**
+     * @brief Open an arbiter in shared memory created by create_leader().
+     *
+     * @param shared_memory_id  ID of the shared memory segment.
+     * @throws std::runtime_error if the shared memory does not exist.
+     */
+    static std::shared_ptr<WriterArbiter> create_follower(
+        const std::string &shared_memory_id)
+    {
+        return std::shared_ptr<WriterArbiter>(
+            new WriterArbiter(shared_memory_id, false));
+    }
+
+    //! @brief Remove the shared memory segment with the given ID.
+    static void clear_memory(const std::string &shared_memory_id)
+    {
+        SharedMemorySegment<State>::clear_memory(shared_memory_id);
+    }
+
+    /**
+     * @brief Try to acquire the writer lease.
+     *
+     * @param priority  Priority of the requesting writer.  A lease held with a
+     *     lower priority is preempted, one with the same or higher priority is
+     *     not.
+     * @param lease_duration_s  Time in seconds after which the lease expires
+     *     if it is not renewed.  Use infinity for a lease that only ends when
+     *     it is released, preempted or the process holding it terminates.
+     * @return Token of the lease or 0 if the lease is held by somebody else.
+     * @throws std::invalid_argument if lease_duration_s is not positive.
+     */
+    Token acquire(uint32_t priority, double lease_duration_s)
+    {
+        const int64_t expiry = compute_expiry(lease_duration_s);
+        const int64_t now = now_ns();
+
+        Lock lock(*state_);
+        const bool is_held = is_lease_valid(now);
+        if (is_held && priority <= state_->priority)
+        {
+            return 0;
+        }
+
+        if (is_held)
+        {
+            state_->num_preemptions++;
+        }
+        state_->holder = ++state_->last_token;
+        state_->holder_pid = getpid();
+        state_->priority = priority;
+        state_->expiry_ns = expiry;
+        return state_->holder;
+    }
+
+    /**
+     * @brief Extend the lease.
+     *
+     * @param token  Token returned by acquire().
+     * @param lease_duration_s  New duration of the lease, counted from now.
+     * @return True if the lease is still held, false if it was preempted or
+     *     had already expired.
+     */
+    bool renew(Token token, double lease_duration_s)
+    {
+        const int64_t expiry = compute_expiry(lease_duration_s);
+        const int64_t now = now_ns();
+
+        Lock lock(*state_);
+        if (token == 0 || state_->holder != token || !is_lease_valid(now))
+        {
+            return false;
+        }
+        state_->expiry_ns = expiry;
+        return true;
+    }
+
+    /**
+     * @brief Do a write if the given writer is allowed to.
+     *
+     * Checking the lease and writing are done under the lock of the arbiter,
+     * so the lease cannot be preempted in between.  A writer with lease is
+     * allowed to write as long as its lease is valid (the lease is renewed in
+     * this case).  A writer without lease is only allowed to write while
+     * nobody holds a valid lease.
+     *
+     * @param token  Token returned by acquire() or 0 for a writer without
+     *     lease.
+     * @param lease_duration_s  New duration of the lease, counted from now.
+     *     Ignored if token is 0.
+     * @param write_function  Function doing the write.  Should be short as
+     *     all other writers are blocked while it runs.
+     * @return Whether the write was done and if not, why.
+     */
+    template <typename Function>
+    WriteAccess write(Token token,
+                      double lease_duration_s,
+                      Function &&write_function)
+    {
+        const int64_t expiry =
+            token == 0 ? 0 : compute_expiry(lease_duration_s);
+        const int64_t now = now_ns();
+
+        Lock lock(*state_);
+        if (token == 0)
+        {
+            if (is_lease_valid(now))
+            {
+                return WriteAccess::LEASE_REQUIRED;
+            }
+        }
+        else
+        {
+            if (state_->holder != token || !is_lease_valid(now))
+            {
+                return WriteAccess::LEASE_LOST;
+            }
+            state_->expiry_ns = expiry;
+        }
+
+        write_function();
+        return WriteAccess::GRANTED;
+    }
+
+    /**
+     * @brief Release the lease.
+     *
+     * Does nothing if the lease is not held with the given token anymore.
+     */
+    void release(Token token)
+    {
+        Lock lock(*state_);
+        if (token != 0 && state_->holder == token)
+        {
+            state_->holder = 0;
+            state_->priority = 0;
+        }
+    }
+
+    //! @brief Check if the given token belongs to the currently valid lease.
+    bool is_holder(Token token) const
+    {
+        return token != 0 && get_holder() == token;
+    }
+
+    //! @brief Token of the currently valid lease or 0 if there is none.
+    Token get_holder() const
+    {
+        const int64_t now = now_ns();
+
+        Lock lock(*state_);
+        return is_lease_valid(now) ? state_->holder : 0;
+    }
+
+    //! @brief Number of leases that were preempted so far.
+    uint64_t get_number_of_preemptions() const
+    {
+        Lock lock(*state_);
+        return state_->num_preemptions;
+    }
+
+private:
+    //! @brief Data shared between the processes.
+    struct State
+    {
+        //! Mutex protecting the other members (initialised by init_mutex()).
+        pthread_mutex_t mutex;
+        uint32_t priority = 0;
+        Token holder = 0;
+        Token last_token = 0;
+        int64_t expiry_ns = 0;
+        //! Process of the holder, the lease ends if it terminates.
+        pid_t holder_pid = 0;
+        uint64_t num_preemptions = 0;
+    };
+
+    /**
+     * @brief Scoped lock on State::mutex.
+     *
+     * The mutex is robust, so if a process dies while holding it, the next
+     * process locking it takes it over instead of blocking forever.  The
+     * critical sections only assign a few values, so the state is usable in
+     * this case.
+     */
+    class Lock
+    {
+    public:
+        explicit Lock(State &state) : state_(state)
+        {
+            int result = pthread_mutex_lock(&state_.mutex);
+            if (result == EOWNERDEAD)
+            {
+                result = pthread_mutex_consistent(&state_.mutex);
+            }
+            if (result != 0)
+            {
+                throw std::runtime_error(
+                    std::string("Failed to lock writer arbiter: ") +
+                    std::strerror(result));
+            }
+        }
+
+        ~Lock()
+        {
+            pthread_mutex_unlock(&state_.mutex);
+        }
+
+    private:
+        State &state_;
+    };
+
+    // zero-initialised shared memory is a valid State, except for the mutex
+    // which is initialised by the leader
+    SharedMemorySegment<State> state_;
+
+    WriterArbiter(const std::string &shared_memory_id, bool is_leader)
+        : state_(shared_memory_id, is_leader)
+    {
+        if (is_leader)
+        {
+            init_mutex();
+        }
+    }
+
+    //! @brief Initialise the mutex as robust and process-shared.
+    void init_mutex()
+    {
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+        const int result = pthread_mutex_init(&state_->mutex, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+        if (result != 0)
+        {
+            throw std::runtime_error(
+                std::string("Failed to initialise writer arbiter: ") +
+                std::strerror(result));
+        }
+    }
+
+    /**
+     * @brief Check if somebody holds a lease which is still valid.
+     *
+     * The lease is invalid once it expired or the holding process terminated.
+     * State::mutex has to be locked.
+     */
+    bool is_lease_valid(int64_t now) const
+    {
+        if (state_->holder == 0 || now >= state_->expiry_ns)
+        {
+            return false;
+        }
+        // kill() with signal 0 only checks if the process exists (EPERM means
+        // it exists but belongs to another user)
+        return kill(state_->holder_pid, 0) == 0 || errno != ESRCH;
+    }
+
+    static int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static int64_t compute_expiry(double lease_duration_s)
+    {
+        if (!(lease_duration_s > 0))
+        {
+            throw std::invalid_argument("Lease duration must be positive.");
+        }
+        // cap at ~100 years to avoid overflow
+        if (lease_duration_s > 3e9)
+        {
+            return std::numeric_limits<int64_t>::max();
+        }
+        return now_ns() + static_cast<int64_t>(lease_duration_s * 1e9);
+    }
+};
+
+}  // namespace robot_interfaces
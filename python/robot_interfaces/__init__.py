@@ -5,3 +5,4 @@ import robot_interfaces.py_finger_types as finger  # noqa: F401
 import robot_interfaces.py_trifinger_types as trifinger  # noqa: F401
 import robot_interfaces.py_one_joint_types as one_joint  # noqa: F401
 import robot_interfaces.py_two_joint_types as two_joint  # noqa: F401
+import robot_interfaces.py_batch_types as batch  # noqa: F401
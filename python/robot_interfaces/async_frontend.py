@@ -0,0 +1,154 @@
+"""asyncio integration of the robot and sensor frontends.
+
+The getters of the frontends block until the requested time step exists.  The
+classes here allow to await them instead, so a single event loop thread can
+serve many robots and sensors::
+
+    notifier = AsyncNotifier()  # inside a coroutine of the event loop
+    robot = AsyncFrontend(robot_frontend, notifier)
+    camera = AsyncFrontend(camera_frontend, notifier)
+
+    t, observation = await robot.next_observation()
+
+The waiting is driven by the doorbells of the robot/sensor data (see
+``ReadinessNotifier``), there is no polling.
+"""
+import asyncio
+
+from robot_interfaces.py_generic import ReadinessNotifier
+
+
+class AsyncNotifier:
+    """Dispatch readiness notifications to asyncio futures.
+
+    Wraps a ``ReadinessNotifier`` whose file descriptor is watched by the
+    event loop.  One instance per event loop is enough for any number of
+    frontends.
+    """
+
+    def __init__(self, loop=None):
+        """
+        Args:
+            loop:  The event loop.  Defaults to the running loop, so without
+                it, the notifier has to be created in a coroutine.
+        """
+        self._loop = loop or asyncio.get_running_loop()
+        self._notifier = ReadinessNotifier()
+        self._waiters = {}
+        self._loop.add_reader(self._notifier.get_fd(), self._on_readable)
+
+    def close(self):
+        """Stop watching the file descriptor."""
+        self._loop.remove_reader(self._notifier.get_fd())
+
+    def add_source(self, doorbell):
+        """Add a doorbell and return its source ID (see wait())."""
+        return self._notifier.add_source(doorbell)
+
+    def replace_source(self, source_id, doorbell):
+        """Replace the doorbell of a source (e.g. after re-attaching)."""
+        self._notifier.replace_source(source_id, doorbell)
+
+    def remove_source(self, source_id):
+        """Remove a source.  Pending waiters of it are cancelled."""
+        self._notifier.remove_source(source_id)
+        for future in self._waiters.pop(source_id, []):
+            future.cancel()
+
+    async def wait(self, source_id):
+        """Wait until the given source is rung.
+
+        Only rings after the call are considered, so check the condition that
+        is waited for before calling this (as AsyncFrontend does).
+        """
+        future = self._loop.create_future()
+        self._waiters.setdefault(source_id, []).append(future)
+        await future
+
+    def _on_readable(self):
+        for source_id in self._notifier.take_ready_sources():
+            for future in self._waiters.pop(source_id, []):
+                if not future.done():
+                    future.set_result(None)
+
+
+class AsyncFrontend:
+    """Awaitable variants of the getters of a robot or sensor frontend.
+
+    Works with ``Frontend`` and ``ReadOnlyFrontend`` of the robot types as well
+    as with the sensor ``Frontend``.  Methods that do not wait (e.g. for
+    appending actions) can be called directly on ``frontend``.
+    """
+
+    def __init__(self, frontend, notifier):
+        """
+        Args:
+            frontend:  The frontend to wrap.
+            notifier (AsyncNotifier):  Notifier of the event loop.
+        """
+        self.frontend = frontend
+        self._notifier = notifier
+        self._source_id = notifier.add_source(
+            frontend.get_observation_doorbell()
+        )
+        self._next_timeindex = None
+
+    def update_doorbell(self):
+        """Watch the current doorbell of the frontend.
+
+        Call this after re-attaching the robot data
+        (``reattach_if_needed()``), as the doorbells are replaced by it.
+        Without this, waiting methods would never be woken up again.
+        Time indices start from zero again, so ``next_observation`` restarts
+        with the first step of the new data.
+        """
+        self._notifier.replace_source(
+            self._source_id, self.frontend.get_observation_doorbell()
+        )
+        self._next_timeindex = None
+
+    def close(self):
+        """Stop watching the doorbell of the frontend."""
+        self._notifier.remove_source(self._source_id)
+
+    async def wait_until_timeindex(self, t):
+        """Wait until the observation of time step t exists."""
+        while not self.frontend.has_observation(t):
+            await self._notifier.wait(self._source_id)
+
+    async def get_observation(self, t):
+        """Get the observation of time step t, waiting until it exists."""
+        await self.wait_until_timeindex(t)
+        return self.frontend.get_observation(t)
+
+    async def get_status(self, t):
+        """Get the status of time step t, waiting until it exists.
+
+        Only for robot frontends.
+        """
+        await self.wait_until_timeindex(t)
+        return self.frontend.get_status(t)
+
+    async def next_observation(self):
+        """Get the next observation not returned by this method yet.
+
+        The first call returns the first observation that is added after the
+        call.  Subsequent calls return consecutive time steps, so if the caller
+        is slower than the robot, older steps may drop out of the history, in
+        which case ``get_observation`` raises an error.
+
+        Returns:
+            Tuple (t, observation).
+        """
+        if self._next_timeindex is None:
+            if self.frontend.has_observation(0):
+                self._next_timeindex = (
+                    self.frontend.get_current_timeindex() + 1
+                )
+            else:
+                self._next_timeindex = 0
+
+        t = self._next_timeindex
+        observation = await self.get_observation(t)
+        self._next_timeindex = t + 1
+        return t, observation
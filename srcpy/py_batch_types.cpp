@@ -0,0 +1,40 @@
+/**
+ * @file
+ * @brief Create bindings for the batch robot types.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <robot_interfaces/batch_n_joint_robot_types.hpp>
+#include <robot_interfaces/pybind_batch_helper.hpp>
+
+using namespace robot_interfaces;
+
+PYBIND11_MODULE(py_batch_types, m)
+{
+    auto one_joint = m.def_submodule("one_joint");
+    create_batch_python_bindings<BatchNJointRobotTypes<1>>(one_joint);
+
+    auto two_joint = m.def_submodule("two_joint");
+    create_batch_python_bindings<BatchNJointRobotTypes<2>>(two_joint);
+
+    auto finger = m.def_submodule("finger");
+    create_batch_python_bindings<BatchNJointRobotTypes<3>>(finger);
+
+    auto trifinger = m.def_submodule("trifinger");
+    create_batch_python_bindings<BatchNJointRobotTypes<9>>(trifinger);
+
+    // single precision variants
+    auto float32 = m.def_submodule("float32");
+
+    auto one_joint_f = float32.def_submodule("one_joint");
+    create_batch_python_bindings<BatchNJointRobotTypes<1, float>>(one_joint_f);
+
+    auto two_joint_f = float32.def_submodule("two_joint");
+    create_batch_python_bindings<BatchNJointRobotTypes<2, float>>(two_joint_f);
+
+    auto finger_f = float32.def_submodule("finger");
+    create_batch_python_bindings<BatchNJointRobotTypes<3, float>>(finger_f);
+
+    auto trifinger_f = float32.def_submodule("trifinger");
+    create_batch_python_bindings<BatchNJointRobotTypes<9, float>>(trifinger_f);
+}
@@ -27,4 +27,8 @@ using namespace robot_interfaces;
 PYBIND11_MODULE(py_finger_types, m)
 {
     create_python_bindings<MonoFingerTypes>(m);
+
+    auto float32 = m.def_submodule(
+        "float32", "Same types with single precision actions/observations.");
+    create_python_bindings<MonoFingerTypesF>(float32);
 }
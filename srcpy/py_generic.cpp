@@ -19,8 +19,15 @@
  * \file
  * \brief Create bindings for generic types
  */
+#include <robot_interfaces/columnar_log.hpp>
 #include <robot_interfaces/pybind_helper.hpp>
+#include <robot_interfaces/readiness_notifier.hpp>
+#include <robot_interfaces/record_log.hpp>
+#include <robot_interfaces/remote_robot_driver.hpp>
+#include <robot_interfaces/robot_data.hpp>
+#include <robot_interfaces/shared_memory_residency.hpp>
 #include <robot_interfaces/status.hpp>
+#include <robot_interfaces/status_word.hpp>
 
 using namespace robot_interfaces;
 
@@ -32,6 +39,14 @@ PYBIND11_MODULE(py_generic, m)
             "action_repetitions",
             &Status::action_repetitions,
             "int: Number of times the current action has been repeated.")
+        .def_readonly("active_action_limits",
+                      &Status::active_action_limits,
+                      "int: Bit mask of ActionLimit flags that were active "
+                      "for the action of the previous time step.")
+        .def_readonly("trajectory_queue_depth",
+                      &Status::trajectory_queue_depth,
+                      "int: Number of pending actions in the trajectory "
+                      "queue.")
         .def_readonly("error_status",
                       &Status::error_status,
                       "ErrorStatus: Current error status.")
@@ -50,4 +65,227 @@ PYBIND11_MODULE(py_generic, m)
             "BACKEND_ERROR",
             Status::ErrorStatus::BACKEND_ERROR,
             "Error from the robot back end (e.g. some communication issue).");
+
+    pybind11::enum_<Status::ActionLimit>(
+        pystatus, "ActionLimit", pybind11::arithmetic())
+        .value("TORQUE_LIMIT",
+               Status::ActionLimit::TORQUE_LIMIT,
+               "The desired torque exceeded the torque limit.")
+        .value("POSITION_LIMIT",
+               Status::ActionLimit::POSITION_LIMIT,
+               "The desired position was outside of the position limits.")
+        .value("VELOCITY_DAMPING",
+               Status::ActionLimit::VELOCITY_DAMPING,
+               "Velocity damping was added to the torque.")
+        .value("DEFAULT_GAINS",
+               Status::ActionLimit::DEFAULT_GAINS,
+               "NaN gains were replaced by the default gains.")
+        .value("NON_FINITE_TORQUE",
+               Status::ActionLimit::NON_FINITE_TORQUE,
+               "Non-finite torques (NaN or infinity) were replaced by zero.");
+
+    pybind11::class_<Doorbell, std::shared_ptr<Doorbell>>(
+        m,
+        "Doorbell",
+        "Notification channel of the robot/sensor data (see "
+        "``ReadinessNotifier``).")
+        .def("get_sequence", &Doorbell::get_sequence);
+
+    pybind11::class_<ReadinessNotifier, std::shared_ptr<ReadinessNotifier>>(
+        m,
+        "ReadinessNotifier",
+        R"XXX(
+            ReadinessNotifier()
+
+            Signals a file descriptor when one of several doorbells is rung.
+
+            Add the doorbells of the frontends (``get_observation_doorbell()``)
+            as sources and watch the file descriptor returned by ``get_fd()``
+            in an event loop.  When it is readable, ``take_ready_sources()``
+            returns the IDs of the sources that were rung.  See also
+            ``robot_interfaces.async_frontend`` for an asyncio integration.
+)XXX")
+        .def(pybind11::init<>())
+        .def("add_source",
+             &ReadinessNotifier::add_source,
+             pybind11::arg("doorbell"))
+        .def("replace_source",
+             &ReadinessNotifier::replace_source,
+             pybind11::arg("source_id"),
+             pybind11::arg("doorbell"))
+        .def("remove_source",
+             &ReadinessNotifier::remove_source,
+             pybind11::arg("source_id"))
+        .def("get_fd", &ReadinessNotifier::get_fd)
+        .def("take_ready_sources",
+             &ReadinessNotifier::take_ready_sources,
+             pybind11::call_guard<pybind11::gil_scoped_release>());
+
+    pybind11::class_<StatusWord::Value>(
+        m,
+        "StatusWord",
+        "Compact form of the latest status (see ``Frontend.peek_status``).")
+        .def_readonly("action_repetitions",
+                      &StatusWord::Value::action_repetitions)
+        .def_readonly("active_action_limits",
+                      &StatusWord::Value::active_action_limits)
+        .def_readonly("error_status", &StatusWord::Value::error_status)
+        .def_readonly("is_valid",
+                      &StatusWord::Value::is_valid,
+                      "bool: False if no status was published yet.")
+        .def("has_error", &StatusWord::Value::has_error);
+
+    pybind11::class_<HistoryLengths>(
+        m,
+        "HistoryLengths",
+        "History lengths of the time series of the robot data.")
+        .def(pybind11::init<size_t>(), pybind11::arg("history_length") = 1000)
+        .def_readwrite("desired_action", &HistoryLengths::desired_action)
+        .def_readwrite("applied_action", &HistoryLengths::applied_action)
+        .def_readwrite("observation", &HistoryLengths::observation)
+        .def_readwrite("status", &HistoryLengths::status)
+        .def_readwrite("trajectory", &HistoryLengths::trajectory)
+        .def_static("compute_logging_history_length",
+                    &HistoryLengths::compute_logging_history_length,
+                    pybind11::arg("control_rate_hz"),
+                    pybind11::arg("log_block_size"),
+                    pybind11::arg("max_logger_lag_s"),
+                    "Minimum history length needed to log without losing "
+                    "time steps.");
+
+    pybind11::class_<MemoryFootprint>(
+        m,
+        "MemoryFootprint",
+        "Approximate memory used by the time series of the robot data in "
+        "bytes.")
+        .def_readonly("desired_action", &MemoryFootprint::desired_action)
+        .def_readonly("applied_action", &MemoryFootprint::applied_action)
+        .def_readonly("observation", &MemoryFootprint::observation)
+        .def_readonly("status", &MemoryFootprint::status)
+        .def_readonly("trajectory", &MemoryFootprint::trajectory)
+        .def("total", &MemoryFootprint::total);
+
+    pybind11::class_<MemoryResidencyOptions>(
+        m,
+        "MemoryResidencyOptions",
+        "Options for ``MultiProcessData.make_memory_resident``.")
+        .def(pybind11::init<>())
+        .def_readwrite("use_hugepages",
+                       &MemoryResidencyOptions::use_hugepages,
+                       "bool: Request transparent hugepages (only effective "
+                       "if enabled for shared memory in the kernel).")
+        .def_readwrite("prefault",
+                       &MemoryResidencyOptions::prefault,
+                       "bool: Fault in all pages now.")
+        .def_readwrite("lock",
+                       &MemoryResidencyOptions::lock,
+                       "bool: Lock the pages in RAM.");
+
+    pybind11::class_<MemoryResidency>(m, "MemoryResidency")
+        .def_readonly("num_mappings", &MemoryResidency::num_mappings)
+        .def_readonly("mapped_bytes", &MemoryResidency::mapped_bytes)
+        .def_readonly("resident_bytes", &MemoryResidency::resident_bytes)
+        .def("__repr__", [](const MemoryResidency &residency) {
+            return "MemoryResidency(num_mappings=" +
+                   std::to_string(residency.num_mappings) +
+                   ", mapped_bytes=" + std::to_string(residency.mapped_bytes) +
+                   ", resident_bytes=" +
+                   std::to_string(residency.resident_bytes) + ")";
+        });
+
+    pybind11::class_<RemoteDriverStatistics>(
+        m,
+        "RemoteDriverStatistics",
+        "Timing statistics of a remote driver (see ``RemoteDriver``).")
+        .def_readonly("num_calls", &RemoteDriverStatistics::num_calls)
+        .def_readonly("mean_call_duration_s",
+                      &RemoteDriverStatistics::mean_call_duration_s)
+        .def_readonly("max_call_duration_s",
+                      &RemoteDriverStatistics::max_call_duration_s)
+        .def_readonly("num_lock_waits",
+                      &RemoteDriverStatistics::num_lock_waits,
+                      "int: Number of GIL acquisitions by the driver.")
+        .def_readonly("total_lock_wait_s",
+                      &RemoteDriverStatistics::total_lock_wait_s,
+                      "float: Total time the driver waited for the GIL.")
+        .def_readonly("max_lock_wait_s",
+                      &RemoteDriverStatistics::max_lock_wait_s,
+                      "float: Maximum time the driver waited for the GIL.");
+
+    pybind11::class_<ColumnarLogReader, std::shared_ptr<ColumnarLogReader>>(
+        m,
+        "ColumnarLogReader",
+        R"XXX(
+            ColumnarLogReader(filename: str)
+
+            Read columns from a columnar log file (as written by
+            ``Logger.write_current_buffer_columnar`` or by the logger started
+            with ``Logger.Format.COLUMNAR``).
+
+            Only the requested columns are decoded.  If the file was not closed
+            properly (e.g. because the logging process crashed), all complete
+            row groups are read.
+)XXX")
+        .def(pybind11::init<std::string>(), pybind11::arg("filename"))
+        .def("is_truncated",
+             &ColumnarLogReader::is_truncated,
+             "Check if incomplete data was found at the end of the file.")
+        .def("get_column_names",
+             &ColumnarLogReader::get_column_names,
+             "Get the names of the columns contained in the file.")
+        .def("has_column",
+             &ColumnarLogReader::has_column,
+             pybind11::arg("name"),
+             "Check if the file contains a column with the given name.")
+        .def(
+            "read_column",
+            [](const ColumnarLogReader &reader, const std::string &name) {
+                ColumnData column;
+                {
+                    pybind11::gil_scoped_release release;
+                    column = reader.read_column(name);
+                }
+                // move the values into a NumPy array without copying them
+                auto values =
+                    new std::vector<double>(std::move(column.values));
+                pybind11::capsule free_values(values, [](void *p) {
+                    delete reinterpret_cast<std::vector<double> *>(p);
+                });
+                return pybind11::array_t<double>(
+                    {values->size() / column.width,
+                     static_cast<size_t>(column.width)},
+                    values->data(),
+                    free_values);
+            },
+            pybind11::arg("name"),
+            R"XXX(
+                read_column(name: str) -> numpy.ndarray
+
+                Read the values of the specified column.
+
+                Args:
+                    name (str): Name of the column.
+
+                Returns:
+                    Array of shape (T, width) with the values of all rows.
+)XXX");
+
+    m.def("repair_log_file",
+          &RecordLogReader::repair,
+          pybind11::arg("filename"),
+          R"XXX(
+            repair_log_file(filename: str) -> int
+
+            Repair a columnar or binary log file after the logging process
+            crashed.
+
+            Incomplete data at the end of the file is removed and the index
+            file is rebuilt.
+
+            Args:
+                filename (str): Path to the log file.
+
+            Returns:
+                Number of valid records in the file.
+)XXX");
 }
@@ -27,4 +27,8 @@ using namespace robot_interfaces;
 PYBIND11_MODULE(py_one_joint_types, m)
 {
     create_python_bindings<SimpleNJointRobotTypes<1>>(m);
+
+    auto float32 = m.def_submodule(
+        "float32", "Same types with single precision actions/observations.");
+    create_python_bindings<SimpleNJointRobotTypesF<1>>(float32);
 }
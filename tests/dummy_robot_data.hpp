@@ -0,0 +1,40 @@
+/**
+ * @file
+ * @brief Helper to fill robot data with dummy time steps for testing.
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <robot_interfaces/robot_data.hpp>
+#include <robot_interfaces/status.hpp>
+
+namespace robot_interfaces
+{
+namespace testing
+{
+/**
+ * @brief Append a complete time step with values depending on t.
+ *
+ * Desired and applied action get the torque (t, -t), the observation the
+ * position (0.1 t, 0.2 t) and the status is the default status.  For robot
+ * types with two joints (e.g. SimpleNJointRobotTypes<2>).
+ */
+template <typename Action, typename Observation>
+void append_dummy_step(RobotData<Action, Observation> &data, long t)
+{
+    typedef typename Observation::Scalar Scalar;
+
+    Action action = Action::Torque(typename Action::Vector(
+        static_cast<Scalar>(t), static_cast<Scalar>(-t)));
+    Observation observation;
+    observation.position << static_cast<Scalar>(0.1) * t,
+        static_cast<Scalar>(0.2) * t;
+
+    data.desired_action->append(action);
+    data.applied_action->append(action);
+    data.observation->append(observation);
+    data.status->append(Status());
+}
+}  // namespace testing
+}  // namespace robot_interfaces
@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief Tests for the action hold policies.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include <robot_interfaces/action_hold_policy.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<2> Types;
+typedef Types::Action Action;
+
+//! Driver which runs at about 1 kHz and returns the action it gets.
+class SlowDriver : public RobotDriver<Types::Action, Types::Observation>
+{
+public:
+    void initialize() override
+    {
+    }
+
+    Types::Action apply_action(const Types::Action &desired_action) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return desired_action;
+    }
+
+    Types::Observation get_latest_observation() override
+    {
+        return Types::Observation();
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+};
+
+TEST(TestActionHoldPolicy, linear_extrapolation)
+{
+    LinearExtrapolationHoldPolicy<Action> policy(4);
+
+    Action previous = Action::TorqueAndPosition(Action::Vector(0.0, 1.0),
+                                                Action::Vector(0.0, NAN));
+    Action last = Action::TorqueAndPosition(Action::Vector(1.0, 1.0),
+                                            Action::Vector(2.0, 3.0));
+
+    // no previous action
+    Action action = policy.get_hold_action(last, last, 0, 1);
+    ASSERT_EQ(last.torque, action.torque);
+
+    action = policy.get_hold_action(last, previous, 2, 1);
+    ASSERT_EQ(1.5, action.torque[0]);
+    ASSERT_EQ(1.0, action.torque[1]);
+    ASSERT_EQ(3.0, action.position[0]);
+    ASSERT_EQ(3.0, action.position[1]);
+
+    // limited to 4 steps
+    action = policy.get_hold_action(last, previous, 2, 10);
+    ASSERT_EQ(3.0, action.torque[0]);
+    ASSERT_EQ(6.0, action.position[0]);
+}
+
+TEST(TestActionHoldPolicy, decaying)
+{
+    DecayingHoldPolicy<Action> policy(0.5);
+
+    Action last = Action::TorqueAndPosition(Action::Vector(1.0, -2.0),
+                                            Action::Vector(2.0, NAN));
+    Action action = policy.get_hold_action(last, last, 0, 2);
+    ASSERT_EQ(0.25, action.torque[0]);
+    ASSERT_EQ(-0.5, action.torque[1]);
+    ASSERT_EQ(2.0, action.position[0]);
+    ASSERT_TRUE(std::isnan(action.position[1]));
+
+    ASSERT_THROW(DecayingHoldPolicy<Action>(0.0), std::invalid_argument);
+    ASSERT_THROW(DecayingHoldPolicy<Action>(1.5), std::invalid_argument);
+}
+
+// waypoints sent at a low rate are extrapolated by the backend
+TEST(TestActionHoldPolicy, backend)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    auto driver = std::make_shared<SlowDriver>();
+    auto backend = std::make_shared<Types::Backend>(
+        driver,
+        data,
+        true,
+        std::numeric_limits<double>::infinity(),
+        100);
+    backend->set_max_action_repetitions(1000);
+    backend->set_action_hold_policy(
+        std::make_shared<LinearExtrapolationHoldPolicy<Action>>());
+    backend->initialize();
+
+    Types::Frontend frontend(data);
+    TimeIndex t0 = frontend.append_desired_action(
+        Action::Torque(Action::Vector(0.0, 0.0)));
+    TimeIndex t1 = frontend.append_desired_action(
+        Action::Torque(Action::Vector(1.0, 2.0)));
+    ASSERT_EQ(0, t0);
+
+    const double slope = 1.0 / (t1 - t0);
+    for (TimeIndex t = t1 + 1; t < t1 + 5; t++)
+    {
+        Action action = frontend.get_desired_action(t);
+        ASSERT_NEAR(1.0 + (t - t1) * slope, action.torque[0], 1e-9);
+        ASSERT_NEAR(2.0 + (t - t1) * 2 * slope, action.torque[1], 1e-9);
+        ASSERT_EQ(t - t1, frontend.get_status(t).action_repetitions);
+        ASSERT_EQ(action.torque, frontend.get_applied_action(t).torque);
+    }
+
+    backend->request_shutdown();
+    backend->wait_until_terminated();
+}
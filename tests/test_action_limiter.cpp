@@ -0,0 +1,197 @@
+/**
+ * @file
+ * @brief Tests for the action limiter stage of the backend.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <robot_interfaces/action_limiter.hpp>
+#include <robot_interfaces/finger_types.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<2> Types;
+typedef NJointActionLimiter<Types::Action, Types::Observation> Limiter;
+
+//! Driver with constant velocity which returns the action it gets.
+class ConstantVelocityDriver
+    : public RobotDriver<Types::Action, Types::Observation>
+{
+public:
+    void initialize() override
+    {
+    }
+
+    Types::Action apply_action(const Types::Action &desired_action) override
+    {
+        return desired_action;
+    }
+
+    Types::Observation get_latest_observation() override
+    {
+        Types::Observation observation;
+        observation.velocity << 1.0, -2.0;
+        return observation;
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+};
+
+TEST(TestActionLimiter, no_limits)
+{
+    Limiter limiter((Limiter::Limits()));
+    Types::Observation observation;
+    observation.velocity << 1.0, 2.0;
+
+    Types::Action action = Types::Action::TorqueAndPosition(
+        Types::Action::Vector(100, -100), Types::Action::Vector(5, NAN));
+    ASSERT_EQ(0u, limiter.limit(action, observation));
+    ASSERT_EQ(100, action.torque[0]);
+    ASSERT_EQ(5, action.position[0]);
+    ASSERT_TRUE(std::isnan(action.position[1]));
+    ASSERT_TRUE(std::isnan(action.position_kp[0]));
+}
+
+TEST(TestActionLimiter, limits)
+{
+    Limiter::Limits limits;
+    limits.max_torque << 1.0, 2.0;
+    limits.position_min << -1.0, -1.0;
+    limits.position_max << 1.0, 1.0;
+    limits.default_kp << 3.0, NAN;
+    Limiter limiter(limits);
+
+    Types::Observation observation;
+    Types::Action action = Types::Action::TorqueAndPosition(
+        Types::Action::Vector(5.0, -0.5), Types::Action::Vector(NAN, -3.0));
+
+    uint32_t active = limiter.limit(action, observation);
+    ASSERT_EQ(Status::ActionLimit::TORQUE_LIMIT |
+                  Status::ActionLimit::POSITION_LIMIT |
+                  Status::ActionLimit::DEFAULT_GAINS,
+              active);
+    ASSERT_EQ(1.0, action.torque[0]);
+    ASSERT_EQ(-0.5, action.torque[1]);
+    ASSERT_TRUE(std::isnan(action.position[0]));
+    ASSERT_EQ(-1.0, action.position[1]);
+    ASSERT_EQ(3.0, action.position_kp[0]);
+    ASSERT_TRUE(std::isnan(action.position_kp[1]));
+    ASSERT_TRUE(std::isnan(action.position_kd[0]));
+
+    Limiter::Limits invalid;
+    invalid.max_torque[0] = -1;
+    ASSERT_THROW(Limiter limiter(invalid), std::invalid_argument);
+}
+
+// damping is added before the torque limit is applied
+TEST(TestActionLimiter, velocity_damping)
+{
+    Limiter::Limits limits;
+    limits.safety_kd.setConstant(0.5);
+    limits.max_torque.setConstant(0.8);
+    Limiter limiter(limits);
+
+    Types::Observation observation;
+    observation.velocity << 1.0, -1.0;
+    Types::Action action = Types::Action::Torque(Types::Action::Vector(0, 0));
+
+    ASSERT_EQ(Status::ActionLimit::VELOCITY_DAMPING,
+              limiter.limit(action, observation));
+    ASSERT_EQ(-0.5, action.torque[0]);
+    ASSERT_EQ(0.5, action.torque[1]);
+}
+
+// NaN and infinite torques do not pass the limiter
+TEST(TestActionLimiter, non_finite_torque)
+{
+    Limiter::Limits limits;
+    limits.max_torque.setConstant(1.0);
+    limits.safety_kd.setConstant(0.5);
+    Limiter limiter(limits);
+
+    Types::Observation observation;
+    observation.velocity.setZero();
+    Types::Action action =
+        Types::Action::Torque(Types::Action::Vector(NAN, 0.5));
+    ASSERT_EQ(Status::ActionLimit::NON_FINITE_TORQUE,
+              limiter.limit(action, observation));
+    ASSERT_EQ(0.0, action.torque[0]);
+    ASSERT_EQ(0.5, action.torque[1]);
+
+    // NaN velocity makes the damped torque NaN
+    observation.velocity << 0.0, NAN;
+    action = Types::Action::Torque(Types::Action::Vector(0.5, 0.5));
+    ASSERT_EQ(Status::ActionLimit::VELOCITY_DAMPING |
+                  Status::ActionLimit::NON_FINITE_TORQUE,
+              limiter.limit(action, observation));
+    ASSERT_EQ(0.5, action.torque[0]);
+    ASSERT_EQ(0.0, action.torque[1]);
+
+    // also without torque limit
+    Limiter unlimited((Limiter::Limits()));
+    observation.velocity.setZero();
+    action = Types::Action::Torque(Types::Action::Vector(INFINITY, 0.5));
+    ASSERT_EQ(Status::ActionLimit::NON_FINITE_TORQUE,
+              unlimited.limit(action, observation));
+    ASSERT_EQ(0.0, action.torque[0]);
+}
+
+TEST(TestActionLimiter, padded_types)
+{
+    typedef TriFingerPaddedTypes PaddedTypes;
+    typedef NJointActionLimiter<PaddedTypes::Action, PaddedTypes::Observation>
+        PaddedLimiter;
+
+    PaddedLimiter::Limits limits;
+    limits.max_torque.setConstant(0.3);
+    PaddedLimiter limiter(limits);
+
+    PaddedTypes::Observation observation;
+    PaddedTypes::Action action = PaddedTypes::Action::Torque(
+        PaddedTypes::Action::UnpaddedVector::Constant(1.0));
+    ASSERT_EQ(Status::ActionLimit::TORQUE_LIMIT,
+              limiter.limit(action, observation));
+    ASSERT_EQ(0.3, action.torque[8]);
+    ASSERT_EQ(0, action.torque[9]);
+}
+
+// the backend applies the limiter and reports the flags in the next status
+TEST(TestActionLimiter, backend)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    auto driver = std::make_shared<ConstantVelocityDriver>();
+    auto backend = std::make_shared<Types::Backend>(
+        driver, data, Types::Backend::LockstepMode());
+
+    Limiter::Limits limits;
+    limits.max_torque.setConstant(1.0);
+    backend->set_action_limiter(std::make_shared<Limiter>(limits));
+    backend->initialize();
+
+    Types::LockstepFrontend frontend(data, backend);
+    TimeIndex t = frontend.append_desired_action(
+        Types::Action::Torque(Types::Action::Vector(3.0, 0.5)));
+    ASSERT_EQ(0u, frontend.get_status(t).active_action_limits);
+    ASSERT_EQ(3.0, frontend.get_desired_action(t).torque[0]);
+    ASSERT_EQ(1.0, frontend.get_applied_action(t).torque[0]);
+    ASSERT_EQ(0.5, frontend.get_applied_action(t).torque[1]);
+
+    t = frontend.append_desired_action(Types::Action::Zero());
+    ASSERT_EQ(Status::ActionLimit::TORQUE_LIMIT,
+              frontend.get_status(t).active_action_limits);
+    frontend.append_desired_action(Types::Action::Zero());
+    ASSERT_EQ(0u, frontend.get_status(t + 1).active_action_limits);
+
+    // must be set before the first action
+    ASSERT_THROW(backend->set_action_limiter(nullptr), std::runtime_error);
+}
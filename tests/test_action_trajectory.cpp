@@ -0,0 +1,190 @@
+/**
+ * @file
+ * @brief Tests for the action trajectory queue.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+#include <robot_interfaces/action_trajectory.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<1> Types;
+typedef Types::Action Action;
+
+//! Driver which returns the action it gets.
+class PassThroughDriver : public RobotDriver<Types::Action, Types::Observation>
+{
+public:
+    void initialize() override
+    {
+    }
+
+    Types::Action apply_action(const Types::Action &desired_action) override
+    {
+        return desired_action;
+    }
+
+    Types::Observation get_latest_observation() override
+    {
+        return Types::Observation();
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+};
+
+//! Create trajectory with torques start, start + 1, ...
+std::vector<Action> make_trajectory(size_t length, double start)
+{
+    std::vector<Action> actions;
+    for (size_t i = 0; i < length; i++)
+    {
+        actions.push_back(Action::Torque(Action::Vector(start + i)));
+    }
+    return actions;
+}
+
+void append_segment(
+    time_series::TimeSeries<TrajectoryPoint<Action>> &trajectory,
+    time_series::Index start,
+    const std::vector<Action> &actions)
+{
+    for (size_t i = 0; i < actions.size(); i++)
+    {
+        TrajectoryPoint<Action> point;
+        point.timeindex = start + i;
+        point.action = actions[i];
+        point.is_segment_start = (i == 0);
+        trajectory.append(point);
+    }
+}
+
+TEST(TestActionTrajectory, queue_preemption)
+{
+    auto trajectory =
+        std::make_shared<time_series::TimeSeries<TrajectoryPoint<Action>>>(
+            100);
+    ActionTrajectoryQueue<Action> queue(trajectory);
+
+    append_segment(*trajectory, 2, make_trajectory(5, 0));
+    ASSERT_TRUE(queue.update());
+    ASSERT_EQ(5u, queue.depth());
+    ASSERT_EQ(5, queue.get_number_of_received_points());
+
+    Action action;
+    ASSERT_FALSE(queue.pop(1, action));
+    ASSERT_TRUE(queue.pop(2, action));
+    ASSERT_EQ(0, action.torque[0]);
+
+    // replaces the actions from step 4 on
+    append_segment(*trajectory, 4, make_trajectory(2, 10));
+    ASSERT_TRUE(queue.update());
+    ASSERT_EQ(3u, queue.depth());
+
+    ASSERT_TRUE(queue.pop(3, action));
+    ASSERT_EQ(1, action.torque[0]);
+    ASSERT_TRUE(queue.pop(4, action));
+    ASSERT_EQ(10, action.torque[0]);
+    ASSERT_TRUE(queue.pop(5, action));
+    ASSERT_EQ(11, action.torque[0]);
+    ASSERT_EQ(0u, queue.depth());
+    ASSERT_FALSE(queue.pop(6, action));
+}
+
+// points that were overwritten before they were read are reported
+TEST(TestActionTrajectory, queue_lost_points)
+{
+    auto trajectory =
+        std::make_shared<time_series::TimeSeries<TrajectoryPoint<Action>>>(
+            10);
+    ActionTrajectoryQueue<Action> queue(trajectory);
+
+    append_segment(*trajectory, 0, make_trajectory(15, 0));
+    ASSERT_FALSE(queue.update());
+    ASSERT_EQ(10u, queue.depth());
+    ASSERT_EQ(15, queue.get_number_of_received_points());
+}
+
+TEST(TestActionTrajectory, lockstep)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    auto backend = std::make_shared<Types::Backend>(
+        std::make_shared<PassThroughDriver>(),
+        data,
+        Types::Backend::LockstepMode());
+    backend->initialize();
+    Types::LockstepFrontend frontend(data, backend);
+
+    TimeIndex t = frontend.append_desired_trajectory(make_trajectory(5, 0));
+    ASSERT_EQ(4, t);
+    for (TimeIndex i = 0; i <= t; i++)
+    {
+        ASSERT_EQ(i, frontend.get_applied_action(i).torque[0]);
+    }
+    ASSERT_EQ(0u, frontend.get_status(t).trajectory_queue_depth);
+
+    t = frontend.append_desired_action(Action::Zero());
+    ASSERT_EQ(5, t);
+    t = frontend.append_desired_trajectory(make_trajectory(3, 10));
+    ASSERT_EQ(8, t);
+    ASSERT_EQ(12, frontend.get_applied_action(8).torque[0]);
+}
+
+TEST(TestActionTrajectory, backend_thread)
+{
+    auto data = std::make_shared<Types::SingleProcessData>(20);
+    auto backend = std::make_shared<Types::Backend>(
+        std::make_shared<PassThroughDriver>(), data, false);
+    backend->initialize();
+    Types::Frontend frontend(data);
+
+    // longer than the history of the time series
+    TimeIndex t = frontend.append_desired_trajectory(make_trajectory(50, 0));
+    ASSERT_EQ(49, t);
+    ASSERT_EQ(49, frontend.get_applied_action(t).torque[0]);
+    ASSERT_EQ(48, frontend.get_applied_action(t - 1).torque[0]);
+    ASSERT_FALSE(frontend.get_status(t).has_error());
+
+    backend->request_shutdown();
+    backend->wait_until_terminated();
+}
+
+// waiting for the backend to read the points ends if the backend terminates
+TEST(TestActionTrajectory, backend_terminates_while_waiting)
+{
+    auto data = std::make_shared<Types::SingleProcessData>(20);
+    auto backend = std::make_shared<Types::Backend>(
+        std::make_shared<PassThroughDriver>(),
+        data,
+        false,
+        std::numeric_limits<double>::infinity(),
+        5);
+    backend->initialize();
+    Types::Frontend frontend(data);
+
+    ASSERT_THROW(frontend.append_desired_trajectory(make_trajectory(50, 0)),
+                 std::runtime_error);
+    backend->wait_until_terminated();
+}
+
+TEST(TestActionTrajectory, invalid_trajectory)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    Types::Frontend frontend(data);
+
+    ASSERT_THROW(frontend.append_desired_trajectory({}),
+                 std::invalid_argument);
+    ASSERT_THROW(frontend.append_desired_trajectory(make_trajectory(2, 0), 5),
+                 std::invalid_argument);
+}
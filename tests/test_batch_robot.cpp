@@ -0,0 +1,226 @@
+/**
+ * @file
+ * @brief Tests for the batch robot types.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <robot_interfaces/batch_n_joint_robot_types.hpp>
+#include <robot_interfaces/columnar_log.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef BatchNJointRobotTypes<2> Types;
+typedef SimpleNJointRobotTypes<2> RobotTypes;
+
+//! Simple driver which sets position = offset + sum of all applied torques.
+class IntegratingDriver
+    : public RobotDriver<RobotTypes::Action, RobotTypes::Observation>
+{
+public:
+    IntegratingDriver(double offset)
+    {
+        observation_.position.setConstant(offset);
+    }
+
+    void initialize() override
+    {
+    }
+
+    RobotTypes::Action apply_action(
+        const RobotTypes::Action &desired_action) override
+    {
+        observation_.position += desired_action.torque;
+        observation_.torque = desired_action.torque;
+        return desired_action;
+    }
+
+    RobotTypes::Observation get_latest_observation() override
+    {
+        return observation_;
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+
+private:
+    RobotTypes::Observation observation_;
+};
+
+TEST(TestBatchRobot, robot_access)
+{
+    Types::Action action(3);
+    ASSERT_EQ(3u, action.num_robots());
+    ASSERT_TRUE(std::isnan(action.position(2, 1)));
+
+    action.set_robot_action(1,
+                            RobotTypes::Action::TorqueAndPosition(
+                                RobotTypes::Action::Vector(1, 2),
+                                RobotTypes::Action::Vector(3, 4)));
+    ASSERT_EQ(2, action.torque(1, 1));
+    ASSERT_EQ(3, action.position(1, 0));
+    ASSERT_EQ(0, action.torque(0, 1));
+
+    RobotTypes::Action robot_action = action.get_robot_action(1);
+    ASSERT_EQ(1, robot_action.torque[0]);
+    ASSERT_EQ(4, robot_action.position[1]);
+
+    // data is flattened robot by robot
+    std::vector<double> torque = action.get_data()[0];
+    ASSERT_EQ((std::vector<double>{0, 0, 1, 2, 0, 0}), torque);
+
+    ASSERT_THROW(Types::Action(Types::Action::Matrix::Zero(3, 2),
+                               Types::Action::None(2),
+                               Types::Action::None(3),
+                               Types::Action::None(3)),
+                 std::invalid_argument);
+}
+
+// step a batch of robots in lockstep mode with matrix actions
+TEST(TestBatchRobot, lockstep_batch)
+{
+    constexpr size_t NUM_ROBOTS = 4;
+    constexpr long NUM_STEPS = 5;
+
+    std::vector<Types::Driver::RobotDriverPtr> drivers;
+    for (size_t k = 0; k < NUM_ROBOTS; k++)
+    {
+        drivers.push_back(std::make_shared<IntegratingDriver>(k));
+    }
+    auto driver = std::make_shared<Types::Driver>(drivers);
+    ASSERT_EQ(NUM_ROBOTS, driver->num_robots());
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    auto backend = std::make_shared<Types::Backend>(
+        driver, data, Types::Backend::LockstepMode());
+    backend->initialize();
+    Types::LockstepBatchFrontend frontend(data, backend);
+
+    // robot k gets torque k for joint 0 and -1 for joint 1
+    Types::Action::Matrix torques(NUM_ROBOTS, 2);
+    for (size_t k = 0; k < NUM_ROBOTS; k++)
+    {
+        torques(k, 0) = k;
+        torques(k, 1) = -1;
+    }
+
+    for (long i = 0; i < NUM_STEPS; i++)
+    {
+        TimeIndex t = frontend.append_desired_actions(torques);
+        ASSERT_EQ(i, t);
+
+        Types::Observation observations = frontend.get_observations();
+        ASSERT_EQ(NUM_ROBOTS, observations.num_robots());
+        for (size_t k = 0; k < NUM_ROBOTS; k++)
+        {
+            ASSERT_EQ(k + (i + 1) * k, observations.position(k, 0));
+            ASSERT_EQ(k - (i + 1.0), observations.position(k, 1));
+        }
+        ASSERT_EQ(torques, frontend.get_applied_action(t).torque);
+    }
+
+    // wrong batch size makes the backend stop
+    TimeIndex t = frontend.append_desired_actions(
+        Types::Action::Matrix::Zero(NUM_ROBOTS + 1, 2));
+    ASSERT_EQ(Status::ErrorStatus::DRIVER_ERROR,
+              frontend.get_status(t + 1).error_status);
+    ASSERT_FALSE(backend->is_running());
+}
+
+//! Get the number of values in each line of a text log.
+std::vector<size_t> count_values_per_line(const std::string &filename)
+{
+    std::vector<size_t> counts;
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string value;
+        size_t count = 0;
+        while (stream >> value)
+        {
+            count++;
+        }
+        counts.push_back(count);
+    }
+    return counts;
+}
+
+// the layout of the log is taken from the data, not from the default batch
+// size of zero
+TEST(TestBatchRobot, logger)
+{
+    constexpr size_t NUM_ROBOTS = 4;
+    constexpr long NUM_STEPS = 5;
+
+    const std::string log_file =
+        (boost::filesystem::temp_directory_path() /
+         boost::filesystem::unique_path())
+            .native();
+    const std::string background_log_file = log_file + "_background";
+
+    std::vector<Types::Driver::RobotDriverPtr> drivers;
+    for (size_t k = 0; k < NUM_ROBOTS; k++)
+    {
+        drivers.push_back(std::make_shared<IntegratingDriver>(k));
+    }
+    auto data = std::make_shared<Types::SingleProcessData>();
+    auto backend = std::make_shared<Types::Backend>(
+        std::make_shared<Types::Driver>(drivers),
+        data,
+        Types::Backend::LockstepMode());
+    backend->initialize();
+    Types::LockstepBatchFrontend frontend(data, backend);
+
+    Types::Logger logger(data, 1);
+    logger.start(background_log_file, Types::Logger::Format::TEXT);
+
+    for (long i = 0; i < NUM_STEPS; i++)
+    {
+        frontend.append_desired_actions(
+            Types::Action::Matrix::Constant(NUM_ROBOTS, 2, i));
+        // give the background logger time to start
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    logger.stop();
+
+    // status, 3 observation and 4 action fields per desired/applied action
+    const size_t num_values =
+        2 + Status().get_data().size() + NUM_ROBOTS * 2 * (3 + 2 * 4);
+
+    logger.write_current_buffer(log_file);
+    for (const std::string &file : {log_file, background_log_file})
+    {
+        std::vector<size_t> counts = count_values_per_line(file);
+        ASSERT_GE(counts.size(), 2u);
+        for (size_t count : counts)
+        {
+            ASSERT_EQ(num_values, count);
+        }
+    }
+
+    logger.write_current_buffer_columnar(log_file);
+    ColumnarLogReader reader(log_file);
+    std::vector<ColumnData> columns =
+        reader.read_columns({"observation_position"});
+    ASSERT_EQ(NUM_ROBOTS * 2, columns[0].width);
+    ASSERT_EQ(static_cast<size_t>(NUM_STEPS), columns[0].num_rows());
+
+    std::remove(log_file.c_str());
+    std::remove(background_log_file.c_str());
+}
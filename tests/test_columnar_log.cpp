@@ -0,0 +1,384 @@
+/**
+ * @file
+ * @brief Tests for the columnar log format.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <thread>
+
+#include <robot_interfaces/columnar_log.hpp>
+#include <robot_interfaces/log_manifest.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/record_log.hpp>
+#include <robot_interfaces/robot_logger.hpp>
+
+#include "dummy_robot_data.hpp"
+
+using namespace robot_interfaces;
+
+//! Test fixture to create and delete a temporary log file
+class TestColumnarLog : public ::testing::Test
+{
+protected:
+    std::string log_file;
+
+    void SetUp() override
+    {
+        boost::filesystem::path temp =
+            boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path();
+        log_file = temp.native();
+    }
+
+    void TearDown() override
+    {
+        // clean up
+        std::remove(log_file.c_str());
+    }
+};
+
+// write a table with partial last row group and read it back
+TEST_F(TestColumnarLog, write_and_read)
+{
+    constexpr size_t NUM_ROWS = 2510;
+    const std::vector<ColumnInfo> columns = {
+        {"index", 1, ColumnEncoding::DELTA},
+        {"vector", 3, ColumnEncoding::DELTA},
+        {"plain", 2, ColumnEncoding::PLAIN}};
+
+    auto value = [](size_t row, size_t j) -> double {
+        switch (j)
+        {
+            case 0:
+                return row;
+            case 1:
+                return std::sin(row * 0.01);
+            case 2:
+                return -1.5 * row;
+            case 3:
+                return std::numeric_limits<double>::quiet_NaN();
+            case 4:
+                return 42;
+            default:
+                return 1.0 / (row + 1);
+        }
+    };
+
+    {
+        ColumnarLogWriter writer(log_file, columns, 1000);
+        ASSERT_EQ(6u, writer.get_row_width());
+
+        std::vector<double> row(6);
+        for (size_t i = 0; i < NUM_ROWS; i++)
+        {
+            for (size_t j = 0; j < row.size(); j++)
+            {
+                row[j] = value(i, j);
+            }
+            writer.append_row(row);
+        }
+    }
+
+    ColumnarLogReader reader(log_file);
+    ASSERT_EQ(3u, reader.get_columns().size());
+    ASSERT_TRUE(reader.has_column("vector"));
+    ASSERT_FALSE(reader.has_column("foo"));
+    ASSERT_THROW(reader.read_column("foo"), std::invalid_argument);
+
+    // read only a subset of the columns in different order
+    std::vector<ColumnData> data = reader.read_columns({"plain", "vector"});
+    ASSERT_EQ(2u, data.size());
+    ASSERT_EQ("plain", data[0].name);
+    ASSERT_EQ(2u, data[0].width);
+    ASSERT_EQ(NUM_ROWS, data[0].num_rows());
+    ASSERT_EQ(3u, data[1].width);
+    ASSERT_EQ(NUM_ROWS, data[1].num_rows());
+
+    for (size_t i = 0; i < NUM_ROWS; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            const double expected = value(i, j + 1);
+            const double actual = data[1].values[i * 3 + j];
+            if (std::isnan(expected))
+            {
+                ASSERT_TRUE(std::isnan(actual));
+            }
+            else
+            {
+                ASSERT_EQ(expected, actual);
+            }
+        }
+        ASSERT_EQ(value(i, 4), data[0].values[i * 2]);
+        ASSERT_EQ(value(i, 5), data[0].values[i * 2 + 1]);
+    }
+
+    ColumnData index = reader.read_column("index");
+    for (size_t i = 0; i < NUM_ROWS; i++)
+    {
+        ASSERT_EQ(static_cast<double>(i), index.values[i]);
+    }
+}
+
+// log robot data with the RobotLogger and read it back
+TEST_F(TestColumnarLog, robot_logger)
+{
+    typedef SimpleNJointRobotTypes<2> Types;
+    constexpr long NUM_STEPS = 50;
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    for (long t = 0; t < NUM_STEPS; t++)
+    {
+        robot_interfaces::testing::append_dummy_step(*data, t);
+    }
+
+    Types::Logger logger(data);
+    logger.write_current_buffer_columnar(log_file);
+
+    ColumnarLogReader reader(log_file);
+    std::vector<ColumnData> columns = reader.read_columns(
+        {"timeindex", "observation_position", "desired_action_torque"});
+
+    // the newest time step is not logged
+    ASSERT_EQ(static_cast<size_t>(NUM_STEPS - 1), columns[0].num_rows());
+    for (long t = 0; t < NUM_STEPS - 1; t++)
+    {
+        ASSERT_EQ(t, columns[0].values[t]);
+        ASSERT_EQ(0.1 * t, columns[1].values[t * 2]);
+        ASSERT_EQ(0.2 * t, columns[1].values[t * 2 + 1]);
+        ASSERT_EQ(t, columns[2].values[t * 2]);
+        ASSERT_EQ(-t, columns[2].values[t * 2 + 1]);
+    }
+}
+
+// log to multiple segments and read them back via the manifest
+TEST_F(TestColumnarLog, robot_logger_segmented)
+{
+    typedef SimpleNJointRobotTypes<2> Types;
+    constexpr long NUM_STEPS = 100;
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    // with a size limit of one byte, every block goes to a new segment
+    Types::Logger logger(data, 10);
+    logger.start_segmented(log_file, Types::Logger::Format::COLUMNAR, 1);
+
+    robot_interfaces::testing::append_dummy_step(*data, 0);
+    // wait until the logger is initialised
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    for (long t = 1; t < NUM_STEPS; t++)
+    {
+        robot_interfaces::testing::append_dummy_step(*data, t);
+        // give the logger time to process the blocks one by one
+        if (t % 10 == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    logger.stop();
+
+    const std::string manifest_path = LogManifest::get_manifest_path(log_file);
+    LogManifest manifest = LogManifest::read(manifest_path);
+    ASSERT_EQ("columnar", manifest.format);
+    ASSERT_GT(manifest.segments.size(), 1u);
+
+    ASSERT_EQ(0, manifest.segments.front().start_timeindex);
+    ASSERT_EQ(NUM_STEPS - 1, manifest.segments.back().end_timeindex);
+    for (size_t i = 1; i < manifest.segments.size(); i++)
+    {
+        ASSERT_EQ(manifest.segments[i - 1].end_timeindex,
+                  manifest.segments[i].start_timeindex);
+    }
+
+    // the reader presents all segments as one continuous log
+    {
+        ColumnarLogReader reader(manifest_path);
+        std::vector<ColumnData> columns =
+            reader.read_columns({"timeindex", "observation_position"});
+
+        // the newest time step is not logged
+        ASSERT_EQ(static_cast<size_t>(NUM_STEPS - 1), columns[0].num_rows());
+        for (long t = 0; t < NUM_STEPS - 1; t++)
+        {
+            ASSERT_EQ(t, columns[0].values[t]);
+            ASSERT_EQ(0.1 * t, columns[1].values[t * 2]);
+            ASSERT_EQ(0.2 * t, columns[1].values[t * 2 + 1]);
+        }
+    }
+
+    for (const std::string &path : manifest.get_segment_paths(manifest_path))
+    {
+        std::remove(path.c_str());
+    }
+    std::remove(manifest_path.c_str());
+}
+
+// segments have to use the same encoding for each column
+TEST_F(TestColumnarLog, segments_with_different_encoding)
+{
+    const std::string segment0 = log_file + "_0.col";
+    const std::string segment1 = log_file + "_1.col";
+    {
+        ColumnarLogWriter writer(segment0,
+                                 {{"value", 1, ColumnEncoding::DELTA}});
+        writer.append_row(std::vector<double>{1.0});
+    }
+    {
+        ColumnarLogWriter writer(segment1,
+                                 {{"value", 1, ColumnEncoding::PLAIN}});
+        writer.append_row(std::vector<double>{2.0});
+    }
+
+    LogManifest manifest;
+    manifest.format = "columnar";
+    manifest.segments = {{0, 1, LogManifest::get_filename(segment0)},
+                         {1, 2, LogManifest::get_filename(segment1)}};
+    const std::string manifest_path = LogManifest::get_manifest_path(log_file);
+    manifest.write(manifest_path);
+
+    ASSERT_THROW(ColumnarLogReader reader(manifest_path), std::runtime_error);
+
+    for (const std::string &path : {segment0, segment1})
+    {
+        std::remove(path.c_str());
+        std::remove((path + ".idx").c_str());
+    }
+    std::remove(manifest_path.c_str());
+}
+
+// compression ratio on noisy measurements and on slowly changing values,
+// for all compressions available in this build
+TEST_F(TestColumnarLog, compression_ratio)
+{
+    constexpr size_t NUM_ROWS = 1000;
+    constexpr size_t WIDTH = 9;
+
+    // lane-wise like in the writer
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0.0, 1e-3);
+    std::vector<double> position(NUM_ROWS * WIDTH);
+    for (size_t lane = 0; lane < WIDTH; lane++)
+    {
+        for (size_t i = 0; i < NUM_ROWS; i++)
+        {
+            position[lane * NUM_ROWS + i] =
+                0.5 * std::sin(M_PI * 1e-3 * i + lane) + noise(generator);
+        }
+    }
+    std::vector<double> timeindex(NUM_ROWS);
+    for (size_t i = 0; i < NUM_ROWS; i++)
+    {
+        timeindex[i] = i;
+    }
+
+    std::vector<std::uint64_t> buffer;
+    auto compression_ratio = [&](const std::vector<double> &values,
+                                 size_t width,
+                                 ColumnCompression compression) {
+        std::string chunk;
+        columnar_log::encode_chunk(values.data(),
+                                   NUM_ROWS,
+                                   width,
+                                   ColumnEncoding::DELTA,
+                                   compression,
+                                   buffer,
+                                   chunk);
+
+        std::vector<double> decoded(values.size());
+        columnar_log::decode_chunk(chunk.data(),
+                                   chunk.size(),
+                                   NUM_ROWS,
+                                   width,
+                                   ColumnEncoding::DELTA,
+                                   compression,
+                                   buffer,
+                                   decoded.data());
+        EXPECT_EQ(values, decoded);
+
+        return static_cast<double>(values.size() * sizeof(double)) /
+               chunk.size();
+    };
+
+    for (ColumnCompression compression :
+         {ColumnCompression::RLE, ColumnCompression::ZSTD})
+    {
+        if (!columnar_log::is_compression_available(compression))
+        {
+            continue;
+        }
+        const std::string name =
+            compression == ColumnCompression::RLE ? "rle" : "zstd";
+
+        // the noise in the low bytes of the mantissa is incompressible, so
+        // only the high bytes (sign, exponent) are compressed
+        const double position_ratio =
+            compression_ratio(position, WIDTH, compression);
+        RecordProperty(name + "_noisy_position_ratio",
+                       std::to_string(position_ratio));
+        EXPECT_GT(position_ratio, 1.1);
+
+        const double timeindex_ratio =
+            compression_ratio(timeindex, 1, compression);
+        RecordProperty(name + "_timeindex_ratio",
+                       std::to_string(timeindex_ratio));
+        EXPECT_GT(timeindex_ratio, 20.0);
+    }
+}
+
+TEST_F(TestColumnarLog, compression_not_available)
+{
+    if (columnar_log::is_compression_available(ColumnCompression::ZSTD))
+    {
+        GTEST_SKIP() << "Built with zstd.";
+    }
+
+    ColumnInfo column = {"value", 1, ColumnEncoding::DELTA};
+    column.compression = ColumnCompression::ZSTD;
+    ASSERT_THROW(ColumnarLogWriter(log_file, {column}),
+                 std::invalid_argument);
+    std::remove(record_log::get_index_path(log_file).c_str());
+}
+
+// files of format version 2 (without compression field) can still be read
+TEST_F(TestColumnarLog, read_format_version_2)
+{
+    const std::vector<double> values = {1.0, 2.0, 4.0};
+    {
+        RecordLogWriter file(log_file, columnar_log::MAGIC, 2);
+
+        std::string record;
+        columnar_log::append_value<std::uint32_t>(record, 1);
+        columnar_log::append_value<std::uint32_t>(record, 5);
+        record.append("value");
+        columnar_log::append_value<std::uint32_t>(record, 1);
+        columnar_log::append_value<std::uint8_t>(
+            record, static_cast<std::uint8_t>(ColumnEncoding::DELTA));
+        file.append(record, -1);
+
+        std::vector<std::uint64_t> buffer;
+        std::string chunk;
+        columnar_log::encode_chunk(values.data(),
+                                   values.size(),
+                                   1,
+                                   ColumnEncoding::DELTA,
+                                   ColumnCompression::RLE,
+                                   buffer,
+                                   chunk);
+        record.clear();
+        columnar_log::append_value<std::uint32_t>(record, values.size());
+        columnar_log::append_value<std::uint64_t>(record, chunk.size());
+        record.append(chunk);
+        file.append(record, 0);
+    }
+
+    ColumnarLogReader reader(log_file);
+    ASSERT_EQ(ColumnCompression::RLE, reader.get_columns()[0].compression);
+    ASSERT_EQ(values, reader.read_column("value").values);
+
+    std::remove(record_log::get_index_path(log_file).c_str());
+}
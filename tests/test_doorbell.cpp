@@ -0,0 +1,88 @@
+/**
+ * @file
+ * @brief Tests for the Doorbell.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <robot_interfaces/doorbell.hpp>
+
+using namespace robot_interfaces;
+
+TEST(TestDoorbell, wait_timeout)
+{
+    Doorbell doorbell;
+    uint32_t sequence = doorbell.get_sequence();
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_FALSE(doorbell.wait(sequence, 0.01));
+    ASSERT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(9));
+
+    // already rung since get_sequence()
+    doorbell.ring();
+    ASSERT_TRUE(doorbell.wait(sequence, 0.01));
+}
+
+TEST(TestDoorbell, wake_up)
+{
+    Doorbell doorbell;
+    uint32_t sequence = doorbell.get_sequence();
+
+    std::thread ringer([&doorbell]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        doorbell.ring();
+    });
+    ASSERT_TRUE(doorbell.wait(sequence, 5.0));
+    ASSERT_EQ(sequence + 1, doorbell.get_sequence());
+    ringer.join();
+}
+
+TEST(TestDoorbell, shared_memory)
+{
+    const std::string id = "test_doorbell_" + std::to_string(getpid());
+
+    ASSERT_THROW(Doorbell::create_follower(id), std::runtime_error);
+
+    auto leader = Doorbell::create_leader(id);
+    auto follower = Doorbell::create_follower(id);
+
+    uint32_t sequence = follower->get_sequence();
+    std::thread ringer([&leader]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        leader->ring();
+    });
+    ASSERT_TRUE(follower->wait(sequence, 5.0));
+    ringer.join();
+
+    // memory is removed by the leader
+    leader.reset();
+    ASSERT_THROW(Doorbell::create_follower(id), std::runtime_error);
+}
+
+TEST(TestDoorbell, wait_any)
+{
+    Doorbell a, b;
+    std::vector<Doorbell *> doorbells = {&a, &b};
+    std::vector<uint32_t> sequences = {a.get_sequence(), b.get_sequence()};
+
+    ASSERT_FALSE(Doorbell::wait_any(doorbells, sequences, 0.01));
+
+    std::thread ringer([&b]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        b.ring();
+    });
+    ASSERT_TRUE(Doorbell::wait_any(doorbells, sequences, 5.0));
+    ASSERT_EQ(sequences[0], a.get_sequence());
+    ASSERT_NE(sequences[1], b.get_sequence());
+    ringer.join();
+
+    ASSERT_THROW(Doorbell::wait_any({&a}, sequences), std::invalid_argument);
+}
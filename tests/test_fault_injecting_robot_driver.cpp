@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @brief Tests for the FaultInjectingRobotDriver.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+
+#include <robot_interfaces/example.hpp>
+#include <robot_interfaces/fault_injecting_robot_driver.hpp>
+#include <robot_interfaces/monitored_robot_driver.hpp>
+
+using namespace robot_interfaces;
+
+typedef FaultInjectingRobotDriver<example::Driver> FaultyDriver;
+
+TEST(TestFaultInjectingRobotDriver, latency_distribution)
+{
+    std::mt19937_64 engine(42);
+
+    ASSERT_EQ(0.0, LatencyDistribution().sample(engine));
+    ASSERT_EQ(0.5, LatencyDistribution::constant(0.5).sample(engine));
+    for (int i = 0; i < 100; i++)
+    {
+        double value = LatencyDistribution::uniform(0.1, 0.2).sample(engine);
+        ASSERT_GE(value, 0.1);
+        ASSERT_LE(value, 0.2);
+        ASSERT_GE(LatencyDistribution::normal(0, 1).sample(engine), 0.0);
+        ASSERT_GE(LatencyDistribution::exponential(0.1).sample(engine), 0.0);
+    }
+}
+
+TEST(TestFaultInjectingRobotDriver, error_after_num_actions)
+{
+    FaultInjectionConfig config;
+    config.error_after_num_actions = 3;
+    config.error_message = "foo";
+    FaultyDriver driver(std::make_shared<example::Driver>(0, 10), config);
+    driver.initialize();
+
+    example::Action action;
+    action.values[0] = 1;
+    action.values[1] = 2;
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_EQ("", driver.get_error());
+        ASSERT_EQ(2, driver.apply_action(action).values[1]);
+    }
+    ASSERT_EQ("foo", driver.get_error());
+    ASSERT_EQ(3u, driver.get_number_of_actions());
+}
+
+TEST(TestFaultInjectingRobotDriver, stall)
+{
+    FaultInjectionConfig config;
+    config.stall_probability = 1.0;
+    config.stall_duration_s = 0.02;
+    config.num_load_threads = 1;
+    config.load_duty_cycle = 0.5;
+    FaultyDriver driver(std::make_shared<example::Driver>(0, 10), config);
+    driver.initialize();
+
+    example::Action action;
+    action.values[0] = 0;
+    action.values[1] = 0;
+    auto start = std::chrono::steady_clock::now();
+    driver.apply_action(action);
+    ASSERT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(20));
+    ASSERT_EQ(1u, driver.get_number_of_stalls());
+}
+
+TEST(TestFaultInjectingRobotDriver, monitored_driver_timeout)
+{
+    // a stall longer than the allowed action duration is detected by the
+    // MonitoredRobotDriver
+    FaultInjectionConfig config;
+    config.stall_probability = 1.0;
+    config.stall_duration_s = 0.1;
+    auto faulty_driver =
+        std::make_shared<FaultyDriver>(std::make_shared<example::Driver>(0, 10),
+                                       config);
+    MonitoredRobotDriver<FaultyDriver> driver(faulty_driver, 0.02, 1.0);
+    driver.initialize();
+
+    example::Action action;
+    action.values[0] = 0;
+    action.values[1] = 0;
+    driver.apply_action(action);
+    ASSERT_EQ("Action did not end on time, shutting down.",
+              driver.get_error());
+}
@@ -0,0 +1,133 @@
+/**
+ * @file
+ * @brief Tests for the log replay drivers.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+#include <robot_interfaces/log_replay_driver.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/replay_clock.hpp>
+#include <robot_interfaces/sensors/sensor_backend.hpp>
+#include <robot_interfaces/sensors/sensor_frontend.hpp>
+#include <robot_interfaces/sensors/sensor_log_replay_driver.hpp>
+#include <robot_interfaces/sensors/sensor_logger.hpp>
+
+#include "dummy_sensor_driver.hpp"
+
+using namespace robot_interfaces;
+
+TEST(TestReplayClock, scaled_time)
+{
+    ReplayClock clock(ReplayMode::SCALED_TIME, 2.0);
+
+    auto start = std::chrono::steady_clock::now();
+    clock.wait_until(10.0);
+    clock.wait_until(10.1);
+    std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+
+    // 0.1 s of recording at double speed
+    ASSERT_GE(duration.count(), 0.05);
+    ASSERT_LT(duration.count(), 0.09);
+
+    ASSERT_THROW(ReplayClock(ReplayMode::SCALED_TIME, 0.0),
+                 std::invalid_argument);
+}
+
+// replay a log through the backend and check that the frontend gets the
+// recorded observations
+TEST(TestLogReplayDriver, replay_through_backend)
+{
+    typedef SimpleNJointRobotTypes<2> Types;
+    constexpr size_t NUM_STEPS = 50;
+
+    std::vector<Types::LogEntry> log;
+    for (size_t t = 0; t < NUM_STEPS; t++)
+    {
+        Types::LogEntry entry;
+        entry.timeindex = t;
+        entry.timestamp = 0.001 * t;
+        entry.observation.position << t, -1.0 * t;
+        log.push_back(entry);
+    }
+
+    auto driver = std::make_shared<LogReplayDriver<Types::Action,
+                                                   Types::Observation>>(
+        log, ReplayMode::AS_FAST_AS_POSSIBLE);
+    auto data = std::make_shared<Types::SingleProcessData>();
+    // stop at the end of the log
+    constexpr bool real_time_mode = false;
+    Types::Backend backend(driver,
+                           data,
+                           real_time_mode,
+                           std::numeric_limits<double>::infinity(),
+                           driver->size());
+    backend.initialize();
+    Types::Frontend frontend(data);
+
+    for (size_t i = 0; i < NUM_STEPS; i++)
+    {
+        auto t = frontend.append_desired_action(
+            Types::Action::Torque(Types::Action::Vector(i, i)));
+        Types::Observation observation = frontend.get_observation(t);
+        ASSERT_EQ(i, t);
+        ASSERT_EQ(log[i].observation.position, observation.position);
+    }
+
+    backend.wait_until_terminated();
+    ASSERT_TRUE(driver->is_finished());
+    ASSERT_EQ("", driver->get_error());
+    ASSERT_EQ(
+        Types::Backend::TerminationReason::MAXIMUM_NUMBER_OF_ACTIONS_REACHED,
+        backend.get_termination_reason());
+}
+
+TEST(TestSensorLogReplayDriver, replay)
+{
+    constexpr int NUM_OBSERVATIONS = 20;
+    const std::string log_file =
+        (boost::filesystem::temp_directory_path() /
+         boost::filesystem::unique_path())
+            .native();
+
+    // record a log
+    {
+        auto data = std::make_shared<SingleProcessSensorData<int>>();
+        auto driver =
+            std::make_shared<robot_interfaces::testing::DummySensorDriver>();
+        auto frontend = SensorFrontend<int>(data);
+        auto logger = SensorLogger<int>(data, NUM_OBSERVATIONS);
+        logger.start();
+        auto backend = SensorBackend<int>(driver, data);
+        frontend.get_observation(NUM_OBSERVATIONS);
+        logger.stop_and_save(log_file);
+    }
+
+    // replay it
+    {
+        auto data = std::make_shared<SingleProcessSensorData<int>>();
+        auto driver = std::make_shared<SensorLogReplayDriver<int>>(
+            log_file, ReplayMode::AS_FAST_AS_POSSIBLE);
+        ASSERT_EQ(static_cast<size_t>(NUM_OBSERVATIONS), driver->size());
+
+        auto frontend = SensorFrontend<int>(data);
+        auto backend = SensorBackend<int>(driver, data);
+
+        for (int t = 0; t < NUM_OBSERVATIONS; t++)
+        {
+            ASSERT_EQ(t, frontend.get_observation(t));
+        }
+        // after the end, the last observation is repeated
+        ASSERT_EQ(NUM_OBSERVATIONS - 1,
+                  frontend.get_observation(NUM_OBSERVATIONS + 2));
+        ASSERT_TRUE(driver->is_finished());
+    }
+
+    std::remove(log_file.c_str());
+}
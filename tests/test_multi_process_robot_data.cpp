@@ -0,0 +1,87 @@
+/**
+ * @file
+ * @brief Tests for attaching to and re-attaching to MultiProcessRobotData.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <robot_interfaces/n_joint_robot_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<1> Types;
+
+std::string get_prefix(const std::string &name)
+{
+    return "test_multi_process_robot_data_" + name + "_" +
+           std::to_string(getpid());
+}
+
+TEST(TestMultiProcessRobotData, no_master)
+{
+    ASSERT_THROW(Types::MultiProcessData(get_prefix("no_master"), false),
+                 std::runtime_error);
+    ASSERT_THROW(
+        Types::MultiProcessData(get_prefix("no_master"), false, 1000, 0.01),
+        std::runtime_error);
+}
+
+TEST(TestMultiProcessRobotData, wait_for_master)
+{
+    const std::string prefix = get_prefix("wait_for_master");
+
+    std::shared_ptr<Types::MultiProcessData> master;
+    std::thread master_thread([&master, &prefix]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        master = std::make_shared<Types::MultiProcessData>(prefix, true, 10);
+    });
+
+    Types::MultiProcessData follower(prefix, false, 1000, 5.0);
+    master_thread.join();
+
+    ASSERT_EQ(master->get_epoch(), follower.get_epoch());
+    master->desired_action->append(Types::Action::Zero());
+    ASSERT_EQ(1u, follower.desired_action->length());
+
+    Types::MultiProcessData::clear_attach_state(prefix);
+}
+
+TEST(TestMultiProcessRobotData, reattach)
+{
+    const std::string prefix = get_prefix("reattach");
+
+    auto master = std::make_shared<Types::MultiProcessData>(prefix, true, 10);
+    auto follower =
+        std::make_shared<Types::MultiProcessData>(prefix, false, 1000, 1.0);
+    Types::Frontend frontend(follower);
+    const uint64_t epoch = follower->get_epoch();
+
+    frontend.append_desired_action(Types::Action::Zero());
+    ASSERT_FALSE(follower->reattach_if_needed());
+
+    // restart the master
+    master.reset();
+    master = std::make_shared<Types::MultiProcessData>(prefix, true, 10);
+    ASSERT_EQ(epoch + 1, master->get_epoch());
+
+    // the frontend does not re-attach implicitly
+    ASSERT_TRUE(follower->needs_reattach());
+    ASSERT_THROW(frontend.append_desired_action(Types::Action::Zero()),
+                 std::runtime_error);
+    ASSERT_THROW(frontend.get_status(0), std::runtime_error);
+    ASSERT_EQ(epoch, follower->get_epoch());
+
+    ASSERT_TRUE(follower->reattach_if_needed());
+    ASSERT_FALSE(follower->needs_reattach());
+    ASSERT_EQ(epoch + 1, follower->get_epoch());
+    ASSERT_EQ(0, frontend.append_desired_action(Types::Action::Zero()));
+    ASSERT_EQ(1u, master->desired_action->length());
+
+    Types::MultiProcessData::clear_attach_state(prefix);
+}
@@ -0,0 +1,193 @@
+/**
+ * @file
+ * @brief Tests for the observation filters.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/observation_filter.hpp>
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<2> Types;
+typedef Types::Observation Observation;
+
+//! Driver whose observed position counts the steps.
+class CountingDriver : public RobotDriver<Types::Action, Observation>
+{
+public:
+    void initialize() override
+    {
+    }
+
+    Types::Action apply_action(const Types::Action &desired_action) override
+    {
+        return desired_action;
+    }
+
+    Observation get_latest_observation() override
+    {
+        Observation observation;
+        observation.position.setConstant(step_++);
+        return observation;
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+
+private:
+    int step_ = 0;
+};
+
+TEST(TestObservationFilter, low_pass)
+{
+    LowPassObservationFilter<Observation> filter(
+        &Observation::position, &Observation::velocity, 1.0);
+    ASSERT_THROW(LowPassObservationFilter<Observation>(
+                     &Observation::position, &Observation::position, 0.0),
+                 std::invalid_argument);
+
+    Observation observation;
+    observation.position << 1, 2;
+    filter.filter(observation, 0.0);
+    ASSERT_EQ(1.0, observation.velocity[0]);
+
+    // with dt equal to the time constant, alpha = 0.5
+    const double tau = 1.0 / (2 * M_PI);
+    observation.position << 3, 2;
+    filter.filter(observation, tau);
+    ASSERT_DOUBLE_EQ(2.0, observation.velocity[0]);
+    ASSERT_DOUBLE_EQ(2.0, observation.velocity[1]);
+    // input is not modified
+    ASSERT_EQ(3.0, observation.position[0]);
+}
+
+TEST(TestObservationFilter, moving_average)
+{
+    MovingAverageObservationFilter<Observation> filter(
+        &Observation::torque, &Observation::torque, 3);
+
+    Observation observation;
+    const double values[] = {3, 6, 9, 12};
+    const double expected[] = {3, 4.5, 6, 9};
+    for (int i = 0; i < 4; i++)
+    {
+        observation.torque.setConstant(values[i]);
+        filter.filter(observation, i);
+        ASSERT_DOUBLE_EQ(expected[i], observation.torque[1]);
+    }
+}
+
+// rounding errors of the running sum vanish after a pass through the window
+TEST(TestObservationFilter, moving_average_rounding)
+{
+    MovingAverageObservationFilter<Observation> filter(
+        &Observation::torque, &Observation::torque, 2);
+
+    Observation observation;
+    const double values[] = {1e16, 1, 1, 1};
+    for (int i = 0; i < 4; i++)
+    {
+        observation.torque.setConstant(values[i]);
+        filter.filter(observation, i);
+    }
+    ASSERT_EQ(1.0, observation.torque[0]);
+}
+
+TEST(TestObservationFilter, finite_difference)
+{
+    ASSERT_THROW(FiniteDifferenceObservationFilter<Observation>(
+                     &Observation::position, &Observation::position),
+                 std::invalid_argument);
+
+    FiniteDifferenceObservationFilter<Observation> filter(
+        &Observation::position, &Observation::velocity);
+
+    Observation observation;
+    observation.position << 1, 1;
+    observation.velocity << 5, 5;
+    filter.filter(observation, 1.0);
+    ASSERT_EQ(0.0, observation.velocity[0]);
+
+    observation.position << 2, 0;
+    filter.filter(observation, 1.5);
+    ASSERT_DOUBLE_EQ(2.0, observation.velocity[0]);
+    ASSERT_DOUBLE_EQ(-2.0, observation.velocity[1]);
+}
+
+TEST(TestObservationFilter, backend_pipeline)
+{
+    auto pipeline = std::make_shared<ObservationFilterPipeline<Observation>>();
+    pipeline->add(std::make_shared<MovingAverageObservationFilter<Observation>>(
+        &Observation::position, &Observation::torque, 2));
+    pipeline->add(
+        std::make_shared<FiniteDifferenceObservationFilter<Observation>>(
+            &Observation::position, &Observation::velocity));
+    ASSERT_THROW(pipeline->add(nullptr), std::invalid_argument);
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    auto backend =
+        std::make_shared<Types::Backend>(std::make_shared<CountingDriver>(),
+                                         data,
+                                         Types::Backend::LockstepMode());
+    backend->set_observation_filter(pipeline);
+    backend->initialize();
+    Types::LockstepFrontend frontend(data, backend);
+
+    TimeIndex t = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        t = frontend.append_desired_action(Types::Action::Zero());
+    }
+
+    Observation observation = frontend.get_observation(t);
+    ASSERT_EQ(2.0, observation.position[0]);
+    ASSERT_DOUBLE_EQ(1.5, observation.torque[0]);
+    ASSERT_GT(observation.velocity[0], 0.0);
+
+    // cannot be changed once actions were sent
+    ASSERT_THROW(backend->set_observation_filter(nullptr), std::runtime_error);
+}
+
+// in lockstep mode, the filter gets the time of the steps, not wall-clock time
+TEST(TestObservationFilter, backend_lockstep_time)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    Types::Backend::LockstepMode mode;
+    mode.step_period_s = 0.5;
+    auto backend = std::make_shared<Types::Backend>(
+        std::make_shared<CountingDriver>(), data, mode);
+    backend->set_observation_filter(
+        std::make_shared<FiniteDifferenceObservationFilter<Observation>>(
+            &Observation::position, &Observation::velocity));
+    backend->initialize();
+    Types::LockstepFrontend frontend(data, backend);
+
+    TimeIndex t = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        t = frontend.append_desired_action(Types::Action::Zero());
+    }
+
+    // position increases by 1 per step of 0.5 s
+    for (TimeIndex i = 1; i <= t + 1; i++)
+    {
+        ASSERT_DOUBLE_EQ(2.0, frontend.get_observation(i).velocity[0]);
+    }
+
+    mode.step_period_s = 0;
+    ASSERT_THROW(
+        Types::Backend(std::make_shared<CountingDriver>(), data, mode),
+        std::invalid_argument);
+}
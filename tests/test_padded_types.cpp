@@ -0,0 +1,101 @@
+/**
+ * @file
+ * @brief Tests for the padded action/observation types.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstdio>
+
+#include <robot_interfaces/columnar_log.hpp>
+#include <robot_interfaces/finger_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef TriFingerPaddedTypes Types;
+
+TEST(TestPaddedTypes, layout)
+{
+    static_assert(Types::Action::padded_num_joints == 12, "");
+    static_assert(Types::Observation::padded_num_joints == 12, "");
+    static_assert(Types::Observation::padded_num_fingers == 4, "");
+    static_assert(PaddedFingerTypes<3, float>::Action::padded_num_joints == 16,
+                  "");
+    static_assert(alignof(Types::Observation) == SIMD_ALIGNMENT, "");
+    static_assert(!std::is_polymorphic<Types::Action>::value, "");
+    static_assert(!std::is_polymorphic<Types::Observation>::value, "");
+    static_assert(is_loggable<Types::Action>::value, "");
+    static_assert(is_loggable<Types::Observation>::value, "");
+
+    Types::Action action = Types::Action::Position(
+        Types::Action::UnpaddedVector::Constant(1.5));
+    ASSERT_EQ(1.5, action.position[8]);
+    ASSERT_EQ(0, action.position[9]);
+    ASSERT_TRUE(std::isnan(action.position_kp[8]));
+    ASSERT_EQ(0, action.position_kp[11]);
+    ASSERT_EQ(9u, action.get_data()[1].size());
+}
+
+TEST(TestPaddedTypes, conversion)
+{
+    TriFingerTypes::Observation observation;
+    for (int i = 0; i < 9; i++)
+    {
+        observation.position[i] = i;
+        observation.velocity[i] = -i;
+    }
+    observation.tip_force << 0.1, 0.2, 0.3;
+
+    Types::Observation padded(observation);
+    ASSERT_EQ(8, padded.position[8]);
+    ASSERT_EQ(0, padded.position[9]);
+    ASSERT_EQ(0.3, padded.tip_force[2]);
+    ASSERT_EQ(0, padded.tip_force[3]);
+
+    TriFingerTypes::Observation unpadded = padded.to_unpadded();
+    ASSERT_EQ(observation.position, unpadded.position);
+    ASSERT_EQ(observation.velocity, unpadded.velocity);
+    ASSERT_EQ(observation.tip_force, unpadded.tip_force);
+    ASSERT_EQ(observation.get_data(), padded.get_data());
+
+    TriFingerTypes::Action action = TriFingerTypes::Action::TorqueAndPosition(
+        TriFingerTypes::Action::Vector::Constant(0.5),
+        TriFingerTypes::Action::Vector::Constant(1.0));
+    Types::Action padded_action(action);
+    ASSERT_EQ(action.get_data()[0], padded_action.get_data()[0]);
+    ASSERT_EQ(action.position, padded_action.to_unpadded().position);
+}
+
+// the logger only writes the joint values, not the padding
+TEST(TestPaddedTypes, columnar_log)
+{
+    const std::string log_file =
+        (boost::filesystem::temp_directory_path() /
+         boost::filesystem::unique_path())
+            .native();
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    for (int t = 0; t < 10; t++)
+    {
+        Types::Observation observation;
+        observation.position.setConstant(t);
+        data->desired_action->append(Types::Action::Zero());
+        data->applied_action->append(Types::Action::Zero());
+        data->observation->append(observation);
+        data->status->append(Status());
+    }
+
+    Types::Logger logger(data, 10);
+    logger.write_current_buffer_columnar(log_file);
+
+    ColumnarLogReader reader(log_file);
+    ColumnData position = reader.read_column("observation_position");
+    ASSERT_EQ(9u, position.width);
+    ASSERT_EQ(9u, position.num_rows());
+    ASSERT_EQ(4.0, position.values[4 * 9 + 8]);
+
+    std::remove(log_file.c_str());
+    std::remove(record_log::get_index_path(log_file).c_str());
+}
@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @brief Tests for the ReadinessNotifier.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <poll.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <robot_interfaces/readiness_notifier.hpp>
+
+using namespace robot_interfaces;
+
+//! Wait until fd is readable or the timeout (in ms) expires.
+bool is_readable(int fd, int timeout_ms)
+{
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, timeout_ms) == 1 && (pfd.revents & POLLIN);
+}
+
+TEST(TestReadinessNotifier, ready_sources)
+{
+    auto a = std::make_shared<Doorbell>();
+    auto b = std::make_shared<Doorbell>();
+
+    ReadinessNotifier notifier;
+    ReadinessNotifier::SourceId id_a = notifier.add_source(a);
+    ReadinessNotifier::SourceId id_b = notifier.add_source(b);
+
+    ASSERT_FALSE(is_readable(notifier.get_fd(), 20));
+    ASSERT_TRUE(notifier.take_ready_sources().empty());
+
+    b->ring();
+    ASSERT_TRUE(is_readable(notifier.get_fd(), 5000));
+    ASSERT_EQ(std::vector<ReadinessNotifier::SourceId>({id_b}),
+              notifier.take_ready_sources());
+    ASSERT_FALSE(is_readable(notifier.get_fd(), 0));
+
+    a->ring();
+    b->ring();
+    ASSERT_TRUE(is_readable(notifier.get_fd(), 5000));
+    // the second ring may be reported separately
+    std::vector<ReadinessNotifier::SourceId> ready =
+        notifier.take_ready_sources();
+    if (ready.size() == 1)
+    {
+        ASSERT_TRUE(is_readable(notifier.get_fd(), 5000));
+        for (auto id : notifier.take_ready_sources())
+        {
+            ready.push_back(id);
+        }
+    }
+    ASSERT_EQ(2u, ready.size());
+    ASSERT_NE(ready[0], ready[1]);
+    ASSERT_TRUE(ready[0] == id_a || ready[1] == id_a);
+}
+
+TEST(TestReadinessNotifier, replace_and_remove_source)
+{
+    auto a = std::make_shared<Doorbell>();
+    auto b = std::make_shared<Doorbell>();
+    auto c = std::make_shared<Doorbell>();
+
+    ReadinessNotifier notifier;
+    ReadinessNotifier::SourceId id_a = notifier.add_source(a);
+    ReadinessNotifier::SourceId id_b = notifier.add_source(b);
+
+    // after replacing, only the new doorbell is watched
+    notifier.replace_source(id_a, c);
+    a->ring();
+    ASSERT_FALSE(is_readable(notifier.get_fd(), 50));
+    c->ring();
+    ASSERT_TRUE(is_readable(notifier.get_fd(), 5000));
+    ASSERT_EQ(std::vector<ReadinessNotifier::SourceId>({id_a}),
+              notifier.take_ready_sources());
+
+    notifier.remove_source(id_b);
+    b->ring();
+    ASSERT_FALSE(is_readable(notifier.get_fd(), 50));
+    ASSERT_THROW(notifier.remove_source(id_b), std::out_of_range);
+    ASSERT_THROW(notifier.replace_source(42, a), std::out_of_range);
+}
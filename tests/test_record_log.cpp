@@ -0,0 +1,306 @@
+/**
+ * @file
+ * @brief Tests for the crash-consistent record log and the writers using it.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include <robot_interfaces/columnar_log.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/record_log.hpp>
+#include <robot_interfaces/robot_log_reader.hpp>
+#include <robot_interfaces/robot_logger.hpp>
+
+#include "dummy_robot_data.hpp"
+
+using namespace robot_interfaces;
+
+constexpr char TEST_MAGIC[8] = {'T', 'E', 'S', 'T', 'T', 'E', 'S', 'T'};
+
+//! Test fixture to create and delete a temporary log file
+class TestRecordLog : public ::testing::Test
+{
+protected:
+    std::string log_file;
+
+    void SetUp() override
+    {
+        boost::filesystem::path temp =
+            boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path();
+        log_file = temp.native();
+    }
+
+    void TearDown() override
+    {
+        // clean up
+        std::remove(log_file.c_str());
+        std::remove(record_log::get_index_path(log_file).c_str());
+    }
+
+    //! Write records with payload "record <i>" and key 10 * i.
+    void write_records(size_t num_records)
+    {
+        RecordLogWriter writer(log_file, TEST_MAGIC, 1, 10);
+        for (size_t i = 0; i < num_records; i++)
+        {
+            writer.append("record " + std::to_string(i), 10 * i);
+        }
+    }
+
+    //! Cut off the given number of bytes at the end of the file.
+    void cut_off(size_t num_bytes)
+    {
+        const size_t size = boost::filesystem::file_size(log_file);
+        ASSERT_EQ(0, ::truncate(log_file.c_str(), size - num_bytes));
+    }
+};
+
+TEST_F(TestRecordLog, write_and_read)
+{
+    write_records(25);
+
+    RecordLogReader reader(log_file, TEST_MAGIC);
+    ASSERT_EQ(1u, reader.get_format_version());
+    ASSERT_EQ(25u, reader.size());
+    ASSERT_FALSE(reader.is_truncated());
+
+    std::string payload;
+    for (size_t i = 0; i < reader.size(); i++)
+    {
+        reader.read(i, payload);
+        ASSERT_EQ("record " + std::to_string(i), payload);
+        ASSERT_EQ(static_cast<std::int64_t>(10 * i), reader.get_key(i));
+    }
+
+    ASSERT_THROW(RecordLogReader(log_file, columnar_log::MAGIC),
+                 std::runtime_error);
+}
+
+// simulate a crash while writing the last record
+TEST_F(TestRecordLog, torn_last_record)
+{
+    write_records(25);
+    cut_off(3);
+
+    RecordLogReader reader(log_file, TEST_MAGIC);
+    ASSERT_EQ(24u, reader.size());
+    ASSERT_TRUE(reader.is_truncated());
+
+    std::string payload;
+    reader.read(23, payload);
+    ASSERT_EQ("record 23", payload);
+
+    // repair removes the incomplete record
+    ASSERT_EQ(24u, RecordLogReader::repair(log_file));
+    RecordLogReader repaired(log_file, TEST_MAGIC);
+    ASSERT_EQ(24u, repaired.size());
+    ASSERT_FALSE(repaired.is_truncated());
+}
+
+// records after the last index checkpoint and without index are found by
+// scanning
+TEST_F(TestRecordLog, missing_index)
+{
+    write_records(25);
+    std::remove(record_log::get_index_path(log_file).c_str());
+
+    RecordLogReader reader(log_file, TEST_MAGIC);
+    ASSERT_EQ(25u, reader.size());
+    ASSERT_FALSE(reader.is_truncated());
+    ASSERT_EQ(240, reader.get_key(24));
+}
+
+TEST_F(TestRecordLog, corrupted_record)
+{
+    write_records(5);
+
+    // flip a byte in the payload of the last record
+    {
+        std::fstream file(log_file,
+                          std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('X');
+    }
+
+    std::remove(record_log::get_index_path(log_file).c_str());
+    RecordLogReader reader(log_file, TEST_MAGIC);
+    ASSERT_EQ(4u, reader.size());
+    ASSERT_TRUE(reader.is_truncated());
+}
+
+// the columnar log can be recovered up to the last complete row group
+TEST_F(TestRecordLog, columnar_log_recovery)
+{
+    constexpr size_t ROWS_PER_GROUP = 10;
+    {
+        ColumnarLogWriter writer(log_file, {{"x", 1}}, ROWS_PER_GROUP);
+        for (size_t i = 0; i < 55; i++)
+        {
+            writer.append_row({static_cast<double>(i)});
+        }
+    }
+    // cut into the last, partial row group
+    cut_off(1);
+
+    ColumnarLogReader reader(log_file);
+    ASSERT_TRUE(reader.is_truncated());
+    ColumnData x = reader.read_column("x");
+    ASSERT_EQ(50u, x.num_rows());
+    for (size_t i = 0; i < x.num_rows(); i++)
+    {
+        ASSERT_EQ(static_cast<double>(i), x.values[i]);
+    }
+}
+
+// stream a binary log with the background logger and recover a torn file
+TEST_F(TestRecordLog, robot_logger_binary)
+{
+    typedef SimpleNJointRobotTypes<2> Types;
+    constexpr long NUM_STEPS = 100;
+    constexpr int BLOCK_SIZE = 10;
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    Types::Logger logger(data, BLOCK_SIZE);
+    logger.start(log_file, Types::Logger::Format::BINARY);
+
+    robot_interfaces::testing::append_dummy_step(*data, 0);
+    // wait until the logger is initialised
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    for (long t = 1; t < NUM_STEPS; t++)
+    {
+        robot_interfaces::testing::append_dummy_step(*data, t);
+    }
+    logger.stop();
+
+    {
+        Types::BinaryLogReader reader(log_file);
+        ASSERT_FALSE(reader.truncated);
+        // the newest time step is not logged
+        ASSERT_EQ(static_cast<size_t>(NUM_STEPS - 1), reader.data.size());
+        for (long t = 0; t < NUM_STEPS - 1; t++)
+        {
+            ASSERT_EQ(t, reader.data[t].timeindex);
+            ASSERT_EQ(0.2 * t, reader.data[t].observation.position[1]);
+            ASSERT_EQ(-t, reader.data[t].desired_action.torque[1]);
+        }
+    }
+
+    // only the last block is lost
+    cut_off(1);
+    {
+        Types::BinaryLogReader reader(log_file);
+        ASSERT_TRUE(reader.truncated);
+        ASSERT_EQ(static_cast<size_t>(NUM_STEPS - BLOCK_SIZE),
+                  reader.data.size());
+
+        // reading again replaces the data instead of appending it
+        reader.read_file(log_file);
+        ASSERT_TRUE(reader.truncated);
+        ASSERT_EQ(static_cast<size_t>(NUM_STEPS - BLOCK_SIZE),
+                  reader.data.size());
+    }
+}
+
+// single precision types are logged without conversion to double
+TEST_F(TestRecordLog, robot_logger_binary_float)
+{
+    typedef SimpleNJointRobotTypesF<2> Types;
+    constexpr long NUM_STEPS = 20;
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    for (long t = 0; t < NUM_STEPS; t++)
+    {
+        robot_interfaces::testing::append_dummy_step(*data, t);
+    }
+
+    Types::Logger logger(data, 10);
+    logger.write_current_buffer_binary(log_file);
+
+    Types::BinaryLogReader reader(log_file);
+    // the newest time step is not logged
+    ASSERT_EQ(static_cast<size_t>(NUM_STEPS - 1), reader.data.size());
+    for (long t = 0; t < NUM_STEPS - 1; t++)
+    {
+        ASSERT_EQ(0.2f * t, reader.data[t].observation.position[1]);
+    }
+
+    reader.read_file(log_file);
+    ASSERT_EQ(static_cast<size_t>(NUM_STEPS - 1), reader.data.size());
+
+    // values are converted to double for the text/columnar formats
+    ASSERT_EQ(static_cast<double>(0.1f * 3),
+              reader.data[3].observation.get_data()[0][0]);
+}
+
+//! Log entry as written with format version 2 (before Status was extended).
+struct LogEntryV2
+{
+    SimpleNJointRobotTypes<2>::LogEntry entry;
+    uint32_t action_repetitions = 0;
+    Status::ErrorStatus error_status = Status::ErrorStatus::NO_ERROR;
+    char error_message[Status::ERROR_MESSAGE_LENGTH] = "";
+
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(entry.timeindex,
+                entry.timestamp,
+                action_repetitions,
+                error_status,
+                error_message,
+                entry.observation,
+                entry.desired_action,
+                entry.applied_action);
+    }
+};
+
+// files of older format versions can still be read
+TEST_F(TestRecordLog, read_format_version_2)
+{
+    typedef SimpleNJointRobotTypes<2> Types;
+
+    std::vector<LogEntryV2> log_data(3);
+    for (long t = 0; t < 3; t++)
+    {
+        log_data[t].entry.timeindex = t;
+        log_data[t].entry.timestamp = 0.5 * t;
+        log_data[t].entry.observation.position << t, -t;
+        log_data[t].entry.desired_action =
+            Types::Action::Torque(Types::Action::Vector(t, 2 * t));
+        log_data[t].action_repetitions = t;
+    }
+    log_data[2].error_status = Status::ErrorStatus::BACKEND_ERROR;
+    std::strcpy(log_data[2].error_message, "foo");
+
+    {
+        std::ofstream outfile(log_file, std::ios::binary);
+        cereal::BinaryOutputArchive archive(outfile);
+        const std::uint32_t format_version = 2;
+        archive(format_version, log_data);
+    }
+
+    Types::BinaryLogReader reader(log_file);
+    ASSERT_EQ(3u, reader.data.size());
+    for (long t = 0; t < 3; t++)
+    {
+        const Types::LogEntry &entry = reader.data[t];
+        ASSERT_EQ(t, entry.timeindex);
+        ASSERT_EQ(0.5 * t, entry.timestamp);
+        ASSERT_EQ(-t, entry.observation.position[1]);
+        ASSERT_EQ(2 * t, entry.desired_action.torque[1]);
+        ASSERT_EQ(static_cast<uint32_t>(t), entry.status.action_repetitions);
+        // fields added later are zero
+        ASSERT_EQ(0u, entry.status.active_action_limits);
+    }
+    ASSERT_EQ(Status::ErrorStatus::BACKEND_ERROR,
+              reader.data[2].status.error_status);
+    ASSERT_EQ("foo", reader.data[2].status.get_error_message());
+}
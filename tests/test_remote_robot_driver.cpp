@@ -0,0 +1,186 @@
+/**
+ * @file
+ * @brief Tests for RemoteRobotDriver and RemoteRobotDriverServer.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <robot_interfaces/example.hpp>
+#include <robot_interfaces/remote_robot_driver.hpp>
+#include <robot_interfaces/robot_backend.hpp>
+#include <robot_interfaces/robot_data.hpp>
+#include <robot_interfaces/robot_frontend.hpp>
+
+using namespace robot_interfaces;
+
+typedef example::Action Action;
+typedef example::Observation Observation;
+typedef RemoteRobotDriver<Action, Observation> RemoteDriver;
+typedef RemoteRobotDriverServer<Action, Observation> Server;
+
+//! Driver which fails to apply actions.
+class FailingDriver : public example::Driver
+{
+public:
+    FailingDriver() : example::Driver(0, 10)
+    {
+    }
+
+    Action apply_action(const Action &) override
+    {
+        throw std::runtime_error("broken");
+    }
+};
+
+//! Driver which applies actions slowly and records the shutdown.
+class SlowDriver : public example::Driver
+{
+public:
+    std::atomic<bool> is_shut_down{false};
+
+    SlowDriver() : example::Driver(0, 10)
+    {
+    }
+
+    Action apply_action(const Action &action) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return example::Driver::apply_action(action);
+    }
+
+    void shutdown() override
+    {
+        is_shut_down = true;
+    }
+};
+
+std::string get_prefix(const std::string &name)
+{
+    return "test_remote_driver_" + name + "_" + std::to_string(getpid());
+}
+
+TEST(TestRemoteRobotDriver, forward_calls)
+{
+    const std::string prefix = get_prefix("forward");
+    auto remote = std::make_shared<RemoteDriver>(prefix, 5.0);
+    Server server(prefix, std::make_shared<example::Driver>(0, 10));
+    std::thread server_thread([&server]() { server.run(); });
+
+    remote->initialize();
+
+    Action action;
+    action.values[0] = 5;
+    action.values[1] = 20;
+    Action applied = remote->apply_action(action);
+    ASSERT_EQ(5, applied.values[0]);
+    ASSERT_EQ(10, applied.values[1]);
+
+    Observation observation = remote->get_latest_observation();
+    ASSERT_EQ(5, observation.values[0]);
+    ASSERT_EQ(10, observation.values[1]);
+    ASSERT_EQ("", remote->get_error());
+
+    remote->shutdown();
+    server_thread.join();
+    ASSERT_TRUE(server.is_shutdown());
+
+    server.record_lock_wait(0.5);
+    RemoteDriverStatistics stats = remote->get_statistics();
+    ASSERT_EQ(5u, stats.num_calls);
+    ASSERT_GE(stats.max_call_duration_s, stats.mean_call_duration_s);
+    ASSERT_EQ(1u, stats.num_lock_waits);
+    ASSERT_DOUBLE_EQ(0.5, stats.max_lock_wait_s);
+}
+
+TEST(TestRemoteRobotDriver, request_before_server_start)
+{
+    const std::string prefix = get_prefix("late_start");
+    auto remote = std::make_shared<RemoteDriver>(prefix, 5.0);
+
+    std::thread client_thread([&remote]() { remote->initialize(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    Server server(prefix, std::make_shared<example::Driver>(0, 10));
+    ASSERT_TRUE(server.process_request(5.0));
+    client_thread.join();
+}
+
+TEST(TestRemoteRobotDriver, errors)
+{
+    const std::string prefix = get_prefix("errors");
+    auto remote = std::make_shared<RemoteDriver>(prefix, 0.01);
+
+    // no server is running, so the call times out and the error is reported
+    Action action;
+    action.values[0] = 1;
+    action.values[1] = 2;
+    ASSERT_EQ(2, remote->apply_action(action).values[1]);
+    ASSERT_EQ("Remote driver did not respond in time.", remote->get_error());
+
+    // exceptions of the driver are reported as error
+    const std::string prefix2 = get_prefix("errors2");
+    auto remote2 = std::make_shared<RemoteDriver>(prefix2, 5.0);
+    Server server(prefix2, std::make_shared<FailingDriver>());
+    std::thread server_thread([&server]() { server.run(); });
+    remote2->apply_action(action);
+    ASSERT_EQ("Remote driver failed: broken", remote2->get_error());
+    remote2->shutdown();
+    server_thread.join();
+}
+
+TEST(TestRemoteRobotDriver, late_response)
+{
+    const std::string prefix = get_prefix("late_response");
+    auto remote = std::make_shared<RemoteDriver>(prefix, 0.2);
+    auto driver = std::make_shared<SlowDriver>();
+    Server server(prefix, driver);
+    std::thread server_thread([&server]() { server.run(); });
+
+    // the action times out, its late response must not be taken as the
+    // response to the shutdown request
+    Action action;
+    remote->apply_action(action);
+    ASSERT_EQ("Remote driver did not respond in time.", remote->get_error());
+    remote->shutdown();
+    ASSERT_TRUE(driver->is_shut_down);
+
+    server_thread.join();
+}
+
+TEST(TestRemoteRobotDriver, backend)
+{
+    const std::string prefix = get_prefix("backend");
+    auto remote = std::make_shared<RemoteDriver>(prefix, 5.0);
+    Server server(prefix, std::make_shared<example::Driver>(0, 100));
+    std::thread server_thread([&server]() { server.run(); });
+
+    auto data =
+        std::make_shared<SingleProcessRobotData<Action, Observation>>();
+    RobotBackend<Action, Observation> backend(remote, data, false);
+    backend.initialize();
+    RobotFrontend<Action, Observation> frontend(data);
+
+    Action action;
+    TimeIndex t = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        action.values[0] = i;
+        action.values[1] = 2 * i;
+        t = frontend.append_desired_action(action);
+    }
+    ASSERT_EQ(8, frontend.get_observation(t + 1).values[1]);
+    ASSERT_FALSE(frontend.get_status(t).has_error());
+
+    backend.request_shutdown();
+    backend.wait_until_terminated();
+    server_thread.join();
+}
@@ -5,6 +5,7 @@
  */
 #include <gtest/gtest.h>
 #include <robot_interfaces/example.hpp>
+#include <robot_interfaces/lockstep_robot_frontend.hpp>
 #include <robot_interfaces/robot_backend.hpp>
 #include <robot_interfaces/robot_frontend.hpp>
 
@@ -22,6 +23,8 @@ protected:
     typedef robot_interfaces::RobotBackend<Action, Observation> Backend;
     typedef robot_interfaces::SingleProcessRobotData<Action, Observation> Data;
     typedef robot_interfaces::RobotFrontend<Action, Observation> Frontend;
+    typedef robot_interfaces::LockstepRobotFrontend<Action, Observation>
+        LockstepFrontend;
 
     std::shared_ptr<example::Driver> driver;
     std::shared_ptr<Data> data;
@@ -67,3 +70,102 @@ TEST_F(TestRobotBackend, max_number_of_actions)
     ASSERT_EQ(Status::ErrorStatus::BACKEND_ERROR, status.error_status);
     ASSERT_EQ("Maximum number of actions reached.", status.get_error_message());
 }
+
+// After a first action timeout, there is a status for time step 0 but no
+// observation.
+TEST_F(TestRobotBackend, first_action_timeout)
+{
+    constexpr bool real_time_mode = true;
+    constexpr double first_action_timeout = 0.05;
+
+    Backend backend(driver, data, real_time_mode, first_action_timeout);
+    backend.initialize();
+    Frontend frontend(data);
+
+    Status status = frontend.get_status(0);
+    ASSERT_TRUE(status.has_error());
+    ASSERT_EQ(Status::ErrorStatus::BACKEND_ERROR, status.error_status);
+    ASSERT_EQ("First action was not provided in time",
+              status.get_error_message());
+    ASSERT_EQ(Backend::TerminationReason::FIRST_ACTION_TIMEOUT,
+              backend.wait_until_terminated());
+    ASSERT_EQ(0u, data->observation->length());
+}
+
+// In lockstep mode, the backend step is executed directly when appending the
+// action, without a background thread.
+TEST_F(TestRobotBackend, lockstep)
+{
+    constexpr uint32_t max_number_of_actions = 10;
+
+    auto backend = std::make_shared<Backend>(
+        driver, data, Backend::LockstepMode(), max_number_of_actions);
+    backend->initialize();
+    LockstepFrontend frontend(data, backend);
+
+    ASSERT_TRUE(backend->is_lockstep());
+    ASSERT_EQ(0u, data->observation->length());
+
+    Action action;
+    Observation observation;
+    robot_interfaces::TimeIndex t;
+    for (uint32_t i = 0; i < max_number_of_actions; i++)
+    {
+        action.values[0] = i;
+        action.values[1] = 2 * i;
+        t = frontend.append_desired_action(action);
+        ASSERT_EQ(static_cast<robot_interfaces::TimeIndex>(i), t);
+
+        frontend.get_observation(t + 1, observation);
+        ASSERT_EQ(static_cast<int>(2 * i), observation.values[1]);
+
+        // action is applied and the next observation is there without
+        // waiting
+        ASSERT_EQ(t, data->applied_action->newest_timeindex(false));
+        ASSERT_EQ(t + 1, frontend.get_current_timeindex());
+        ASSERT_EQ(static_cast<int>(i),
+                  frontend.get_applied_action(t).values[0]);
+        ASSERT_EQ(static_cast<int>(2 * i),
+                  frontend.get_observation(t + 1).values[1]);
+        ASSERT_FALSE(frontend.get_status(t).has_error());
+    }
+
+    // the status of the step after the last action reports the termination
+    auto status = frontend.get_status(t + 1);
+    ASSERT_TRUE(status.has_error());
+    ASSERT_EQ("Maximum number of actions reached.", status.get_error_message());
+    ASSERT_FALSE(backend->is_running());
+    ASSERT_EQ(Backend::TerminationReason::MAXIMUM_NUMBER_OF_ACTIONS_REACHED,
+              backend->wait_until_terminated());
+    ASSERT_THROW(frontend.append_desired_action(action), std::runtime_error);
+}
+
+// the backend is stepped also when appending via the base class
+TEST_F(TestRobotBackend, lockstep_via_base_class)
+{
+    auto backend =
+        std::make_shared<Backend>(driver, data, Backend::LockstepMode());
+    backend->initialize();
+    LockstepFrontend lockstep_frontend(data, backend);
+    Frontend &frontend = lockstep_frontend;
+
+    Action action;
+    action.values[0] = 1;
+    action.values[1] = 2;
+    robot_interfaces::TimeIndex t = frontend.append_desired_action(action);
+    ASSERT_EQ(t + 1, frontend.get_current_timeindex());
+    ASSERT_EQ(2, frontend.get_observation(t + 1).values[1]);
+
+    t = frontend.append_desired_trajectory({action, action, action});
+    ASSERT_EQ(3, t);
+    ASSERT_EQ(t, data->applied_action->newest_timeindex(false));
+}
+
+// a threaded backend cannot be stepped manually
+TEST_F(TestRobotBackend, lockstep_requires_lockstep_backend)
+{
+    auto backend = std::make_shared<Backend>(driver, data, false);
+    ASSERT_FALSE(backend->is_lockstep());
+    ASSERT_THROW(backend->step(), std::runtime_error);
+    ASSERT_THROW(LockstepFrontend(data, backend), std::invalid_argument);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @brief Tests for history lengths and memory footprint of the RobotData.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <robot_interfaces/batch_n_joint_robot_types.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<2> Types;
+
+TEST(TestRobotData, single_history_length)
+{
+    Types::SingleProcessData data(20);
+
+    HistoryLengths lengths = data.get_history_lengths();
+    ASSERT_EQ(20u, lengths.desired_action);
+    ASSERT_EQ(20u, lengths.applied_action);
+    ASSERT_EQ(20u, lengths.observation);
+    ASSERT_EQ(20u, lengths.status);
+    ASSERT_EQ(20u, lengths.trajectory);
+}
+
+TEST(TestRobotData, per_channel_history_lengths)
+{
+    HistoryLengths lengths(100);
+    lengths.status = 10;
+    lengths.trajectory = 5;
+    Types::SingleProcessData data(lengths);
+
+    ASSERT_EQ(100u, data.observation->max_length());
+    ASSERT_EQ(10u, data.status->max_length());
+    ASSERT_EQ(5u, data.trajectory->max_length());
+
+    lengths.status = 0;
+    ASSERT_THROW(Types::SingleProcessData data_invalid(lengths),
+                 std::invalid_argument);
+}
+
+TEST(TestRobotData, memory_footprint)
+{
+    HistoryLengths lengths(100);
+    lengths.status = 10;
+    Types::SingleProcessData data(lengths);
+
+    MemoryFootprint footprint = data.memory_footprint();
+    ASSERT_EQ(100 * (sizeof(Types::Observation) + sizeof(double)),
+              footprint.observation);
+    ASSERT_EQ(10 * (sizeof(Status) + sizeof(double)), footprint.status);
+    ASSERT_EQ(footprint.desired_action + footprint.applied_action +
+                  footprint.observation + footprint.status +
+                  footprint.trajectory,
+              footprint.total());
+
+    // shorter history needs less memory
+    ASSERT_LT(footprint.total(),
+              Types::BaseData::estimate_memory_footprint(100).total());
+}
+
+TEST(TestRobotData, memory_footprint_dynamic_size)
+{
+    typedef BatchNJointRobotTypes<2> BatchTypes;
+    constexpr size_t NUM_ROBOTS = 100;
+
+    // the matrices of the batch types are allocated on the heap, so the
+    // example elements determine the footprint
+    MemoryFootprint footprint =
+        BatchTypes::BaseData::estimate_memory_footprint(
+            10,
+            BatchTypes::Action(NUM_ROBOTS),
+            BatchTypes::Observation(NUM_ROBOTS));
+    ASSERT_EQ(10 * (sizeof(BatchTypes::Observation) +
+                    3 * NUM_ROBOTS * 2 * sizeof(double) + sizeof(double)),
+              footprint.observation);
+    ASSERT_EQ(10 * (sizeof(BatchTypes::Action) +
+                    4 * NUM_ROBOTS * 2 * sizeof(double) + sizeof(double)),
+              footprint.desired_action);
+
+    // the newest elements of the data are used
+    BatchTypes::SingleProcessData data(10);
+    data.desired_action->append(BatchTypes::Action(NUM_ROBOTS));
+    data.observation->append(BatchTypes::Observation(NUM_ROBOTS));
+    ASSERT_EQ(footprint.total(), data.memory_footprint().total());
+}
+
+TEST(TestRobotData, compute_logging_history_length)
+{
+    // 1 kHz, block of 100 steps, logger lags up to 0.5 s
+    ASSERT_EQ(601u,
+              HistoryLengths::compute_logging_history_length(1000, 100, 0.5));
+    ASSERT_EQ(101u,
+              HistoryLengths::compute_logging_history_length(1000, 100, 0));
+    ASSERT_THROW(HistoryLengths::compute_logging_history_length(0, 100, 0.5),
+                 std::invalid_argument);
+}
@@ -0,0 +1,193 @@
+/**
+ * @file
+ * @brief Tests for the snapshots of the RobotLogger.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#include <robot_interfaces/columnar_log.hpp>
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/robot_logger.hpp>
+
+#include "dummy_robot_data.hpp"
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<2> Types;
+
+//! Test fixture to create and delete temporary log files
+class TestRobotLoggerSnapshot : public ::testing::Test
+{
+protected:
+    std::string log_file;
+    std::string snapshot_file;
+
+    void SetUp() override
+    {
+        boost::filesystem::path temp =
+            boost::filesystem::temp_directory_path();
+        log_file = (temp / boost::filesystem::unique_path()).native();
+        snapshot_file = (temp / boost::filesystem::unique_path()).native();
+    }
+
+    void TearDown() override
+    {
+        // clean up
+        std::remove(log_file.c_str());
+        std::remove(snapshot_file.c_str());
+    }
+};
+
+// snapshot of the latest steps while the background logger is running
+TEST_F(TestRobotLoggerSnapshot, binary_while_logging)
+{
+    constexpr long NUM_STEPS = 120;
+    constexpr long BUFFER_SIZE = 50;
+
+    auto data = std::make_shared<Types::SingleProcessData>(BUFFER_SIZE);
+    Types::Logger logger(data, 10);
+    logger.allocate_snapshot(100);
+    logger.start(log_file, Types::Logger::Format::TEXT);
+
+    for (long t = 0; t < NUM_STEPS; t++)
+    {
+        robot_interfaces::testing::append_dummy_step(*data, t);
+    }
+
+    ASSERT_EQ(20u, logger.write_snapshot(snapshot_file, 20));
+    logger.wait_for_snapshot();
+    {
+        Types::BinaryLogReader reader(snapshot_file);
+        ASSERT_EQ(20u, reader.data.size());
+        // the newest time step is not included
+        for (size_t i = 0; i < reader.data.size(); i++)
+        {
+            const long t = NUM_STEPS - 21 + i;
+            ASSERT_EQ(t, reader.data[i].timeindex);
+            ASSERT_EQ(0.2 * t, reader.data[i].observation.position[1]);
+            ASSERT_EQ(-t, reader.data[i].desired_action.torque[1]);
+        }
+    }
+
+    // more steps than in the buffer: limited to the steps in the buffer,
+    // minus the safety margin as the buffer is full
+    ASSERT_EQ(static_cast<size_t>(BUFFER_SIZE - 1 - 10),
+              logger.write_snapshot(snapshot_file, 1000));
+    logger.wait_for_snapshot();
+    {
+        Types::BinaryLogReader reader(snapshot_file);
+        ASSERT_EQ(NUM_STEPS - BUFFER_SIZE + 10, reader.data.front().timeindex);
+        ASSERT_EQ(NUM_STEPS - 2, reader.data.back().timeindex);
+    }
+
+    logger.set_snapshot_margin(0);
+    ASSERT_EQ(static_cast<size_t>(BUFFER_SIZE - 1),
+              logger.write_snapshot(snapshot_file, 1000));
+    logger.wait_for_snapshot();
+    {
+        Types::BinaryLogReader reader(snapshot_file);
+        ASSERT_EQ(static_cast<size_t>(BUFFER_SIZE - 1), reader.data.size());
+        ASSERT_EQ(NUM_STEPS - BUFFER_SIZE, reader.data.front().timeindex);
+        ASSERT_EQ(NUM_STEPS - 2, reader.data.back().timeindex);
+    }
+
+    logger.stop();
+}
+
+TEST_F(TestRobotLoggerSnapshot, columnar)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    Types::Logger logger(data);
+
+    // nothing to write if the buffer is empty
+    ASSERT_EQ(0u,
+              logger.write_snapshot(snapshot_file,
+                                    10,
+                                    Types::Logger::Format::COLUMNAR));
+
+    for (long t = 0; t < 30; t++)
+    {
+        robot_interfaces::testing::append_dummy_step(*data, t);
+    }
+    ASSERT_EQ(10u,
+              logger.write_snapshot(snapshot_file,
+                                    10,
+                                    Types::Logger::Format::COLUMNAR));
+    logger.wait_for_snapshot();
+
+    ColumnarLogReader reader(snapshot_file);
+    std::vector<ColumnData> columns =
+        reader.read_columns({"timeindex", "observation_position"});
+    ASSERT_EQ(10u, columns[0].num_rows());
+    for (long i = 0; i < 10; i++)
+    {
+        ASSERT_EQ(19 + i, columns[0].values[i]);
+        ASSERT_EQ(0.1 * (19 + i), columns[1].values[i * 2]);
+    }
+}
+
+// the entries of a snapshot are consistent while steps are appended
+TEST_F(TestRobotLoggerSnapshot, concurrent_append)
+{
+    auto data = std::make_shared<Types::SingleProcessData>(100);
+    Types::Logger logger(data);
+    logger.allocate_snapshot(100);
+
+    robot_interfaces::testing::append_dummy_step(*data, 0);
+    std::atomic<bool> is_running(true);
+    std::thread producer([&]() {
+        for (long t = 1; is_running; t++)
+        {
+            robot_interfaces::testing::append_dummy_step(*data, t);
+        }
+    });
+
+    while (data->observation->newest_timeindex() < 200)
+    {
+        std::this_thread::yield();
+    }
+
+    std::vector<std::vector<Types::LogEntry>> snapshots;
+    for (int i = 0; i < 20; i++)
+    {
+        logger.write_snapshot(snapshot_file, 100);
+        logger.wait_for_snapshot();
+        snapshots.push_back(Types::BinaryLogReader(snapshot_file).data);
+    }
+
+    is_running = false;
+    producer.join();
+
+    for (const auto &snapshot : snapshots)
+    {
+        ASSERT_FALSE(snapshot.empty());
+        for (size_t i = 0; i < snapshot.size(); i++)
+        {
+            const Types::LogEntry &entry = snapshot[i];
+            ASSERT_EQ(snapshot.front().timeindex + static_cast<long>(i),
+                      entry.timeindex);
+            ASSERT_EQ(0.1 * entry.timeindex, entry.observation.position[0]);
+            ASSERT_EQ(entry.timeindex, entry.applied_action.torque[0]);
+        }
+    }
+}
+
+TEST_F(TestRobotLoggerSnapshot, write_error)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    Types::Logger logger(data);
+    for (long t = 0; t < 5; t++)
+    {
+        robot_interfaces::testing::append_dummy_step(*data, t);
+    }
+
+    logger.write_snapshot("/nonexistent/directory/log", 10);
+    ASSERT_THROW(logger.wait_for_snapshot(), std::runtime_error);
+    // the error is only reported once
+    ASSERT_NO_THROW(logger.wait_for_snapshot());
+}
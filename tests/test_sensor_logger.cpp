@@ -121,3 +121,117 @@ TEST_F(TestSensorLogger, buffer_limit)
         }
     }
 }
+
+TEST_F(TestSensorLogger, segmented)
+{
+    constexpr int NUM_OBSERVATIONS = 35;
+    constexpr int BUFFER_LIMIT = 10;
+
+    const std::string manifest_path = LogManifest::get_manifest_path(log_file);
+
+    // write the log
+    {
+        auto data = std::make_shared<SingleProcessSensorData<int>>();
+        auto driver =
+            std::make_shared<robot_interfaces::testing::DummySensorDriver>();
+        auto frontend = SensorFrontend<int>(data);
+
+        auto logger = SensorLogger<int>(data, BUFFER_LIMIT);
+        logger.start_segmented(log_file);
+
+        // create backend last to ensure no message is missed
+        auto backend = SensorBackend<int>(driver, data);
+
+        for (int t = 0; t < NUM_OBSERVATIONS; t++)
+        {
+            int obs = frontend.get_observation(t);
+            ASSERT_EQ(obs, t);
+        }
+        logger.stop();
+    }
+
+    LogManifest manifest = LogManifest::read(manifest_path);
+
+    // read the log
+    {
+        auto log = SensorLogReader<int>(manifest_path);
+
+        // unlike in non-segmented mode, the buffer limit does not stop the
+        // logger
+        ASSERT_GE(log.data.size(), static_cast<std::size_t>(NUM_OBSERVATIONS));
+        ASSERT_GE(manifest.segments.size(), 4u);
+
+        // reading again replaces the data
+        const std::size_t num_entries = log.data.size();
+        log.read_file(manifest_path);
+        ASSERT_EQ(num_entries, log.data.size());
+        ASSERT_EQ(num_entries, log.timestamps.size());
+        for (std::size_t t = 0; t < log.data.size(); t++)
+        {
+            ASSERT_EQ(log.data[t], static_cast<int>(t));
+        }
+    }
+
+    for (const std::string &path : manifest.get_segment_paths(manifest_path))
+    {
+        std::remove(path.c_str());
+    }
+    std::remove(manifest_path.c_str());
+}
+
+TEST_F(TestSensorLogger, segmented_duration)
+{
+    constexpr int NUM_OBSERVATIONS = 35;
+    constexpr int BUFFER_LIMIT = 1000;
+
+    const std::string manifest_path = LogManifest::get_manifest_path(log_file);
+    const std::string single_file = log_file + "_single";
+    size_t num_segments = 0;
+
+    {
+        auto data = std::make_shared<SingleProcessSensorData<int>>();
+        auto driver =
+            std::make_shared<robot_interfaces::testing::DummySensorDriver>();
+        auto frontend = SensorFrontend<int>(data);
+
+        // the dummy driver provides one observation every 10 ms
+        auto logger = SensorLogger<int>(data, BUFFER_LIMIT);
+        logger.start_segmented(log_file, 0.05);
+        ASSERT_THROW(logger.stop_and_save(single_file), std::runtime_error);
+
+        auto backend = SensorBackend<int>(driver, data);
+
+        for (int t = 0; t < NUM_OBSERVATIONS; t++)
+        {
+            frontend.get_observation(t);
+        }
+        logger.stop();
+        num_segments = LogManifest::read(manifest_path).segments.size();
+
+        // a normal recording afterwards does not add segments
+        logger.reset();
+        logger.start();
+        frontend.get_observation(NUM_OBSERVATIONS + 5);
+        logger.stop_and_save(single_file);
+    }
+
+    LogManifest manifest = LogManifest::read(manifest_path);
+    // the buffer limit is not reached, so segments are only split by time
+    ASSERT_GE(manifest.segments.size(), 4u);
+
+    auto log = SensorLogReader<int>(manifest_path);
+    ASSERT_GE(log.data.size(), static_cast<std::size_t>(NUM_OBSERVATIONS));
+    for (std::size_t t = 0; t < log.data.size(); t++)
+    {
+        ASSERT_EQ(log.data[t], static_cast<int>(t));
+    }
+    ASSERT_EQ(num_segments, manifest.segments.size());
+    ASSERT_FALSE(SensorLogReader<int>(single_file).data.empty());
+
+    for (const std::string &path : manifest.get_segment_paths(manifest_path))
+    {
+        std::remove(path.c_str());
+    }
+    std::remove(manifest_path.c_str());
+    std::remove(single_file.c_str());
+}
@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @brief Tests for prefaulting/locking of shared memory.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <unistd.h>
+
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/shared_memory_residency.hpp>
+#include <robot_interfaces/shared_memory_segment.hpp>
+
+using namespace robot_interfaces;
+
+struct Block
+{
+    char data[3 * 4096];
+};
+
+TEST(TestSharedMemoryResidency, find_mappings)
+{
+    const std::string id = "test_residency_" + std::to_string(getpid());
+
+    SharedMemorySegment<Block> segment(id, true);
+    SharedMemorySegment<Block> segment_a(id + "_a", true);
+    SharedMemorySegment<Block> other(id + "a", true);
+
+    auto mappings = find_shared_memory_mappings({id});
+    ASSERT_EQ(2u, mappings.size());
+    for (const SharedMemoryMapping &mapping : mappings)
+    {
+        ASSERT_TRUE(mapping.shared_memory_id == id ||
+                    mapping.shared_memory_id == id + "_a");
+        ASSERT_GE(mapping.size(), sizeof(Block));
+        ASSERT_TRUE(mapping.is_writable);
+    }
+
+    ASSERT_EQ(1u, find_shared_memory_mappings({id + "_a"}).size());
+    ASSERT_EQ(0u, find_shared_memory_mappings({id + "_b"}).size());
+    ASSERT_EQ(3u, find_shared_memory_mappings({id, id + "a"}).size());
+}
+
+TEST(TestSharedMemoryResidency, make_resident)
+{
+    const std::string id = "test_residency_" + std::to_string(getpid());
+
+    SharedMemorySegment<Block> segment(id, true);
+
+    // not touched yet
+    MemoryResidency residency = get_shared_memory_residency({id});
+    ASSERT_EQ(1u, residency.num_mappings);
+    ASSERT_LT(residency.resident_bytes, residency.mapped_bytes);
+
+    MemoryResidencyOptions options;
+    ASSERT_EQ(residency.mapped_bytes,
+              make_shared_memory_resident({id}, options));
+
+    residency = get_shared_memory_residency({id});
+    ASSERT_EQ(residency.mapped_bytes, residency.resident_bytes);
+}
+
+TEST(TestSharedMemoryResidency, robot_data)
+{
+    typedef SimpleNJointRobotTypes<1> Types;
+    const std::string prefix =
+        "test_residency_robot_data_" + std::to_string(getpid());
+
+    Types::MultiProcessData data(prefix, true, 10);
+    data.make_memory_resident();
+
+    MemoryResidency residency = data.get_memory_residency();
+    ASSERT_GT(residency.num_mappings, 0u);
+    ASSERT_EQ(residency.mapped_bytes, residency.resident_bytes);
+
+    Types::MultiProcessData::clear_attach_state(prefix);
+}
+
+// data whose prefix starts with the prefix of other data is not matched
+TEST(TestSharedMemoryResidency, robot_data_longer_prefix)
+{
+    typedef SimpleNJointRobotTypes<1> Types;
+    const std::string prefix =
+        "test_residency_robot_" + std::to_string(getpid());
+
+    Types::MultiProcessData data(prefix, true, 10);
+    Types::MultiProcessData other(prefix + "_two", true, 10);
+
+    auto mappings = find_shared_memory_mappings(data.get_shared_memory_ids());
+    ASSERT_FALSE(mappings.empty());
+    for (const SharedMemoryMapping &mapping : mappings)
+    {
+        ASSERT_EQ(0u, mapping.shared_memory_id.find(prefix + "_"));
+        ASSERT_EQ(std::string::npos,
+                  mapping.shared_memory_id.find(prefix + "_two"));
+    }
+    ASSERT_EQ(data.get_memory_residency().num_mappings, mappings.size());
+
+    Types::MultiProcessData::clear_attach_state(prefix);
+    Types::MultiProcessData::clear_attach_state(prefix + "_two");
+}
@@ -0,0 +1,121 @@
+/**
+ * @file
+ * @brief Tests for the StatusWord.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <string>
+
+#include <unistd.h>
+
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/status_word.hpp>
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<1> Types;
+
+//! Driver which returns the action it gets.
+class PassThroughDriver : public RobotDriver<Types::Action, Types::Observation>
+{
+public:
+    void initialize() override
+    {
+    }
+
+    Types::Action apply_action(const Types::Action &desired_action) override
+    {
+        return desired_action;
+    }
+
+    Types::Observation get_latest_observation() override
+    {
+        return Types::Observation();
+    }
+
+    std::string get_error() override
+    {
+        return "";
+    }
+
+    void shutdown() override
+    {
+    }
+};
+
+TEST(TestStatusWord, publish_and_load)
+{
+    StatusWord word;
+    ASSERT_FALSE(word.load().is_valid);
+
+    Status status;
+    status.action_repetitions = 42;
+    status.active_action_limits = Status::ActionLimit::TORQUE_LIMIT |
+                                  Status::ActionLimit::DEFAULT_GAINS;
+    word.publish(status);
+
+    StatusWord::Value value = word.load();
+    ASSERT_TRUE(value.is_valid);
+    ASSERT_FALSE(value.has_error());
+    ASSERT_EQ(42u, value.action_repetitions);
+    ASSERT_EQ(status.active_action_limits, value.active_action_limits);
+
+    status.action_repetitions = std::numeric_limits<uint32_t>::max();
+    status.set_error(Status::ErrorStatus::DRIVER_ERROR, "foo");
+    word.publish(status);
+
+    value = word.load();
+    ASSERT_TRUE(value.has_error());
+    ASSERT_EQ(Status::ErrorStatus::DRIVER_ERROR, value.error_status);
+    ASSERT_EQ(std::numeric_limits<uint32_t>::max(), value.action_repetitions);
+}
+
+TEST(TestStatusWord, shared_memory)
+{
+    const std::string id = "test_status_word_" + std::to_string(getpid());
+
+    auto leader = StatusWord::create_leader(id);
+    auto follower = StatusWord::create_follower(id);
+
+    Status status;
+    status.set_error(Status::ErrorStatus::BACKEND_ERROR, "foo");
+    leader->publish(status);
+    ASSERT_EQ(Status::ErrorStatus::BACKEND_ERROR,
+              follower->load().error_status);
+}
+
+TEST(TestStatusWord, frontend)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    auto backend = std::make_shared<Types::Backend>(
+        std::make_shared<PassThroughDriver>(),
+        data,
+        Types::Backend::LockstepMode());
+    backend->initialize();
+    Types::LockstepFrontend frontend(data, backend);
+
+    TimeIndex t = frontend.append_desired_action(Types::Action::Zero());
+    StatusWord::Value value = frontend.peek_status();
+    ASSERT_TRUE(value.is_valid);
+    ASSERT_FALSE(value.has_error());
+    ASSERT_EQ(frontend.get_status(t + 1).action_repetitions,
+              value.action_repetitions);
+
+    // the frontend refuses actions once the word reports an error and takes
+    // the message from the status time series
+    Status status = frontend.get_status(t + 1);
+    status.set_error(Status::ErrorStatus::BACKEND_ERROR, "test error");
+    data->status->append(status);
+    data->status_word->publish(status);
+    try
+    {
+        frontend.append_desired_action(Types::Action::Zero());
+        FAIL() << "no exception thrown";
+    }
+    catch (const std::runtime_error &e)
+    {
+        ASSERT_EQ(std::string("Backend Error: test error"), e.what());
+    }
+}
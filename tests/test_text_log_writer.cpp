@@ -0,0 +1,132 @@
+/**
+ * @file
+ * @brief Tests for the text log writer.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/robot_logger.hpp>
+#include <robot_interfaces/text_log_writer.hpp>
+
+#include "dummy_robot_data.hpp"
+
+using namespace robot_interfaces;
+
+//! Test fixture to create and delete a temporary log file
+class TestTextLogWriter : public ::testing::Test
+{
+protected:
+    std::string log_file;
+
+    void SetUp() override
+    {
+        boost::filesystem::path temp =
+            boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path();
+        log_file = temp.native();
+    }
+
+    void TearDown() override
+    {
+        // clean up
+        std::remove(log_file.c_str());
+    }
+};
+
+// values have to be read back exactly
+TEST_F(TestTextLogWriter, round_trip)
+{
+    const std::vector<double> values = {0.1,
+                                        -1.0 / 3.0,
+                                        1e-300,
+                                        123456789.123456789,
+                                        0.0,
+                                        -2.5e17,
+                                        std::nextafter(1.0, 2.0)};
+
+    {
+        // use a tiny buffer, so it is written several times
+        TextLogWriter writer(log_file, false, 16);
+        writer.write(std::string("name"));
+        writer.write(42);
+        writer.write(-7l);
+        writer.end_line();
+        for (int i = 0; i < 100; i++)
+        {
+            writer.write(values);
+            writer.end_line();
+        }
+    }
+
+    std::ifstream file(log_file);
+    std::string name;
+    long a, b;
+    file >> name >> a >> b;
+    ASSERT_EQ("name", name);
+    ASSERT_EQ(42, a);
+    ASSERT_EQ(-7, b);
+
+    for (int i = 0; i < 100; i++)
+    {
+        for (double expected : values)
+        {
+            double value;
+            ASSERT_TRUE(file >> value);
+            ASSERT_EQ(expected, value);
+        }
+    }
+    double value;
+    ASSERT_FALSE(file >> value);
+}
+
+// log robot data with the RobotLogger and parse the text file
+TEST_F(TestTextLogWriter, robot_logger)
+{
+    typedef SimpleNJointRobotTypes<2> Types;
+    constexpr long NUM_STEPS = 50;
+
+    auto data = std::make_shared<Types::SingleProcessData>();
+    for (long t = 0; t < NUM_STEPS; t++)
+    {
+        robot_interfaces::testing::append_dummy_step(*data, t);
+    }
+
+    Types::Logger logger(data);
+    logger.write_current_buffer(log_file);
+
+    std::ifstream file(log_file);
+    std::string line;
+    std::getline(file, line);
+    std::istringstream header(line);
+    std::vector<std::string> names(std::istream_iterator<std::string>(header),
+                                   {});
+    ASSERT_EQ("#time_index", names[0]);
+
+    auto position = std::find(
+        names.begin(), names.end(), "observation_position_1");
+    ASSERT_NE(names.end(), position);
+    const size_t position_column = position - names.begin();
+
+    long num_lines = 0;
+    while (std::getline(file, line))
+    {
+        std::istringstream row(line);
+        std::vector<std::string> row_values(
+            std::istream_iterator<std::string>(row), {});
+        ASSERT_EQ(names.size(), row_values.size());
+        ASSERT_EQ(num_lines, std::stol(row_values[0]));
+        ASSERT_EQ(0.2 * num_lines, std::stod(row_values[position_column]));
+        num_lines++;
+    }
+    // the newest time step is not logged
+    ASSERT_EQ(NUM_STEPS - 1, num_lines);
+}
@@ -0,0 +1,203 @@
+/**
+ * @file
+ * @brief Tests for the WriterArbiter and its use in the RobotFrontend.
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <robot_interfaces/n_joint_robot_types.hpp>
+#include <robot_interfaces/writer_arbiter.hpp>
+
+using namespace robot_interfaces;
+
+typedef SimpleNJointRobotTypes<1> Types;
+
+TEST(TestWriterArbiter, acquire_and_release)
+{
+    WriterArbiter arbiter;
+    ASSERT_EQ(0u, arbiter.get_holder());
+
+    WriterArbiter::Token token = arbiter.acquire(1, 10.0);
+    ASSERT_NE(0u, token);
+    ASSERT_TRUE(arbiter.is_holder(token));
+
+    // same priority does not preempt
+    ASSERT_EQ(0u, arbiter.acquire(1, 10.0));
+    ASSERT_TRUE(arbiter.renew(token, 10.0));
+
+    arbiter.release(token);
+    ASSERT_FALSE(arbiter.is_holder(token));
+    ASSERT_FALSE(arbiter.renew(token, 10.0));
+
+    WriterArbiter::Token token2 = arbiter.acquire(0, 10.0);
+    ASSERT_NE(0u, token2);
+    ASSERT_NE(token, token2);
+
+    ASSERT_THROW(arbiter.acquire(5, 0.0), std::invalid_argument);
+}
+
+TEST(TestWriterArbiter, preemption)
+{
+    WriterArbiter arbiter;
+
+    WriterArbiter::Token low = arbiter.acquire(1, 10.0);
+    WriterArbiter::Token high = arbiter.acquire(2, 10.0);
+    ASSERT_NE(0u, high);
+    ASSERT_TRUE(arbiter.is_holder(high));
+    ASSERT_FALSE(arbiter.renew(low, 10.0));
+    ASSERT_EQ(1u, arbiter.get_number_of_preemptions());
+
+    // releasing with the old token does not affect the new holder
+    arbiter.release(low);
+    ASSERT_TRUE(arbiter.is_holder(high));
+}
+
+TEST(TestWriterArbiter, expiry)
+{
+    WriterArbiter arbiter;
+
+    WriterArbiter::Token token = arbiter.acquire(10, 0.01);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(0u, arbiter.get_holder());
+    ASSERT_FALSE(arbiter.renew(token, 10.0));
+
+    // an expired lease can be taken over with any priority
+    ASSERT_NE(0u, arbiter.acquire(0, 10.0));
+    ASSERT_EQ(0u, arbiter.get_number_of_preemptions());
+}
+
+TEST(TestWriterArbiter, shared_memory)
+{
+    const std::string id = "test_writer_arbiter_" + std::to_string(getpid());
+
+    auto leader = WriterArbiter::create_leader(id);
+    auto follower = WriterArbiter::create_follower(id);
+
+    WriterArbiter::Token token = leader->acquire(1, 10.0);
+    ASSERT_TRUE(follower->is_holder(token));
+    ASSERT_EQ(0u, follower->acquire(1, 10.0));
+
+    leader.reset();
+    ASSERT_THROW(WriterArbiter::create_follower(id), std::runtime_error);
+}
+
+TEST(TestWriterArbiter, frontends)
+{
+    auto data = std::make_shared<Types::SingleProcessData>();
+    Types::Frontend controller(data);
+    Types::Frontend safety(data);
+    Types::ReadOnlyFrontend monitor(data);
+
+    // without any lease, appending is possible
+    controller.append_desired_action(Types::Action::Zero());
+
+    ASSERT_TRUE(controller.acquire_writer_lease(1));
+    ASSERT_TRUE(controller.has_writer_lease());
+    controller.append_desired_action(Types::Action::Zero());
+    ASSERT_THROW(safety.append_desired_action(Types::Action::Zero()),
+                 std::runtime_error);
+    ASSERT_FALSE(safety.acquire_writer_lease(1));
+
+    ASSERT_TRUE(safety.acquire_writer_lease(2));
+    safety.append_desired_action(Types::Action::Zero());
+    ASSERT_FALSE(controller.has_writer_lease());
+    ASSERT_THROW(controller.append_desired_action(Types::Action::Zero()),
+                 std::runtime_error);
+
+    // readers are not affected by the lease
+    ASSERT_EQ(2, data->desired_action->newest_timeindex());
+    ASSERT_NO_THROW(monitor.get_desired_action(2));
+
+    // while a lease is held, appending without lease is not possible
+    Types::Frontend plain(data);
+    ASSERT_THROW(plain.append_desired_action(Types::Action::Zero()),
+                 std::runtime_error);
+
+    // once the lease is released, frontends without lease can append again
+    safety.release_writer_lease();
+    plain.append_desired_action(Types::Action::Zero());
+}
+
+TEST(TestWriterArbiter, write)
+{
+    WriterArbiter arbiter;
+    int num_writes = 0;
+    auto write = [&num_writes]() { num_writes++; };
+
+    // without lease as long as no lease was acquired
+    ASSERT_EQ(WriterArbiter::WriteAccess::GRANTED, arbiter.write(0, 0, write));
+
+    WriterArbiter::Token token = arbiter.acquire(1, 10.0);
+    ASSERT_EQ(WriterArbiter::WriteAccess::GRANTED,
+              arbiter.write(token, 10.0, write));
+    ASSERT_EQ(WriterArbiter::WriteAccess::LEASE_REQUIRED,
+              arbiter.write(0, 0, write));
+
+    arbiter.acquire(2, 10.0);
+    ASSERT_EQ(WriterArbiter::WriteAccess::LEASE_LOST,
+              arbiter.write(token, 10.0, write));
+    ASSERT_EQ(2, num_writes);
+
+    // expired leases do not block writers without lease
+    arbiter.acquire(3, 1e-6);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(WriterArbiter::WriteAccess::GRANTED, arbiter.write(0, 0, write));
+}
+
+// a process dying while holding the lock does not block the others
+TEST(TestWriterArbiter, owner_dies_while_locked)
+{
+    const std::string id = "test_writer_arbiter_" + std::to_string(getpid());
+    auto arbiter = WriterArbiter::create_leader(id);
+
+    pid_t pid = fork();
+    ASSERT_NE(-1, pid);
+    if (pid == 0)
+    {
+        auto follower = WriterArbiter::create_follower(id);
+        follower->write(0, 0, []() { _exit(0); });
+        _exit(1);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    ASSERT_NE(0u, arbiter->acquire(1, 10.0));
+}
+
+// the lease of a process that died ends, even if it has no expiry
+TEST(TestWriterArbiter, holder_dies)
+{
+    const std::string id =
+        "test_writer_arbiter_dies_" + std::to_string(getpid());
+    auto arbiter = WriterArbiter::create_leader(id);
+
+    pid_t pid = fork();
+    ASSERT_NE(-1, pid);
+    if (pid == 0)
+    {
+        auto follower = WriterArbiter::create_follower(id);
+        _exit(follower->acquire(1, std::numeric_limits<double>::infinity()) !=
+                      0
+                  ? 0
+                  : 1);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    ASSERT_EQ(0u, arbiter->get_holder());
+    ASSERT_EQ(WriterArbiter::WriteAccess::GRANTED,
+              arbiter->write(0, 0, []() {}));
+    ASSERT_NE(0u, arbiter->acquire(1, 10.0));
+}